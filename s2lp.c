@@ -6,6 +6,7 @@
  */
 
 #include "s2lp.h"
+#include "s2lp_rf_calc.h"
 #include "bit_helpers.h"
 #include <string.h>
 
@@ -13,6 +14,7 @@ void S2LP_Initialize(S2LP_Handle* handle, S2LP_ClockFrequency frequency) {
 	S2LP_InitHandle(handle);
 
 	handle->frequency = frequency;
+	S2LP_RFCalc_InitContext(&(handle->rf_context), frequency, S2LP_SYNTH_BAND_HIGH, false);
 
 	S2LP_Reset(handle);
 
@@ -55,7 +57,7 @@ uint32_t S2LP_GetInterruptsEx(S2LP_Handle* handle, bool clearFlags) {
 	SETBITS(irqs, reg_vals[2], 0xFF, 8);
 	SETBITS(irqs, reg_vals[3], 0xFF, 0);
 
-	// Clear up the register after read
+	// Flags are already cleared by the read, the write is kept for explicit requests
 	if (clearFlags) {
 		memset((void*) reg_vals, 0, 4);
 		S2LP_BatchWriteRegisters(handle, S2LP_REG_IRQ_STATUS3, reg_vals, 4);
@@ -65,7 +67,7 @@ uint32_t S2LP_GetInterruptsEx(S2LP_Handle* handle, bool clearFlags) {
 }
 
 uint32_t S2LP_GetInterrupts(S2LP_Handle* handle) {
-	return S2LP_GetInterruptsEx(handle, true);
+	return S2LP_GetInterruptsEx(handle, false);
 }
 
 void S2LP_SetInterruptMasks(S2LP_Handle* handle, uint32_t mask) {
@@ -113,20 +115,238 @@ S2LP_FIFOSelect S2LP_GetFIFOInterruptSource(S2LP_Handle* handle) {
 	return (S2LP_FIFOSelect) GETBIT(reg_val, 2);
 }
 
-void S2LP_ReadFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer) {
-	if (length > 128) {
+// Packet send & receive helpers
+
+// Unmask the interrupts, if they are not already. Masks are usually cached, so it's free.
+static void S2LP_EnablePacketInterrupts(S2LP_Handle* handle, uint32_t interrupts) {
+	uint32_t const masks = S2LP_GetInterruptMasks(handle);
+	if ((masks & interrupts) != interrupts) {
+		S2LP_SetInterruptMasks(handle, masks | interrupts);
+	}
+}
+
+// Find the GPIO configured as nIRQ output, using cached configuration only
+static bool S2LP_FindInterruptPin(S2LP_Handle* handle, S2LP_Pin* pin) {
+	for (uint8_t i = 0; i < 4; i++) {
+		uint8_t config = 0;
+		if (!S2LP_PeekRegister(handle, (S2LP_Register) (S2LP_REG_GPIO0_CONF + i), &config)) {
+			continue;
+		}
+
+		uint8_t const mode = GETBITS(config, 0b11, 0);
+		if ((mode == S2LP_PINMODE_OUTPUT_LP || mode == S2LP_PINMODE_OUTPUT_HP)
+				&& GETBITS(config, 0b11111, 3) == S2LP_GPIO_OUT_NIRQ) {
+			*pin = (S2LP_Pin) (S2LP_PIN_GPIO_0 + i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void S2LP_FinishPacket(S2LP_PacketOperation* operation, S2LP_PacketResult result, uint32_t interrupts) {
+	operation->result = result;
+	operation->interrupts = interrupts;
+	if (operation->callback != NULL) {
+		operation->callback(operation->handle, operation);
+	}
+}
+
+// Stop the radio and drop the FIFO content of the operation
+static void S2LP_StopPacket(S2LP_PacketOperation* operation) {
+	S2LP_SendCommand(operation->handle, S2LP_CMD_SABORT);
+	S2LP_SendCommand(operation->handle, (operation->receive ? S2LP_CMD_FLUSHRXFIFO : S2LP_CMD_FLUSHTXFIFO));
+}
+
+static void S2LP_InitPacketOperation(S2LP_PacketOperation* operation, S2LP_Handle* handle, bool receive,
+		uint8_t* data, size_t length, S2LP_PacketCallback callback, void* user_data) {
+	operation->handle = handle;
+	operation->receive = receive;
+	operation->data = data;
+	operation->capacity = (receive ? length : 0);
+	operation->length = (receive ? 0 : length);
+	operation->callback = callback;
+	operation->user_data = user_data;
+	operation->result = S2LP_PACKET_PENDING;
+	operation->interrupts = 0;
+}
+
+S2LP_PacketResult S2LP_SendPacket(S2LP_Handle* handle, uint8_t* data, size_t length, uint32_t timeout) {
+	S2LP_PacketOperation operation;
+	if (!S2LP_StartSendPacket(&operation, handle, data, length, NULL, NULL)) {
+		return S2LP_PACKET_ERROR;
+	}
+
+	return S2LP_WaitPacket(&operation, timeout);
+}
+
+S2LP_PacketResult S2LP_ReceivePacket(S2LP_Handle* handle, uint8_t* buffer, size_t capacity, size_t* length,
+		uint32_t timeout) {
+	S2LP_PacketOperation operation;
+	if (!S2LP_StartReceivePacket(&operation, handle, buffer, capacity, NULL, NULL)) {
+		return S2LP_PACKET_ERROR;
+	}
+
+	S2LP_PacketResult const result = S2LP_WaitPacket(&operation, timeout);
+	if (length != NULL) {
+		*length = operation.length;
+	}
+
+	return result;
+}
+
+bool S2LP_StartSendPacket(S2LP_PacketOperation* operation, S2LP_Handle* handle, uint8_t* data, size_t length,
+		S2LP_PacketCallback callback, void* user_data) {
+	if (length == 0 || length > S2LP_FIFO_SIZE) {
+		return false;
+	}
+
+	S2LP_InitPacketOperation(operation, handle, false, data, length, callback, user_data);
+	S2LP_EnablePacketInterrupts(handle, S2LP_PACKET_TX_INTERRUPTS);
+
+	// Sending packets of the same length doesn't touch the length registers
+	uint8_t known_length[2] = { 0 };
+	if (!S2LP_PeekRegister(handle, S2LP_REG_PCKTLEN1, &known_length[0])
+			|| !S2LP_PeekRegister(handle, S2LP_REG_PCKTLEN0, &known_length[1])
+			|| known_length[0] != GETBITS(length, 0xFF, 8) || known_length[1] != GETBITS(length, 0xFF, 0)) {
+		S2LP_PCKT_SetPacketLength(handle, length);
+	}
+
+	S2LP_WriteFIFO(handle, length, data);
+	S2LP_SendCommand(handle, S2LP_CMD_TX);
+	return true;
+}
+
+bool S2LP_StartReceivePacket(S2LP_PacketOperation* operation, S2LP_Handle* handle, uint8_t* buffer,
+		size_t capacity, S2LP_PacketCallback callback, void* user_data) {
+	if (capacity == 0) {
+		return false;
+	}
+
+	S2LP_InitPacketOperation(operation, handle, true, buffer, capacity, callback, user_data);
+	S2LP_EnablePacketInterrupts(handle, S2LP_PACKET_RX_INTERRUPTS);
+	S2LP_SendCommand(handle, S2LP_CMD_RX);
+	return true;
+}
+
+S2LP_PacketResult S2LP_ProcessPacket(S2LP_PacketOperation* operation, uint32_t interrupts) {
+	if (operation->result != S2LP_PACKET_PENDING) {
+		return operation->result;
+	}
+
+	if (!operation->receive) {
+		if (GETBIT(interrupts, S2LP_INT_TX_FIFO_ERROR)) {
+			S2LP_StopPacket(operation);
+			S2LP_FinishPacket(operation, S2LP_PACKET_ERROR, interrupts);
+		} else if (GETBIT(interrupts, S2LP_INT_TX_DATA_SENT)) {
+			S2LP_FinishPacket(operation, S2LP_PACKET_DONE, interrupts);
+		}
+
+		return operation->result;
+	}
+
+	if (GETBIT(interrupts, S2LP_INT_RX_FIFO_ERROR) || GETBIT(interrupts, S2LP_INT_CRC_ERROR)
+			|| GETBIT(interrupts, S2LP_INT_RX_DATA_DISCARDED)) {
+		S2LP_StopPacket(operation);
+		S2LP_FinishPacket(operation, S2LP_PACKET_ERROR, interrupts);
+	} else if (GETBIT(interrupts, S2LP_INT_RX_DATA_READY)) {
+		S2LP_Handle* const handle = operation->handle;
+		operation->length = S2LP_PCKT_GetRxPacketLength(handle);
+
+		if (operation->length > operation->capacity || operation->length > S2LP_FIFO_SIZE) {
+			S2LP_SendCommand(handle, S2LP_CMD_FLUSHRXFIFO);
+			S2LP_FinishPacket(operation, S2LP_PACKET_ERROR, interrupts);
+		} else {
+			S2LP_ReadFIFO(handle, operation->length, operation->data);
+			S2LP_FinishPacket(operation, S2LP_PACKET_DONE, interrupts);
+		}
+	} else if (GETBIT(interrupts, S2LP_INT_RX_TIMER_TIMEOUT)) {
+		// Radio is back in READY already
+		S2LP_FinishPacket(operation, S2LP_PACKET_TIMEOUT, interrupts);
+	}
+
+	return operation->result;
+}
+
+S2LP_PacketResult S2LP_WaitPacket(S2LP_PacketOperation* operation, uint32_t timeout) {
+	S2LP_Handle* const handle = operation->handle;
+	S2LP_Pin pin = S2LP_PIN_GPIO_0;
+	bool const has_nirq = S2LP_FindInterruptPin(handle, &pin);
+	uint32_t const start = S2LP_GetTime(handle);
+
+	while (operation->result == S2LP_PACKET_PENDING) {
+		// nIRQ is active low. Without it, every check is a transaction.
+		if (!has_nirq || !S2LP_ReadPin(handle, pin)) {
+			S2LP_ProcessPacket(operation, S2LP_GetInterrupts(handle));
+		}
+
+		if (operation->result == S2LP_PACKET_PENDING && timeout > 0
+				&& (uint64_t) (S2LP_GetTime(handle) - start) >= (uint64_t) timeout * 1000ull) {
+			S2LP_StopPacket(operation);
+			S2LP_FinishPacket(operation, S2LP_PACKET_TIMEOUT, 0);
+		}
+	}
+
+	return operation->result;
+}
+
+void S2LP_AbortPacket(S2LP_PacketOperation* operation) {
+	if (operation->result != S2LP_PACKET_PENDING) {
 		return;
 	}
 
+	S2LP_StopPacket(operation);
+	S2LP_FinishPacket(operation, S2LP_PACKET_ABORTED, 0);
+}
+
+bool S2LP_ReadReceivedPacket(S2LP_Handle* handle, size_t length, uint8_t* buffer, S2LP_PacketMetadata* metadata) {
+	if (buffer == NULL) {
+		S2LP_SendCommand(handle, S2LP_CMD_FLUSHRXFIFO);
+		return false;
+	}
+
+	metadata->length = S2LP_ReadFIFO(handle, length, buffer);
+	metadata->rssi = S2LP_RX_GetCapturedRSSI(handle);
+	metadata->timestamp = S2LP_GetTime(handle);
+	return true;
+}
+
+size_t S2LP_ReadFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer) {
+	if (length > S2LP_FIFO_SIZE) {
+		length = S2LP_FIFO_SIZE;
+	}
+
 	S2LP_BatchReadRegisters(handle, S2LP_ADDR_FIFO, buffer, length);
+	return length;
 }
 
-void S2LP_WriteFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer) {
-	if (length > 128) {
-		return;
+size_t S2LP_WriteFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer) {
+	if (length > S2LP_FIFO_SIZE) {
+		length = S2LP_FIFO_SIZE;
 	}
 
 	S2LP_BatchWriteRegisters(handle, S2LP_ADDR_FIFO, buffer, length);
+	return length;
+}
+
+bool S2LP_ReadFIFOAsync(S2LP_Handle* handle, S2LP_Transaction* transaction, size_t length, uint8_t* buffer,
+		S2LP_TransactionCallback callback, void* user_data) {
+	if (length > S2LP_FIFO_SIZE) {
+		length = S2LP_FIFO_SIZE;
+	}
+
+	S2LP_InitTransaction(transaction, S2LP_TRANSACTION_READ, S2LP_ADDR_FIFO, buffer, length, callback, user_data);
+	return S2LP_SubmitTransaction(handle, transaction);
+}
+
+bool S2LP_WriteFIFOAsync(S2LP_Handle* handle, S2LP_Transaction* transaction, size_t length, uint8_t* buffer,
+		S2LP_TransactionCallback callback, void* user_data) {
+	if (length > S2LP_FIFO_SIZE) {
+		length = S2LP_FIFO_SIZE;
+	}
+
+	S2LP_InitTransaction(transaction, S2LP_TRANSACTION_WRITE, S2LP_ADDR_FIFO, buffer, length, callback, user_data);
+	return S2LP_SubmitTransaction(handle, transaction);
 }
 
 uint8_t S2LP_GetDevicePartNumber(S2LP_Handle* handle) {
@@ -138,28 +358,11 @@ uint8_t S2LP_GetDeviceVersionNumber(S2LP_Handle* handle) {
 }
 
 uint32_t S2LP_GetClockFrequency(S2LP_Handle* handle) {
-	switch (handle->frequency) {
-		case S2LP_CLOCK_FREQ_24MHZ:
-			return 24000000;
-		case S2LP_CLOCK_FREQ_25MHZ:
-			return 25000000;
-		case S2LP_CLOCK_FREQ_26MHZ:
-			return 26000000;
-		case S2LP_CLOCK_FREQ_48MHZ:
-			return 48000000;
-		case S2LP_CLOCK_FREQ_50MHZ:
-			return 50000000;
-		case S2LP_CLOCK_FREQ_52MHZ:
-			return 52000000;
-		case S2LP_CLOCK_FREQ_INVALID:
-		default:
-			return 0;
-	}
+	return S2LP_RFCalc_ClockFrequency(handle->frequency);
 }
 
 bool S2LP_IsDigitalClockDivided(S2LP_Handle* handle) {
-	return (handle->frequency == S2LP_CLOCK_FREQ_48MHZ || handle->frequency == S2LP_CLOCK_FREQ_50MHZ
-			|| handle->frequency == S2LP_CLOCK_FREQ_52MHZ);
+	return S2LP_RFCalc_IsDigitalClockDivided(handle->frequency);
 }
 
 uint32_t S2LP_GetDigitalClockFrequency(S2LP_Handle* handle) {
@@ -201,7 +404,7 @@ bool S2LP_CallibrateRCO(S2LP_Handle* handle) {
 	S2LP_Status status = S2LP_ReadStatus(handle);
 	int tries = 0;
 	while (!status.rco_cal_ok && tries < S2LP_RCO_CALLIB_TRIES) {
-		S2LP_Delay(S2LP_RCO_CALLIB_WAIT_TIME);
+		S2LP_Delay(handle, S2LP_RCO_CALLIB_WAIT_TIME);
 		status = S2LP_ReadStatus(handle);
 		tries++;
 	}
@@ -38,6 +38,48 @@ typedef struct S2LP_Status_t {
 	bool rco_cal_ok;
 } S2LP_Status;
 
+// Packet send & receive - see S2LP_StartSendPacket and S2LP_StartReceivePacket
+
+// Interrupts used by packet send and receive, unmasked when the operation starts
+#define S2LP_PACKET_TX_INTERRUPTS ((1ul << S2LP_INT_TX_DATA_SENT) | (1ul << S2LP_INT_TX_FIFO_ERROR))
+#define S2LP_PACKET_RX_INTERRUPTS ((1ul << S2LP_INT_RX_DATA_READY) | (1ul << S2LP_INT_RX_DATA_DISCARDED) \
+		| (1ul << S2LP_INT_CRC_ERROR) | (1ul << S2LP_INT_RX_FIFO_ERROR) | (1ul << S2LP_INT_RX_TIMER_TIMEOUT))
+
+typedef enum S2LP_PacketResult_t {
+	S2LP_PACKET_PENDING, S2LP_PACKET_DONE, S2LP_PACKET_ERROR, S2LP_PACKET_TIMEOUT, S2LP_PACKET_ABORTED
+} S2LP_PacketResult;
+
+typedef struct S2LP_PacketOperation_t S2LP_PacketOperation;
+
+// Received packet metadata, see S2LP_ReadReceivedPacket
+typedef struct S2LP_PacketMetadata_t {
+	// Amount of bytes read from RX FIFO
+	size_t length;
+	// RSSI captured at the end of sync word (raw, see S2LP_Utils_RSSITodBm)
+	uint8_t rssi;
+	// S2LP_GetTime at the moment the packet was read
+	uint32_t timestamp;
+} S2LP_PacketMetadata;
+
+// Called when the operation is finished, from the context that finished it
+// (S2LP_ProcessPacket, S2LP_WaitPacket or S2LP_AbortPacket).
+typedef void (*S2LP_PacketCallback)(S2LP_Handle* handle, S2LP_PacketOperation* operation);
+
+struct S2LP_PacketOperation_t {
+	S2LP_Handle* handle;
+	bool receive;
+	// Data to send, or buffer for received data and it's capacity
+	uint8_t* data;
+	size_t capacity;
+	// Length of the sent packet, or the received one (also when it didn't fit in the buffer)
+	size_t length;
+	S2LP_PacketCallback callback;
+	void* user_data;
+	S2LP_PacketResult result;
+	// Interrupt flags which finished the operation
+	uint32_t interrupts;
+};
+
 // ==== Initialization ====
 
 // Initialize S2LP. Call this after setting up fields in handle, but before calling any other function.
@@ -60,8 +102,9 @@ S2LP_Status S2LP_ReadStatus(S2LP_Handle* handle);
 // S2LP_GetInterrupts(handle) & (1 << S2LP_INT_CRC_ERROR)
 // or use macro from bit_helpers.h and do
 // GETBIT(S2LP_GetInterrupts(handle), S2LP_INT_CRC_ERROR)
-// GetInterrupts cleans the interrupt flags in S2-LP by default.
-// You can keep the flags by using GetInterruptsEx with clearFlags = false
+// S2-LP clears the interrupt flags on read, so GetInterrupts is a single burst read.
+// GetInterruptsEx with clearFlags = true additionally writes zeros to the status
+// registers, which costs another transaction and is not needed by S2-LP.
 uint32_t S2LP_GetInterruptsEx(S2LP_Handle* handle, bool clearFlags);
 uint32_t S2LP_GetInterrupts(S2LP_Handle* handle);
 
@@ -84,11 +127,66 @@ void S2LP_SetFIFOInterruptSource(S2LP_Handle* handle, S2LP_FIFOSelect fifo);
 // Get current FIFO interrupt source
 S2LP_FIFOSelect S2LP_GetFIFOInterruptSource(S2LP_Handle* handle);
 
+// ==== Packet send & receive ====
+
+// Packets up to S2LP_FIFO_SIZE bytes, sent and received with the minimal amount of transactions:
+// * send - FIFO write and TX command, then a single interrupt read when it's done
+// * receive - RX command, then interrupt read, packet length read and FIFO read when it's done
+// Packet length and interrupt masks are written only when they change (known from register cache),
+// TX and RX FIFOs are flushed only after errors. Interrupt flags are cleared on read.
+// Radio has to be in READY state, with empty TX FIFO for sending. Interrupt flags raised before
+// the start are taken as part of the operation - if the radio was used without these functions,
+// read them out (S2LP_GetInterrupts) first. For longer packets, see s2lp_stream.h.
+// Blocking functions wait for nIRQ, if one of the GPIOs is configured as NIRQ output (and it's
+// configuration is in the register cache), otherwise they poll the interrupt flags. Timeout is
+// in milliseconds (0 to wait forever), and works only with transport time source.
+// Non-blocking usage:
+//   S2LP_StartReceivePacket(&operation, &handle, buffer, sizeof(buffer), on_packet, NULL);
+//   // nIRQ handler
+//   S2LP_ProcessPacket(&operation, S2LP_GetInterrupts(&handle));
+
+S2LP_PacketResult S2LP_SendPacket(S2LP_Handle* handle, uint8_t* data, size_t length, uint32_t timeout);
+// Received length is stored in `length`, if it's not NULL
+S2LP_PacketResult S2LP_ReceivePacket(S2LP_Handle* handle, uint8_t* buffer, size_t capacity, size_t* length,
+		uint32_t timeout);
+
+// Start the operation and return immediately. Data is not copied - keep it, and the operation,
+// alive until it's finished. Callback can be NULL.
+// Returns false if the length or capacity is 0, or the packet length is over S2LP_FIFO_SIZE.
+bool S2LP_StartSendPacket(S2LP_PacketOperation* operation, S2LP_Handle* handle, uint8_t* data, size_t length,
+		S2LP_PacketCallback callback, void* user_data);
+bool S2LP_StartReceivePacket(S2LP_PacketOperation* operation, S2LP_Handle* handle, uint8_t* buffer,
+		size_t capacity, S2LP_PacketCallback callback, void* user_data);
+// Handle the interrupt flags (S2LP_GetInterrupts result) - read the received packet, or finish
+// on data sent or error. Returns the operation result.
+S2LP_PacketResult S2LP_ProcessPacket(S2LP_PacketOperation* operation, uint32_t interrupts);
+// Block until the operation is finished, or abort it with S2LP_PACKET_TIMEOUT after the timeout.
+// Other interrupt flags read while waiting are dropped.
+S2LP_PacketResult S2LP_WaitPacket(S2LP_PacketOperation* operation, uint32_t timeout);
+// Stop the operation in progress and flush it's FIFO
+void S2LP_AbortPacket(S2LP_PacketOperation* operation);
+
+// Read the received packet (after RX_DATA_READY) from RX FIFO straight into the buffer, with it's
+// metadata. Length is the one from S2LP_PCKT_GetRxPacketLength, checked against the buffer by the caller.
+// NULL buffer (no room for the packet) drops it - RX FIFO is flushed, and false is returned.
+// Used by packet containers (s2lp_ring.h, s2lp_pool.h).
+bool S2LP_ReadReceivedPacket(S2LP_Handle* handle, size_t length, uint8_t* buffer, S2LP_PacketMetadata* metadata);
+
 // ==== Misc ====
 
-// FIFO I/O
-void S2LP_ReadFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer);
-void S2LP_WriteFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer);
+// FIFO I/O. Data goes directly from/to the buffer. Length is clamped to the
+// FIFO size (S2LP_FIFO_SIZE), returns the amount of bytes transferred.
+size_t S2LP_ReadFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer);
+size_t S2LP_WriteFIFO(S2LP_Handle* handle, size_t length, uint8_t* buffer);
+
+// Asynchronous FIFO I/O - queue the transfer and return immediately.
+// `transaction` and `buffer` must stay alive until the transaction is done,
+// see S2LP_SubmitTransaction. Length is clamped like in synchronous version,
+// transaction->length holds the actual length.
+bool S2LP_ReadFIFOAsync(S2LP_Handle* handle, S2LP_Transaction* transaction, size_t length, uint8_t* buffer,
+		S2LP_TransactionCallback callback, void* user_data);
+bool S2LP_WriteFIFOAsync(S2LP_Handle* handle, S2LP_Transaction* transaction, size_t length, uint8_t* buffer,
+		S2LP_TransactionCallback callback, void* user_data);
 
 // Read device PN and VN
 uint8_t S2LP_GetDevicePartNumber(S2LP_Handle* handle);
@@ -0,0 +1,288 @@
+/*
+ * s2lp_bus.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_bus.h"
+
+#include <string.h>
+
+// ===== Arbitration helpers =====
+
+// Transactions of single device are executed in order, so the device gets
+// the priority of the most important transaction in it's queue
+static S2LP_TransactionPriority S2LP_Bus_DevicePriority(S2LP_BusDevice* device) {
+	S2LP_TransactionPriority priority = S2LP_PRIORITY_LOW;
+
+	for (S2LP_Transaction* transaction = device->handle->queue_head; transaction != NULL;
+			transaction = transaction->next) {
+		if (transaction->priority > priority) {
+			priority = transaction->priority;
+		}
+	}
+
+	return priority;
+}
+
+// Pick the device which gets the bus next, or NULL if there's nothing to do
+static S2LP_BusDevice* S2LP_Bus_Grant(S2LP_Bus* bus) {
+	S2LP_BusDevice* first = NULL;
+	S2LP_BusDevice* granted = NULL;
+	S2LP_TransactionPriority granted_priority = S2LP_PRIORITY_LOW;
+	size_t granted_index = 0;
+
+	for (size_t i = 0; i < bus->device_count; i++) {
+		size_t const index = (bus->next_device + i) % bus->device_count;
+		S2LP_BusDevice* const device = bus->devices[index];
+		if (device->handle->queue_head == NULL) {
+			continue;
+		}
+
+		S2LP_TransactionPriority const priority = S2LP_Bus_DevicePriority(device);
+		if (first == NULL) {
+			first = device;
+		}
+
+		if (granted == NULL || priority > granted_priority) {
+			granted = device;
+			granted_priority = priority;
+			granted_index = index;
+		}
+	}
+
+	if (granted == NULL) {
+		return NULL;
+	}
+
+	if (granted != first) {
+		granted->statistics.preemptions++;
+		bus->statistics.preemptions++;
+	}
+
+	for (size_t i = 0; i < bus->device_count; i++) {
+		S2LP_BusDevice* const device = bus->devices[i];
+		if (device != granted && device->handle->queue_head != NULL) {
+			device->statistics.deferrals++;
+			bus->statistics.deferrals++;
+		}
+	}
+
+	bus->next_device = (granted_index + 1) % bus->device_count;
+	return granted;
+}
+
+// ===== Transport implementation =====
+
+static void S2LP_Bus_CountBytes(S2LP_BusDevice* device, size_t length) {
+	device->statistics.bytes += length;
+	device->bus->statistics.bytes += length;
+}
+
+static void S2LP_Bus_Transfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_BusDevice* const device = (S2LP_BusDevice*) context;
+	S2LP_Bus* const bus = device->bus;
+
+	bus->transport->transfer(bus->transport_context, tx_data, rx_data, length);
+	S2LP_Bus_CountBytes(device, length);
+}
+
+static void S2LP_Bus_TransferStart(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_BusDevice* const device = (S2LP_BusDevice*) context;
+	S2LP_Bus* const bus = device->bus;
+
+	// Without non-blocking transfers, the transfer is done before it's polled
+	if (bus->transport->transfer_start != NULL) {
+		bus->transport->transfer_start(bus->transport_context, tx_data, rx_data, length);
+	} else {
+		bus->transport->transfer(bus->transport_context, tx_data, rx_data, length);
+	}
+
+	S2LP_Bus_CountBytes(device, length);
+}
+
+static bool S2LP_Bus_TransferPoll(void* context) {
+	S2LP_Bus* const bus = ((S2LP_BusDevice*) context)->bus;
+
+	if (bus->transport->transfer_start == NULL) {
+		return true;
+	}
+
+	// Without transfer_poll the completion is reported by interrupt
+	if (bus->transport->transfer_poll == NULL) {
+		return false;
+	}
+
+	return bus->transport->transfer_poll(bus->transport_context);
+}
+
+static void S2LP_Bus_WritePin(void* context, S2LP_Pin pin, bool state) {
+	S2LP_BusDevice* const device = (S2LP_BusDevice*) context;
+
+	if (pin == S2LP_PIN_CSN && !state) {
+		device->statistics.transactions++;
+		device->bus->statistics.transactions++;
+	}
+
+	device->transport->write_pin(device->transport_context, pin, state);
+}
+
+static bool S2LP_Bus_ReadPin(void* context, S2LP_Pin pin) {
+	S2LP_BusDevice* const device = (S2LP_BusDevice*) context;
+	return device->transport->read_pin(device->transport_context, pin);
+}
+
+static void S2LP_Bus_Delay(void* context, uint32_t milliseconds) {
+	S2LP_BusDevice* const device = (S2LP_BusDevice*) context;
+	device->transport->delay(device->transport_context, milliseconds);
+}
+
+static uint32_t S2LP_Bus_GetTime(void* context) {
+	S2LP_BusDevice* const device = (S2LP_BusDevice*) context;
+
+	if (device->transport->get_time_us == NULL) {
+		return 0;
+	}
+
+	return device->transport->get_time_us(device->transport_context);
+}
+
+S2LP_Transport const S2LP_Bus_Transport = {
+	.transfer = S2LP_Bus_Transfer,
+	.write_pin = S2LP_Bus_WritePin,
+	.read_pin = S2LP_Bus_ReadPin,
+	.delay = S2LP_Bus_Delay,
+	.get_time_us = S2LP_Bus_GetTime,
+	.transfer_start = S2LP_Bus_TransferStart,
+	.transfer_poll = S2LP_Bus_TransferPoll,
+};
+
+// ===== Public API =====
+
+void S2LP_Bus_Init(S2LP_Bus* bus, S2LP_Transport const* transport, void* transport_context) {
+	memset(bus, 0, sizeof(S2LP_Bus));
+
+	bus->transport = transport;
+	bus->transport_context = transport_context;
+}
+
+void S2LP_Bus_SetLock(S2LP_Bus* bus, S2LP_Lock const* lock, void* lock_context) {
+	bus->lock = lock;
+	bus->lock_context = lock_context;
+}
+
+bool S2LP_Bus_Attach(S2LP_Bus* bus, S2LP_BusDevice* device, S2LP_Handle* handle,
+		S2LP_Transport const* transport, void* transport_context) {
+	if (bus->device_count >= S2LP_BUS_MAX_DEVICES) {
+		return false;
+	}
+
+	device->bus = bus;
+	device->handle = handle;
+	device->transport = transport;
+	device->transport_context = transport_context;
+	memset(&device->statistics, 0, sizeof(S2LP_BusStatistics));
+
+	handle->transport = &S2LP_Bus_Transport;
+	handle->transport_context = device;
+
+	S2LP_Bus_Lock(bus);
+	bus->devices[bus->device_count] = device;
+	bus->device_count++;
+	S2LP_Bus_Unlock(bus);
+
+	return true;
+}
+
+S2LP_BusDevice* S2LP_Bus_GetDevice(S2LP_Handle* handle) {
+	if (handle->transport != &S2LP_Bus_Transport) {
+		return NULL;
+	}
+
+	return (S2LP_BusDevice*) handle->transport_context;
+}
+
+void S2LP_Bus_Lock(S2LP_Bus* bus) {
+	if (bus->lock != NULL) {
+		bus->lock->lock(bus->lock_context);
+	}
+}
+
+void S2LP_Bus_Unlock(S2LP_Bus* bus) {
+	if (bus->lock != NULL) {
+		bus->lock->unlock(bus->lock_context);
+	}
+}
+
+void S2LP_Bus_Schedule(S2LP_Bus* bus) {
+	while (bus->active == NULL && bus->owner == NULL) {
+		S2LP_BusDevice* const device = S2LP_Bus_Grant(bus);
+		if (device == NULL) {
+			return;
+		}
+
+		// Marked as active before the start, so the completion can't be missed,
+		// and transactions submitted from callbacks don't start in the middle
+		bus->active = device;
+		if (!S2LP_StartQueuedTransaction(device->handle)) {
+			bus->active = NULL;
+		}
+	}
+}
+
+bool S2LP_Bus_Poll(S2LP_Bus* bus) {
+	S2LP_Bus_Lock(bus);
+
+	S2LP_BusDevice* const device = bus->active;
+	if (device != NULL && S2LP_Bus_TransferPoll(device)) {
+		S2LP_Bus_OnTransferComplete(bus);
+	}
+
+	bool const idle = (bus->active == NULL);
+	S2LP_Bus_Unlock(bus);
+	return idle;
+}
+
+void S2LP_Bus_WaitAllTransactions(S2LP_Bus* bus) {
+	while (!S2LP_Bus_Poll(bus)) {
+	}
+}
+
+void S2LP_Bus_OnTransferComplete(S2LP_Bus* bus) {
+	S2LP_BusDevice* const device = bus->active;
+	if (device == NULL) {
+		return;
+	}
+
+	S2LP_FinishQueuedTransaction(device->handle);
+	bus->active = NULL;
+	S2LP_Bus_Schedule(bus);
+}
+
+void S2LP_Bus_Claim(S2LP_Bus* bus, S2LP_BusDevice* device) {
+	S2LP_Bus_Lock(bus);
+
+	// Owner is set first, so no new transactions are started in the meantime
+	bus->owner = device;
+	while (bus->active != NULL) {
+		S2LP_Bus_Poll(bus);
+	}
+}
+
+void S2LP_Bus_Release(S2LP_Bus* bus) {
+	bus->owner = NULL;
+	S2LP_Bus_Schedule(bus);
+	S2LP_Bus_Unlock(bus);
+}
+
+void S2LP_Bus_ResetStatistics(S2LP_Bus* bus) {
+	S2LP_Bus_Lock(bus);
+
+	memset(&bus->statistics, 0, sizeof(S2LP_BusStatistics));
+	for (size_t i = 0; i < bus->device_count; i++) {
+		memset(&bus->devices[i]->statistics, 0, sizeof(S2LP_BusStatistics));
+	}
+
+	S2LP_Bus_Unlock(bus);
+}
@@ -0,0 +1,124 @@
+/*
+ * s2lp_bus.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_BUS_H_
+#define S2LP_S2LP_BUS_H_
+
+// Shared SPI bus with multiple S2-LPs, each one with it's own chip select.
+// The bus owns the SPI transport (only transfer operations are used), and every attached
+// device has it's own transport for the pins (chip select, shutdown, GPIOs), delays and time.
+// Attaching a device replaces the transport of it's handle with S2LP_Bus_Transport.
+//
+// Asynchronous transactions of all the devices are arbitrated by the bus - when the bus is
+// free, it's granted to the device with the highest priority transaction in it's queue (see
+// S2LP_TransactionPriority), devices with equal priorities are served round-robin.
+// Transaction in progress is never interrupted, so higher priority transactions (like RX FIFO
+// drains) preempt the lower priority ones (like configuration writes) at transaction boundaries.
+// Synchronous transactions (S2LP_Select - S2LP_Deselect) take the bus when it's free.
+//
+// All the attached handles share the bus lock (see S2LP_Bus_SetLock), their own locks are not used.
+// Usage:
+//   S2LP_Bus bus;
+//   S2LP_BusDevice devices[2];
+//   S2LP_Bus_Init(&bus, &spi_transport, &spi_context);
+//   S2LP_Bus_Attach(&bus, &devices[0], &handle_a, &pins_transport, &pins_a);
+//   S2LP_Bus_Attach(&bus, &devices[1], &handle_b, &pins_transport, &pins_b);
+//   S2LP_Initialize(&handle_a, S2LP_CLOCK_FREQ_50MHZ);
+//   S2LP_Initialize(&handle_b, S2LP_CLOCK_FREQ_50MHZ);
+// DMA interrupt handler of the bus should call S2LP_Bus_OnTransferComplete.
+
+#include "s2lp_mcu_interface.h"
+
+#define S2LP_BUS_MAX_DEVICES 8
+
+typedef struct S2LP_BusStatistics_t {
+	// Chip select frames
+	uint32_t transactions;
+	// Bytes transferred over SPI, including headers
+	uint64_t bytes;
+	// Bus grants given to higher priority transactions, ahead of the devices
+	// waiting before them in round-robin order
+	uint32_t preemptions;
+	// Bus grants given to another device, while there were transactions waiting
+	uint32_t deferrals;
+} S2LP_BusStatistics;
+
+struct S2LP_Bus_t;
+
+typedef struct S2LP_BusDevice_t {
+	// Set by S2LP_Bus_Attach
+	struct S2LP_Bus_t* bus;
+	S2LP_Handle* handle;
+	// Device transport, used for pins, delays and time
+	S2LP_Transport const* transport;
+	void* transport_context;
+
+	S2LP_BusStatistics statistics;
+} S2LP_BusDevice;
+
+typedef struct S2LP_Bus_t {
+	// SPI transport - transfer, and optionally transfer_start and transfer_poll
+	S2LP_Transport const* transport;
+	void* transport_context;
+
+	// Optional lock, shared by all attached handles
+	S2LP_Lock const* lock;
+	void* lock_context;
+
+	S2LP_BusDevice* devices[S2LP_BUS_MAX_DEVICES];
+	size_t device_count;
+
+	// Device with asynchronous transaction in progress
+	S2LP_BusDevice* volatile active;
+	// Device holding the bus for synchronous transaction
+	S2LP_BusDevice* owner;
+	// Round-robin position - index of the device checked first
+	size_t next_device;
+
+	S2LP_BusStatistics statistics;
+} S2LP_Bus;
+
+// Transport of attached handles - routes transfers to the bus, and everything else
+// to the device transport. Context is the S2LP_BusDevice.
+extern S2LP_Transport const S2LP_Bus_Transport;
+
+// Init the bus with SPI transport. Removes all the devices and the lock.
+void S2LP_Bus_Init(S2LP_Bus* bus, S2LP_Transport const* transport, void* transport_context);
+// Set the lock used by the bus and all attached handles (NULL to disable locking).
+void S2LP_Bus_SetLock(S2LP_Bus* bus, S2LP_Lock const* lock, void* lock_context);
+// Attach the handle to the bus, before calling S2LP_Initialize on it.
+// Device struct must stay alive as long as the handle is used.
+// Returns false if the bus is full.
+bool S2LP_Bus_Attach(S2LP_Bus* bus, S2LP_BusDevice* device, S2LP_Handle* handle,
+		S2LP_Transport const* transport, void* transport_context);
+// Returns the bus device of the handle, or NULL if the handle is not attached to any bus.
+S2LP_BusDevice* S2LP_Bus_GetDevice(S2LP_Handle* handle);
+
+void S2LP_Bus_Lock(S2LP_Bus* bus);
+void S2LP_Bus_Unlock(S2LP_Bus* bus);
+
+// Start queued transactions of attached devices, while the bus is free.
+// Called by the library after submitting transactions.
+void S2LP_Bus_Schedule(S2LP_Bus* bus);
+// Check for transfer completion using transport's transfer_poll, and advance the queues.
+// Returns true if the bus is free (there are no more transactions in any queue).
+bool S2LP_Bus_Poll(S2LP_Bus* bus);
+// Block until transactions of all attached devices are done.
+void S2LP_Bus_WaitAllTransactions(S2LP_Bus* bus);
+// To be called by SPI transport (or it's interrupt handler) when transfer started
+// by transfer_start is done.
+void S2LP_Bus_OnTransferComplete(S2LP_Bus* bus);
+
+// Take the bus for synchronous transaction of the device, waiting for the transaction
+// in progress to end. Used by S2LP_Select and S2LP_Deselect.
+void S2LP_Bus_Claim(S2LP_Bus* bus, S2LP_BusDevice* device);
+void S2LP_Bus_Release(S2LP_Bus* bus);
+
+// Reset statistics of the bus and all attached devices
+void S2LP_Bus_ResetStatistics(S2LP_Bus* bus);
+
+#endif /* S2LP_S2LP_BUS_H_ */
@@ -0,0 +1,127 @@
+/*
+ * s2lp_channel_plan.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_channel_plan.h"
+#include "s2lp_rf.h"
+#include "bit_helpers.h"
+
+#include <string.h>
+
+static uint32_t S2LP_ChannelPlan_Difference(uint32_t a, uint32_t b) {
+	return (a > b ? a - b : b - a);
+}
+
+static void S2LP_ChannelPlan_SetSynth(S2LP_ChannelPlan_Entry* entry, uint8_t synt3, uint32_t synth) {
+	// Synthesizer word takes 4 lower bits of SYNT3, the rest is band and charge pump config
+	entry->synt[0] = synt3;
+	CLEARBITS(entry->synt[0], 0b1111, 0);
+	SETBITS(entry->synt[0], GETBITS(synth, 0b1111, 24), 0b1111, 0);
+	entry->synt[1] = GETBITS(synth, 0xFF, 16);
+	entry->synt[2] = GETBITS(synth, 0xFF, 8);
+	entry->synt[3] = GETBITS(synth, 0xFF, 0);
+}
+
+bool S2LP_ChannelPlan_Build(S2LP_Handle* handle, S2LP_ChannelPlan* plan, uint32_t base_frequency, uint32_t spacing,
+		size_t channel_count) {
+	if (channel_count == 0 || channel_count > S2LP_CHANNEL_PLAN_MAX_CHANNELS) {
+		return false;
+	}
+
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+	if (context.fxo == 0) {
+		return false;
+	}
+
+	uint8_t const synt3 = S2LP_ReadRegister(handle, S2LP_REG_SYNT3);
+	plan->channel_count = channel_count;
+	plan->channel_spacing = 0;
+
+	// Separate synthesizer word for every channel
+	uint32_t synth_worst_error = 0;
+	for (size_t channel = 0; channel < channel_count; channel++) {
+		S2LP_ChannelPlan_Entry* const entry = &plan->channels[channel];
+		uint32_t const target = base_frequency + (uint32_t) channel * spacing;
+		uint32_t const synth = S2LP_RFCalc_SyncForBaseFrequency(&context, target);
+
+		S2LP_ChannelPlan_SetSynth(entry, synt3, synth);
+		entry->channel_number = 0;
+		entry->frequency = S2LP_RFCalc_BaseFrequencyValue(&context, synth);
+
+		uint32_t const error = S2LP_ChannelPlan_Difference(entry->frequency, target);
+		synth_worst_error = (error > synth_worst_error ? error : synth_worst_error);
+	}
+
+	// Channel spacing in CHSPACE units (fXO / 2^15). If it's as accurate as the synthesizer
+	// on all the channels, switching needs only CHNUM register write.
+	uint64_t const channel_spacing = (((uint64_t) spacing << 15) + context.fxo / 2) / context.fxo;
+	if (channel_count == 1 || channel_spacing == 0 || channel_spacing > 0xFF) {
+		return true;
+	}
+
+	// Integer math only, so fixed-point builds don't need floating point support
+	uint32_t const base = plan->channels[0].frequency;
+	for (size_t channel = 1; channel < channel_count; channel++) {
+		uint32_t const target = base_frequency + (uint32_t) channel * spacing;
+		uint32_t const frequency = S2LP_RFCalc_CenterFrequencyValue(&context, base, (uint8_t) channel_spacing,
+				(uint8_t) channel);
+		if (S2LP_ChannelPlan_Difference(frequency, target) > synth_worst_error) {
+			return true;
+		}
+	}
+
+	plan->channel_spacing = (uint8_t) channel_spacing;
+	for (size_t channel = 1; channel < channel_count; channel++) {
+		S2LP_ChannelPlan_Entry* const entry = &plan->channels[channel];
+		memcpy(entry->synt, plan->channels[0].synt, sizeof(entry->synt));
+		entry->channel_number = (uint8_t) channel;
+		entry->frequency = S2LP_RFCalc_CenterFrequencyValue(&context, base, plan->channel_spacing,
+				entry->channel_number);
+	}
+
+	return true;
+}
+
+bool S2LP_ChannelPlan_Apply(S2LP_Handle* handle, S2LP_ChannelPlan const* plan, size_t channel) {
+	if (channel >= plan->channel_count) {
+		return false;
+	}
+
+	uint8_t synt[4] = { 0 };
+	memcpy(synt, plan->channels[channel].synt, sizeof(synt));
+
+	S2LP_BeginWriteBatch(handle);
+	S2LP_BatchWriteRegisters(handle, S2LP_REG_SYNT3, synt, sizeof(synt));
+	S2LP_WriteRegister(handle, S2LP_REG_CHSPACE, plan->channel_spacing);
+	S2LP_WriteRegister(handle, S2LP_REG_CHNUM, plan->channels[channel].channel_number);
+	S2LP_CommitWriteBatch(handle);
+	return true;
+}
+
+bool S2LP_ChannelPlan_SelectChannel(S2LP_Handle* handle, S2LP_ChannelPlan const* plan, size_t channel) {
+	if (channel >= plan->channel_count) {
+		return false;
+	}
+
+	if (plan->channel_spacing != 0) {
+		S2LP_WriteRegister(handle, S2LP_REG_CHNUM, plan->channels[channel].channel_number);
+	} else {
+		uint8_t synt[4] = { 0 };
+		memcpy(synt, plan->channels[channel].synt, sizeof(synt));
+		S2LP_BatchWriteRegisters(handle, S2LP_REG_SYNT3, synt, sizeof(synt));
+	}
+
+	return true;
+}
+
+uint32_t S2LP_ChannelPlan_GetFrequency(S2LP_ChannelPlan const* plan, size_t channel) {
+	if (channel >= plan->channel_count) {
+		return 0;
+	}
+
+	return plan->channels[channel].frequency;
+}
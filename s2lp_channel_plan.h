@@ -0,0 +1,61 @@
+/*
+ * s2lp_channel_plan.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_CHANNEL_PLAN_H_
+#define S2LP_S2LP_CHANNEL_PLAN_H_
+
+// Channel plans - register values of equally spaced channels, calculated once, so
+// switching the channel is a single precomputed write.
+// Channels are switched either by CHNUM register (single register write), when channel
+// spacing can be represented by CHSPACE register as accurately as by the synthesizer,
+// or by the synthesizer word (single burst write of SYNT3 - SYNT0) otherwise.
+// SYNT3 also contains synthesizer band and charge pump current - the plan uses the values
+// set when it was built, so rebuild it after changing them.
+// Usage:
+//   S2LP_ChannelPlan plan;
+//   S2LP_ChannelPlan_Build(&handle, &plan, 868000000, 100000, 10);
+//   S2LP_ChannelPlan_Apply(&handle, &plan, 0);
+//   ...
+//   S2LP_ChannelPlan_SelectChannel(&handle, &plan, 5);
+
+#include "s2lp_mcu_interface.h"
+
+#define S2LP_CHANNEL_PLAN_MAX_CHANNELS 64
+
+typedef struct S2LP_ChannelPlan_Entry_t {
+	// Values of SYNT3, SYNT2, SYNT1 and SYNT0 registers
+	uint8_t synt[4];
+	// Value of CHNUM register
+	uint8_t channel_number;
+	// Real center frequency of the channel, in Hz
+	uint32_t frequency;
+} S2LP_ChannelPlan_Entry;
+
+typedef struct S2LP_ChannelPlan_t {
+	S2LP_ChannelPlan_Entry channels[S2LP_CHANNEL_PLAN_MAX_CHANNELS];
+	size_t channel_count;
+	// Value of CHSPACE register, 0 if channels are switched by synthesizer word
+	uint8_t channel_spacing;
+} S2LP_ChannelPlan;
+
+// Calculate the plan for channels at base_frequency + n * spacing (in Hz), n = 0 .. channel_count - 1.
+// Reads SYNT3 from S2-LP (free with register cache), band and charge pump bits go into the plan.
+// Returns false if channel count is 0 or too big, or the clock frequency is invalid.
+bool S2LP_ChannelPlan_Build(S2LP_Handle* handle, S2LP_ChannelPlan* plan, uint32_t base_frequency, uint32_t spacing,
+		size_t channel_count);
+
+// Write the whole plan configuration (synthesizer word, channel spacing and number) and select the channel.
+// Has to be called once before S2LP_ChannelPlan_SelectChannel.
+bool S2LP_ChannelPlan_Apply(S2LP_Handle* handle, S2LP_ChannelPlan const* plan, size_t channel);
+
+// Switch to another channel of applied plan, with a single write. Returns false for invalid channel.
+bool S2LP_ChannelPlan_SelectChannel(S2LP_Handle* handle, S2LP_ChannelPlan const* plan, size_t channel);
+
+// Get the real center frequency of the channel, in Hz. Returns 0 for invalid channel.
+uint32_t S2LP_ChannelPlan_GetFrequency(S2LP_ChannelPlan const* plan, size_t channel);
+
+#endif /* S2LP_S2LP_CHANNEL_PLAN_H_ */
@@ -0,0 +1,320 @@
+/*
+ * s2lp_codec.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_codec.h"
+
+#include <string.h>
+
+// Table generation for 256-entry tables computed from the index
+
+#define S2LP_CODEC_ROW(entry, index) entry((index) + 0), entry((index) + 1), entry((index) + 2), \
+		entry((index) + 3), entry((index) + 4), entry((index) + 5), entry((index) + 6), entry((index) + 7), \
+		entry((index) + 8), entry((index) + 9), entry((index) + 10), entry((index) + 11), entry((index) + 12), \
+		entry((index) + 13), entry((index) + 14), entry((index) + 15)
+#define S2LP_CODEC_TABLE(entry) { S2LP_CODEC_ROW(entry, 0x00), S2LP_CODEC_ROW(entry, 0x10), \
+		S2LP_CODEC_ROW(entry, 0x20), S2LP_CODEC_ROW(entry, 0x30), S2LP_CODEC_ROW(entry, 0x40), \
+		S2LP_CODEC_ROW(entry, 0x50), S2LP_CODEC_ROW(entry, 0x60), S2LP_CODEC_ROW(entry, 0x70), \
+		S2LP_CODEC_ROW(entry, 0x80), S2LP_CODEC_ROW(entry, 0x90), S2LP_CODEC_ROW(entry, 0xA0), \
+		S2LP_CODEC_ROW(entry, 0xB0), S2LP_CODEC_ROW(entry, 0xC0), S2LP_CODEC_ROW(entry, 0xD0), \
+		S2LP_CODEC_ROW(entry, 0xE0), S2LP_CODEC_ROW(entry, 0xF0) }
+
+// ===== Whitening =====
+
+#define S2LP_CODEC_PN9_PERIOD 511
+
+// PN9 sequence bytes - it repeats every 511 bytes
+static uint8_t const S2LP_CODEC_PN9[S2LP_CODEC_PN9_PERIOD] = {
+		0xFF, 0xE1, 0x1D, 0x9A, 0xED, 0x85, 0x33, 0x24, 0xEA, 0x7A, 0xD2, 0x39, 0x70, 0x97, 0x57, 0x0A,
+		0x54, 0x7D, 0x2D, 0xD8, 0x6D, 0x0D, 0xBA, 0x8F, 0x67, 0x59, 0xC7, 0xA2, 0xBF, 0x34, 0xCA, 0x18,
+		0x30, 0x53, 0x93, 0xDF, 0x92, 0xEC, 0xA7, 0x15, 0x8A, 0xDC, 0xF4, 0x86, 0x55, 0x4E, 0x18, 0x21,
+		0x40, 0xC4, 0xC4, 0xD5, 0xC6, 0x91, 0x8A, 0xCD, 0xE7, 0xD1, 0x4E, 0x09, 0x32, 0x17, 0xDF, 0x83,
+		0xFF, 0xF0, 0x0E, 0xCD, 0xF6, 0xC2, 0x19, 0x12, 0x75, 0x3D, 0xE9, 0x1C, 0xB8, 0xCB, 0x2B, 0x05,
+		0xAA, 0xBE, 0x16, 0xEC, 0xB6, 0x06, 0xDD, 0xC7, 0xB3, 0xAC, 0x63, 0xD1, 0x5F, 0x1A, 0x65, 0x0C,
+		0x98, 0xA9, 0xC9, 0x6F, 0x49, 0xF6, 0xD3, 0x0A, 0x45, 0x6E, 0x7A, 0xC3, 0x2A, 0x27, 0x8C, 0x10,
+		0x20, 0x62, 0xE2, 0x6A, 0xE3, 0x48, 0xC5, 0xE6, 0xF3, 0x68, 0xA7, 0x04, 0x99, 0x8B, 0xEF, 0xC1,
+		0x7F, 0x78, 0x87, 0x66, 0x7B, 0xE1, 0x0C, 0x89, 0xBA, 0x9E, 0x74, 0x0E, 0xDC, 0xE5, 0x95, 0x02,
+		0x55, 0x5F, 0x0B, 0x76, 0x5B, 0x83, 0xEE, 0xE3, 0x59, 0xD6, 0xB1, 0xE8, 0x2F, 0x8D, 0x32, 0x06,
+		0xCC, 0xD4, 0xE4, 0xB7, 0x24, 0xFB, 0x69, 0x85, 0x22, 0x37, 0xBD, 0x61, 0x95, 0x13, 0x46, 0x08,
+		0x10, 0x31, 0x71, 0xB5, 0x71, 0xA4, 0x62, 0xF3, 0x79, 0xB4, 0x53, 0x82, 0xCC, 0xC5, 0xF7, 0xE0,
+		0x3F, 0xBC, 0x43, 0xB3, 0xBD, 0x70, 0x86, 0x44, 0x5D, 0x4F, 0x3A, 0x07, 0xEE, 0xF2, 0x4A, 0x81,
+		0xAA, 0xAF, 0x05, 0xBB, 0xAD, 0x41, 0xF7, 0xF1, 0x2C, 0xEB, 0x58, 0xF4, 0x97, 0x46, 0x19, 0x03,
+		0x66, 0x6A, 0xF2, 0x5B, 0x92, 0xFD, 0xB4, 0x42, 0x91, 0x9B, 0xDE, 0xB0, 0xCA, 0x09, 0x23, 0x04,
+		0x88, 0x98, 0xB8, 0xDA, 0x38, 0x52, 0xB1, 0xF9, 0x3C, 0xDA, 0x29, 0x41, 0xE6, 0xE2, 0x7B, 0xF0,
+		0x1F, 0xDE, 0xA1, 0xD9, 0x5E, 0x38, 0x43, 0xA2, 0xAE, 0x27, 0x9D, 0x03, 0x77, 0x79, 0xA5, 0x40,
+		0xD5, 0xD7, 0x82, 0xDD, 0xD6, 0xA0, 0xFB, 0x78, 0x96, 0x75, 0x2C, 0xFA, 0x4B, 0xA3, 0x8C, 0x01,
+		0x33, 0x35, 0xF9, 0x2D, 0xC9, 0x7E, 0x5A, 0xA1, 0xC8, 0x4D, 0x6F, 0x58, 0xE5, 0x84, 0x11, 0x02,
+		0x44, 0x4C, 0x5C, 0x6D, 0x1C, 0xA9, 0xD8, 0x7C, 0x1E, 0xED, 0x94, 0x20, 0x73, 0xF1, 0x3D, 0xF8,
+		0x0F, 0xEF, 0xD0, 0x6C, 0x2F, 0x9C, 0x21, 0x51, 0xD7, 0x93, 0xCE, 0x81, 0xBB, 0xBC, 0x52, 0xA0,
+		0xEA, 0x6B, 0xC1, 0x6E, 0x6B, 0xD0, 0x7D, 0x3C, 0xCB, 0x3A, 0x16, 0xFD, 0xA5, 0x51, 0xC6, 0x80,
+		0x99, 0x9A, 0xFC, 0x96, 0x64, 0x3F, 0xAD, 0x50, 0xE4, 0xA6, 0x37, 0xAC, 0x72, 0xC2, 0x08, 0x01,
+		0x22, 0x26, 0xAE, 0x36, 0x8E, 0x54, 0x6C, 0x3E, 0x8F, 0x76, 0x4A, 0x90, 0xB9, 0xF8, 0x1E, 0xFC,
+		0x87, 0x77, 0x68, 0xB6, 0x17, 0xCE, 0x90, 0xA8, 0xEB, 0x49, 0xE7, 0xC0, 0x5D, 0x5E, 0x29, 0x50,
+		0xF5, 0xB5, 0x60, 0xB7, 0x35, 0xE8, 0x3E, 0x9E, 0x65, 0x1D, 0x8B, 0xFE, 0xD2, 0x28, 0x63, 0xC0,
+		0x4C, 0x4D, 0x7E, 0x4B, 0xB2, 0x9F, 0x56, 0x28, 0x72, 0xD3, 0x1B, 0x56, 0x39, 0x61, 0x84, 0x00,
+		0x11, 0x13, 0x57, 0x1B, 0x47, 0x2A, 0x36, 0x9F, 0x47, 0x3B, 0x25, 0xC8, 0x5C, 0x7C, 0x0F, 0xFE,
+		0xC3, 0x3B, 0x34, 0xDB, 0x0B, 0x67, 0x48, 0xD4, 0xF5, 0xA4, 0x73, 0xE0, 0x2E, 0xAF, 0x14, 0xA8,
+		0xFA, 0x5A, 0xB0, 0xDB, 0x1A, 0x74, 0x1F, 0xCF, 0xB2, 0x8E, 0x45, 0x7F, 0x69, 0x94, 0x31, 0x60,
+		0xA6, 0x26, 0xBF, 0x25, 0xD9, 0x4F, 0x2B, 0x14, 0xB9, 0xE9, 0x0D, 0xAB, 0x9C, 0x30, 0x42, 0x80,
+		0x88, 0x89, 0xAB, 0x8D, 0x23, 0x15, 0x9B, 0xCF, 0xA3, 0x9D, 0x12, 0x64, 0x2E, 0xBE, 0x07
+};
+
+void S2LP_Codec_Whiten(uint8_t* data, size_t length, size_t position) {
+	size_t index = position % S2LP_CODEC_PN9_PERIOD;
+
+	for (size_t i = 0; i < length; i++) {
+		data[i] ^= S2LP_CODEC_PN9[index];
+		index = (index + 1 == S2LP_CODEC_PN9_PERIOD ? 0 : index + 1);
+	}
+}
+
+// ===== FEC =====
+
+// Coded symbols (2 bits) for the encoder register - 3 previous bits and the current one
+static uint8_t const S2LP_CODEC_FEC_SYMBOLS[16] = { 0, 3, 1, 2, 3, 0, 2, 1, 3, 0, 2, 1, 0, 3, 1, 2 };
+
+// Coded byte (4 symbols) for 3 previous bits and the nibble
+static uint8_t const S2LP_CODEC_FEC_ENCODE[8][16] = {
+		{ 0x00, 0x03, 0x0D, 0x0E, 0x37, 0x34, 0x3A, 0x39, 0xDF, 0xDC, 0xD2, 0xD1, 0xE8, 0xEB, 0xE5, 0xE6 },
+		{ 0x7C, 0x7F, 0x71, 0x72, 0x4B, 0x48, 0x46, 0x45, 0xA3, 0xA0, 0xAE, 0xAD, 0x94, 0x97, 0x99, 0x9A },
+		{ 0xF0, 0xF3, 0xFD, 0xFE, 0xC7, 0xC4, 0xCA, 0xC9, 0x2F, 0x2C, 0x22, 0x21, 0x18, 0x1B, 0x15, 0x16 },
+		{ 0x8C, 0x8F, 0x81, 0x82, 0xBB, 0xB8, 0xB6, 0xB5, 0x53, 0x50, 0x5E, 0x5D, 0x64, 0x67, 0x69, 0x6A },
+		{ 0xC0, 0xC3, 0xCD, 0xCE, 0xF7, 0xF4, 0xFA, 0xF9, 0x1F, 0x1C, 0x12, 0x11, 0x28, 0x2B, 0x25, 0x26 },
+		{ 0xBC, 0xBF, 0xB1, 0xB2, 0x8B, 0x88, 0x86, 0x85, 0x63, 0x60, 0x6E, 0x6D, 0x54, 0x57, 0x59, 0x5A },
+		{ 0x30, 0x33, 0x3D, 0x3E, 0x07, 0x04, 0x0A, 0x09, 0xEF, 0xEC, 0xE2, 0xE1, 0xD8, 0xDB, 0xD5, 0xD6 },
+		{ 0x4C, 0x4F, 0x41, 0x42, 0x7B, 0x78, 0x76, 0x75, 0x93, 0x90, 0x9E, 0x9D, 0xA4, 0xA7, 0xA9, 0xAA }
+};
+
+// Interleaving transposes 4x4 matrix of symbols - symbol k of byte n (counting from the least
+// significant bits) goes to symbol n of byte k.
+// This table spreads the symbols of a byte into 4 bytes of a word, so the block is built with 4 lookups.
+#define S2LP_CODEC_SPREAD(index) (((uint32_t) ((index) & 0x03)) | ((uint32_t) (((index) >> 2) & 0x03) << 8) \
+		| ((uint32_t) (((index) >> 4) & 0x03) << 16) | ((uint32_t) (((index) >> 6) & 0x03) << 24))
+static uint32_t const S2LP_CODEC_FEC_SPREAD[256] = S2LP_CODEC_TABLE(S2LP_CODEC_SPREAD);
+
+// Hamming distance between 2-bit symbols (XORed)
+static uint8_t const S2LP_CODEC_FEC_DISTANCE[4] = { 0, 1, 1, 2 };
+
+// Initial path metric of states other than 0, where the encoder starts
+#define S2LP_CODEC_FEC_UNREACHABLE 64
+
+// Interleaving is it's own inverse, and works in place
+static void S2LP_Codec_Interleave(uint8_t* block) {
+	uint32_t const word = S2LP_CODEC_FEC_SPREAD[block[0]] | (S2LP_CODEC_FEC_SPREAD[block[1]] << 2)
+			| (S2LP_CODEC_FEC_SPREAD[block[2]] << 4) | (S2LP_CODEC_FEC_SPREAD[block[3]] << 6);
+
+	block[0] = (uint8_t) (word >> 0);
+	block[1] = (uint8_t) (word >> 8);
+	block[2] = (uint8_t) (word >> 16);
+	block[3] = (uint8_t) (word >> 24);
+}
+
+// Viterbi add-compare-select for a single symbol. State is made of the last 3 decoded bits,
+// decision bit of every state tells if it's predecessor had the oldest bit set.
+static uint8_t S2LP_Codec_FECStep(uint16_t* metrics, uint8_t symbol) {
+	uint16_t next[8];
+	uint16_t minimum = UINT16_MAX;
+	uint8_t decisions = 0;
+
+	for (uint8_t state = 0; state < 8; state++) {
+		uint8_t const low = state >> 1;
+		uint8_t const index = (uint8_t) ((low << 1) | (state & 1));
+		uint16_t const metric0 = metrics[low] + S2LP_CODEC_FEC_DISTANCE[symbol ^ S2LP_CODEC_FEC_SYMBOLS[index]];
+		uint16_t const metric1 = metrics[low | 4]
+				+ S2LP_CODEC_FEC_DISTANCE[symbol ^ S2LP_CODEC_FEC_SYMBOLS[index | 8]];
+
+		if (metric1 < metric0) {
+			next[state] = metric1;
+			decisions |= (uint8_t) (1 << state);
+		} else {
+			next[state] = metric0;
+		}
+
+		minimum = (next[state] < minimum ? next[state] : minimum);
+	}
+
+	// Only the differences matter, keep the metrics small
+	for (uint8_t state = 0; state < 8; state++) {
+		metrics[state] = next[state] - minimum;
+	}
+
+	return decisions;
+}
+
+// Trace back from the best state after `steps` steps down to `first` step, and store the bits
+// of complete bytes below `limit` byte.
+static void S2LP_Codec_FECTraceback(uint16_t const* metrics, uint8_t const* decisions, size_t steps, size_t first,
+		size_t limit, uint8_t* output) {
+	uint8_t state = 0;
+	for (uint8_t i = 1; i < 8; i++) {
+		state = (metrics[i] < metrics[state] ? i : state);
+	}
+
+	for (size_t step = steps; step > first; step--) {
+		size_t const bit = step - 1;
+		if (bit / 8 < limit) {
+			uint8_t const mask = (uint8_t) (0x80 >> (bit % 8));
+			output[bit / 8] = (uint8_t) ((state & 1) ? (output[bit / 8] | mask) : (output[bit / 8] & ~mask));
+		}
+
+		uint8_t const oldest = (decisions[bit % S2LP_CODEC_FEC_WINDOW] >> state) & 1;
+		state = (uint8_t) ((state >> 1) | (oldest << 2));
+	}
+}
+
+size_t S2LP_Codec_FECEncode(uint8_t const* input, size_t length, uint8_t* output) {
+	size_t const total = length + (length % 2 == 0 ? 2 : 1);
+	uint8_t previous = 0;
+
+	for (size_t i = 0; i < total; i++) {
+		uint8_t const byte = (i < length ? input[i] : S2LP_CODEC_FEC_TERMINATOR);
+		output[2 * i] = S2LP_CODEC_FEC_ENCODE[previous][byte >> 4];
+		output[2 * i + 1] = S2LP_CODEC_FEC_ENCODE[(byte >> 4) & 0x07][byte & 0x0F];
+		previous = byte & 0x07;
+	}
+
+	for (size_t i = 0; i < 2 * total; i += 4) {
+		S2LP_Codec_Interleave(output + i);
+	}
+
+	return 2 * total;
+}
+
+size_t S2LP_Codec_FECDecode(uint8_t const* input, size_t length, uint8_t* output) {
+	if (length == 0 || length % 4 != 0) {
+		return 0;
+	}
+
+	uint16_t metrics[8] = { 0 };
+	for (uint8_t state = 1; state < 8; state++) {
+		metrics[state] = S2LP_CODEC_FEC_UNREACHABLE;
+	}
+
+	uint8_t decisions[S2LP_CODEC_FEC_WINDOW];
+	size_t steps = 0;
+	size_t decoded = 0;
+
+	for (size_t i = 0; i < length; i += 4) {
+		uint8_t block[4];
+		memcpy(block, input + i, 4);
+		S2LP_Codec_Interleave(block);
+
+		for (uint8_t n = 0; n < 4; n++) {
+			for (uint8_t shift = 8; shift > 0; shift -= 2) {
+				uint8_t const symbol = (block[n] >> (shift - 2)) & 0x03;
+				decisions[steps % S2LP_CODEC_FEC_WINDOW] = S2LP_Codec_FECStep(metrics, symbol);
+				steps++;
+			}
+		}
+
+		// Make room for the next block, deciding the oldest bytes
+		if (steps - 8 * decoded > S2LP_CODEC_FEC_WINDOW - 16) {
+			size_t const limit = (steps - (S2LP_CODEC_FEC_WINDOW - 16)) / 8;
+			S2LP_Codec_FECTraceback(metrics, decisions, steps, 8 * decoded, limit, output);
+			decoded = limit;
+		}
+	}
+
+	S2LP_Codec_FECTraceback(metrics, decisions, steps, 8 * decoded, steps / 8, output);
+	return steps / 8;
+}
+
+// ===== Manchester =====
+
+// Chips of the nibble
+static uint8_t const S2LP_CODEC_MANCHESTER_ENCODE[16] = {
+		0x55, 0x56, 0x59, 0x5A, 0x65, 0x66, 0x69, 0x6A, 0x95, 0x96, 0x99, 0x9A, 0xA5, 0xA6, 0xA9, 0xAA
+};
+
+// Nibble of the chips, or 0xFF if they are invalid - every chip pair has to be 01 or 10,
+// and the bit is the first chip
+#define S2LP_CODEC_MANCHESTER_VALID(index) (((((index) >> 1) ^ (index)) & 0x55) == 0x55)
+#define S2LP_CODEC_MANCHESTER_NIBBLE(index) ((((index) >> 1) & 0x01) | (((index) >> 2) & 0x02) \
+		| (((index) >> 3) & 0x04) | (((index) >> 4) & 0x08))
+#define S2LP_CODEC_MANCHESTER_DECODE_ENTRY(index) (S2LP_CODEC_MANCHESTER_VALID(index) ? \
+		S2LP_CODEC_MANCHESTER_NIBBLE(index) : 0xFF)
+static uint8_t const S2LP_CODEC_MANCHESTER_DECODE[256] = S2LP_CODEC_TABLE(S2LP_CODEC_MANCHESTER_DECODE_ENTRY);
+
+size_t S2LP_Codec_ManchesterEncode(uint8_t const* input, size_t length, uint8_t* output) {
+	for (size_t i = 0; i < length; i++) {
+		output[2 * i] = S2LP_CODEC_MANCHESTER_ENCODE[input[i] >> 4];
+		output[2 * i + 1] = S2LP_CODEC_MANCHESTER_ENCODE[input[i] & 0x0F];
+	}
+
+	return 2 * length;
+}
+
+bool S2LP_Codec_ManchesterDecode(uint8_t const* input, size_t length, uint8_t* output) {
+	uint8_t invalid = 0;
+
+	for (size_t i = 0; i < length / 2; i++) {
+		uint8_t const high = S2LP_CODEC_MANCHESTER_DECODE[input[2 * i]];
+		uint8_t const low = S2LP_CODEC_MANCHESTER_DECODE[input[2 * i + 1]];
+		invalid |= (uint8_t) (high | low);
+		output[i] = (uint8_t) ((high << 4) | (low & 0x0F));
+	}
+
+	return (invalid & 0xF0) == 0 && length % 2 == 0;
+}
+
+// ===== 3-out-of-6 =====
+
+static uint8_t const S2LP_CODEC_3OF6_ENCODE[16] = {
+		0x16, 0x0D, 0x0E, 0x0B, 0x1C, 0x19, 0x1A, 0x13, 0x2C, 0x25, 0x26, 0x23, 0x34, 0x31, 0x32, 0x29
+};
+
+// Nibble of the code, or 0xFF if it's invalid
+static uint8_t const S2LP_CODEC_3OF6_DECODE[64] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xFF, 0x01, 0x02, 0xFF,
+		0xFF, 0xFF, 0xFF, 0x07, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0x05, 0x06, 0xFF, 0x04, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0x0B, 0xFF, 0x09, 0x0A, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF, 0x08, 0xFF, 0xFF, 0xFF,
+		0xFF, 0x0D, 0x0E, 0xFF, 0x0C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+size_t S2LP_Codec_3of6Encode(uint8_t const* input, size_t length, uint8_t* output) {
+	uint32_t bits = 0;
+	uint8_t count = 0;
+	size_t written = 0;
+
+	for (size_t i = 0; i < length; i++) {
+		bits = (bits << 12) | ((uint32_t) S2LP_CODEC_3OF6_ENCODE[input[i] >> 4] << 6)
+				| S2LP_CODEC_3OF6_ENCODE[input[i] & 0x0F];
+		count += 12;
+
+		while (count >= 8) {
+			count -= 8;
+			output[written++] = (uint8_t) (bits >> count);
+		}
+	}
+
+	if (count > 0) {
+		output[written++] = (uint8_t) (bits << (8 - count));
+	}
+
+	return written;
+}
+
+bool S2LP_Codec_3of6Decode(uint8_t const* input, size_t length, uint8_t* output) {
+	uint32_t bits = 0;
+	uint8_t count = 0;
+	size_t read = 0;
+	uint8_t invalid = 0;
+
+	for (size_t i = 0; i < 2 * length / 3; i++) {
+		while (count < 12) {
+			bits = (bits << 8) | input[read++];
+			count += 8;
+		}
+
+		count -= 12;
+		uint8_t const high = S2LP_CODEC_3OF6_DECODE[(bits >> (count + 6)) & 0x3F];
+		uint8_t const low = S2LP_CODEC_3OF6_DECODE[(bits >> count) & 0x3F];
+		invalid |= (uint8_t) (high | low);
+		output[i] = (uint8_t) ((high << 4) | (low & 0x0F));
+	}
+
+	return (invalid & 0xF0) == 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * s2lp_codec.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_CODEC_H_
+#define S2LP_S2LP_CODEC_H_
+
+// Software versions of S2-LP data coding (S2LP_PCKT_SetDataCoding) and whitening
+// (S2LP_PCKT_SetDataWhiteningState) - for direct FIFO/GPIO modes, or decoding raw captures on the host.
+// On TX, data is whitened first and then coded. On RX, it's decoded first and then de-whitened.
+// * whitening - XOR with PN9 sequence (x^9 + x^5 + 1, all ones seed, LSB first), restarted with every
+//   frame. It's symmetric, the same function whitens and de-whitens.
+// * FEC - convolutional code with rate 1/2 and constraint length 4, terminated with trellis terminator
+//   (1 or 2 bytes of S2LP_CODEC_FEC_TERMINATOR, so the coded length is a multiple of 4), and interleaved
+//   in 4-byte blocks. Decoding is hard-decision Viterbi, it corrects scattered bit errors.
+// * Manchester - every bit is sent as 2 chips, 0 as 01 and 1 as 10
+// * 3-out-of-6 - every nibble is sent as 6-bit code with 3 bits set (high nibble first)
+// Coding works on whole bytes with lookup tables (4 bits of input per lookup at least).
+// Decoders of Manchester and 3-out-of-6 report invalid codes, but decode as much as they can.
+// Usage:
+//   S2LP_Codec_Whiten(payload, length, 0);
+//   size_t const coded_length = S2LP_Codec_FECEncode(payload, length, coded);
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Byte appended as trellis terminator by FEC encoder
+#define S2LP_CODEC_FEC_TERMINATOR 0x0B
+// Amount of trellis steps (bits) kept by FEC decoder - bits are decided at least
+// S2LP_CODEC_FEC_WINDOW - 16 steps after they are received. Has to be a multiple of 8.
+#define S2LP_CODEC_FEC_WINDOW 64
+
+// Length of coded data, for output buffers
+#define S2LP_CODEC_FEC_ENCODED_LENGTH(length) (2 * ((length) + 2 - ((length) % 2)))
+#define S2LP_CODEC_MANCHESTER_ENCODED_LENGTH(length) (2 * (length))
+#define S2LP_CODEC_3OF6_ENCODED_LENGTH(length) ((3 * (length) + 1) / 2)
+
+// XOR the data with PN9 sequence, starting at `position` of the frame (so long frames
+// can be processed in parts)
+void S2LP_Codec_Whiten(uint8_t* data, size_t length, size_t position);
+
+// Encode the data with the terminator, returns S2LP_CODEC_FEC_ENCODED_LENGTH(length)
+size_t S2LP_Codec_FECEncode(uint8_t const* input, size_t length, uint8_t* output);
+// Decode the coded data (length has to be a multiple of 4), returns the decoded length - half
+// of the coded one, including the terminator. Returns 0 if the length is invalid.
+size_t S2LP_Codec_FECDecode(uint8_t const* input, size_t length, uint8_t* output);
+
+// Returns the coded length
+size_t S2LP_Codec_ManchesterEncode(uint8_t const* input, size_t length, uint8_t* output);
+// Decode length / 2 bytes. Returns false if there were invalid chips (00 or 11), or the length is odd.
+bool S2LP_Codec_ManchesterDecode(uint8_t const* input, size_t length, uint8_t* output);
+
+// Returns the coded length. The last byte is padded with zeros, if the length is odd.
+size_t S2LP_Codec_3of6Encode(uint8_t const* input, size_t length, uint8_t* output);
+// Decode 2 * length / 3 bytes. Returns false if there were invalid codes.
+bool S2LP_Codec_3of6Decode(uint8_t const* input, size_t length, uint8_t* output);
+
+#endif /* S2LP_S2LP_CODEC_H_ */
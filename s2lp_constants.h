@@ -24,6 +24,37 @@
 #define S2LP_FDEV_MANTISSA_MIN 0
 #define S2LP_FDEV_MANTISSA_MAX 255
 
+// Synthesizer bands, in Hz (see table 1 in datasheet)
+#define S2LP_SYNTH_HIGH_BAND_MIN 826000000
+#define S2LP_SYNTH_HIGH_BAND_MAX 1055000000
+#define S2LP_SYNTH_MID_BAND_MIN 413000000
+#define S2LP_SYNTH_MID_BAND_MAX 527000000
+
+// Channel filter words, as uint16_t[M][E] initializer (used by s2lp_rx.c and s2lp_static_config.hpp).
+// Bandwidths in 100Hz units, for 26MHz digital clock (they scale linearly with it).
+// Values decrease with both mantissa and exponent, and every exponent range is below the
+// previous one, so the table is sorted (ascending) from E = 9, M = 8 to E = 0, M = 0.
+#define S2LP_CHANNEL_FILTER_WORDS_M 9
+#define S2LP_CHANNEL_FILTER_WORDS_E 10
+// @formatter:off
+#define S2LP_CHANNEL_FILTER_WORDS_TABLE \
+        { \
+        /* E =          0     1     2     3     4     5     6     7     8     9 */ \
+        /* M = 0 */ { 8001, 4509, 2247, 1123,  561,  280,  140,   70,   35,   18 }, \
+        /* M = 1 */ { 7951, 4259, 2124, 1062,  530,  265,  133,   66,   33,   17 }, \
+        /* M = 2 */ { 7684, 4032, 2011, 1005,  502,  251,  126,   63,   31,   16 }, \
+        /* M = 3 */ { 7368, 3808, 1900,  950,  474,  237,  119,   59,   30,   15 }, \
+        /* M = 4 */ { 7051, 3621, 1807,  903,  451,  226,  113,   56,   28,   14 }, \
+        /* M = 5 */ { 6709, 3417, 1706,  853,  426,  213,  106,   53,   27,   13 }, \
+        /* M = 6 */ { 6423, 3254, 1624,  812,  406,  203,  101,   51,   25,   13 }, \
+        /* M = 7 */ { 5867, 2945, 1471,  735,  367,  184,   92,   46,   23,   12 }, \
+        /* M = 8 */ { 5414, 2703, 1350,  675,  337,  169,   84,   42,   21,   11 }, \
+        }
+// @formatter:on
+
+// Size of TX and RX FIFOs, in bytes
+#define S2LP_FIFO_SIZE 128
+
 typedef enum S2LP_Pins_t {
 	S2LP_PIN_GPIO_0, S2LP_PIN_GPIO_1, S2LP_PIN_GPIO_2, S2LP_PIN_GPIO_3, S2LP_PIN_SDN, S2LP_PIN_CSN,
 } S2LP_Pin;
@@ -104,6 +135,10 @@ typedef enum S2LP_AFC_Mode_t {
 	S2LP_AFC_SLICER_CORRECTION = 0, S2LP_AFC_2ND_IF_CORRECTION = 1
 } S2LP_AFC_Mode;
 
+typedef enum S2LP_ClockRecoveryAlgorithm_t {
+	S2LP_CLOCK_RECOVERY_DLL = 0, S2LP_CLOCK_RECOVERY_PLL = 1
+} S2LP_ClockRecoveryAlgorithm;
+
 typedef enum S2LP_AGC_Low_Threshold_t {
 	S2LP_AGC_LOW_THRESHOLD_0 = 0, S2LP_AGC_LOW_THRESHOLD_1 = 1
 } S2LP_AGC_Low_Threshold;
@@ -0,0 +1,241 @@
+/*
+ * s2lp_crc.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_crc.h"
+
+#ifdef S2LP_CRC_SLICE_BY_4
+#define S2LP_CRC_SLICES 4
+#else
+#define S2LP_CRC_SLICES 1
+#endif
+
+// Table generation - CRC is linear, so every entry is a XOR of the entries for set bits of it's index.
+// Tables are given by these 8 entries (for indices 0x01, 0x02, ... 0x80). Table k holds the CRC
+// of the byte followed by k zero bytes, so 4 bytes can be looked up independently.
+
+#define S2LP_CRC_BIT(index, bit, value) ((((index) >> (bit)) & 1u) ? (value) : 0u)
+#define S2LP_CRC_ENTRY(index, v0, v1, v2, v3, v4, v5, v6, v7) (S2LP_CRC_BIT(index, 0, v0) \
+		^ S2LP_CRC_BIT(index, 1, v1) ^ S2LP_CRC_BIT(index, 2, v2) ^ S2LP_CRC_BIT(index, 3, v3) \
+		^ S2LP_CRC_BIT(index, 4, v4) ^ S2LP_CRC_BIT(index, 5, v5) ^ S2LP_CRC_BIT(index, 6, v6) \
+		^ S2LP_CRC_BIT(index, 7, v7))
+#define S2LP_CRC_ROW(index, ...) S2LP_CRC_ENTRY((index) + 0, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 1, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 2, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 3, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 4, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 5, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 6, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 7, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 8, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 9, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 10, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 11, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 12, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 13, __VA_ARGS__), S2LP_CRC_ENTRY((index) + 14, __VA_ARGS__), \
+		S2LP_CRC_ENTRY((index) + 15, __VA_ARGS__)
+#define S2LP_CRC_TABLE(...) { S2LP_CRC_ROW(0x00, __VA_ARGS__), S2LP_CRC_ROW(0x10, __VA_ARGS__), \
+		S2LP_CRC_ROW(0x20, __VA_ARGS__), S2LP_CRC_ROW(0x30, __VA_ARGS__), S2LP_CRC_ROW(0x40, __VA_ARGS__), \
+		S2LP_CRC_ROW(0x50, __VA_ARGS__), S2LP_CRC_ROW(0x60, __VA_ARGS__), S2LP_CRC_ROW(0x70, __VA_ARGS__), \
+		S2LP_CRC_ROW(0x80, __VA_ARGS__), S2LP_CRC_ROW(0x90, __VA_ARGS__), S2LP_CRC_ROW(0xA0, __VA_ARGS__), \
+		S2LP_CRC_ROW(0xB0, __VA_ARGS__), S2LP_CRC_ROW(0xC0, __VA_ARGS__), S2LP_CRC_ROW(0xD0, __VA_ARGS__), \
+		S2LP_CRC_ROW(0xE0, __VA_ARGS__), S2LP_CRC_ROW(0xF0, __VA_ARGS__) }
+
+static uint8_t const S2LP_CRC_TABLES_07[S2LP_CRC_SLICES][256] = {
+		S2LP_CRC_TABLE(0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xC7, 0x89),
+#ifdef S2LP_CRC_SLICE_BY_4
+		S2LP_CRC_TABLE(0x15, 0x2A, 0x54, 0xA8, 0x57, 0xAE, 0x5B, 0xB6),
+		S2LP_CRC_TABLE(0x6B, 0xD6, 0xAB, 0x51, 0xA2, 0x43, 0x86, 0x0B),
+		S2LP_CRC_TABLE(0x16, 0x2C, 0x58, 0xB0, 0x67, 0xCE, 0x9B, 0x31),
+#endif
+};
+
+static uint16_t const S2LP_CRC_TABLES_8005[S2LP_CRC_SLICES][256] = {
+		S2LP_CRC_TABLE(0x8005, 0x800F, 0x801B, 0x8033, 0x8063, 0x80C3, 0x8183, 0x8303),
+#ifdef S2LP_CRC_SLICE_BY_4
+		S2LP_CRC_TABLE(0x8603, 0x8C03, 0x9803, 0xB003, 0xE003, 0x4003, 0x8006, 0x8009),
+		S2LP_CRC_TABLE(0x8017, 0x802B, 0x8053, 0x80A3, 0x8143, 0x8283, 0x8503, 0x8A03),
+		S2LP_CRC_TABLE(0x9403, 0xA803, 0xD003, 0x2003, 0x4006, 0x800C, 0x801D, 0x803F),
+#endif
+};
+
+static uint16_t const S2LP_CRC_TABLES_1021[S2LP_CRC_SLICES][256] = {
+		S2LP_CRC_TABLE(0x1021, 0x2042, 0x4084, 0x8108, 0x1231, 0x2462, 0x48C4, 0x9188),
+#ifdef S2LP_CRC_SLICE_BY_4
+		S2LP_CRC_TABLE(0x3331, 0x6662, 0xCCC4, 0x89A9, 0x0373, 0x06E6, 0x0DCC, 0x1B98),
+		S2LP_CRC_TABLE(0x3730, 0x6E60, 0xDCC0, 0xA9A1, 0x4363, 0x86C6, 0x1DAD, 0x3B5A),
+		S2LP_CRC_TABLE(0x76B4, 0xED68, 0xCAF1, 0x85C3, 0x1BA7, 0x374E, 0x6E9C, 0xDD38),
+#endif
+};
+
+static uint32_t const S2LP_CRC_TABLES_864CFB[S2LP_CRC_SLICES][256] = {
+		S2LP_CRC_TABLE(0x864CFB, 0x8AD50D, 0x93E6E1, 0xA18139, 0xC54E89, 0x0CD1E9, 0x19A3D2, 0x3347A4),
+#ifdef S2LP_CRC_SLICE_BY_4
+		S2LP_CRC_TABLE(0x668F48, 0xCD1E90, 0x1C71DB, 0x38E3B6, 0x71C76C, 0xE38ED8, 0x41514B, 0x82A296),
+		S2LP_CRC_TABLE(0x8309D7, 0x805F55, 0x86F251, 0x8BA859, 0x911C49, 0xA47469, 0xCEA429, 0x1B04A9),
+		S2LP_CRC_TABLE(0x360952, 0x6C12A4, 0xD82548, 0x36066B, 0x6C0CD6, 0xD819AC, 0x367FA3, 0x6CFF46),
+#endif
+};
+
+static uint32_t const S2LP_CRC_TABLES_04C011BB7[S2LP_CRC_SLICES][256] = {
+		S2LP_CRC_TABLE(0x4C011BB7, 0x9802376E, 0x7C05756B, 0xF80AEAD6, 0xBC14CE1B, 0x34288781, 0x68510F02,
+				0xD0A21E04),
+#ifdef S2LP_CRC_SLICE_BY_4
+		S2LP_CRC_TABLE(0xED4527BF, 0x968B54C9, 0x6117B225, 0xC22F644A, 0xC85FD323, 0xDCBEBDF1, 0xF57C6055,
+				0xA6F9DB1D),
+		S2LP_CRC_TABLE(0x01F2AD8D, 0x03E55B1A, 0x07CAB634, 0x0F956C68, 0x1F2AD8D0, 0x3E55B1A0, 0x7CAB6340,
+				0xF956C680),
+		S2LP_CRC_TABLE(0xBEAC96B7, 0x315836D9, 0x62B06DB2, 0xC560DB64, 0xC6C0AD7F, 0xC1804149, 0xCF019925,
+				0xD20229FD),
+#endif
+};
+
+// Slice-by-4 steps - the CRC is XORed with the first data bytes, and every byte of the result
+// (and the data bytes after the CRC) is looked up in the table matching it's distance from the end
+
+static uint32_t S2LP_CRC_Update8(uint8_t const (*tables)[256], uint32_t crc, uint8_t const* data,
+		size_t length) {
+	uint8_t value = (uint8_t) crc;
+
+#ifdef S2LP_CRC_SLICE_BY_4
+	for (; length >= 4; length -= 4, data += 4) {
+		value = tables[3][value ^ data[0]] ^ tables[2][data[1]] ^ tables[1][data[2]] ^ tables[0][data[3]];
+	}
+#endif
+
+	for (; length > 0; length--, data++) {
+		value = tables[0][value ^ *data];
+	}
+
+	return value;
+}
+
+static uint32_t S2LP_CRC_Update16(uint16_t const (*tables)[256], uint32_t crc, uint8_t const* data,
+		size_t length) {
+	uint16_t value = (uint16_t) crc;
+
+#ifdef S2LP_CRC_SLICE_BY_4
+	for (; length >= 4; length -= 4, data += 4) {
+		uint16_t const head = (uint16_t) (value ^ ((data[0] << 8) | data[1]));
+		value = tables[3][head >> 8] ^ tables[2][head & 0xFF] ^ tables[1][data[2]] ^ tables[0][data[3]];
+	}
+#endif
+
+	for (; length > 0; length--, data++) {
+		value = (uint16_t) (tables[0][(value >> 8) ^ *data] ^ (value << 8));
+	}
+
+	return value;
+}
+
+static uint32_t S2LP_CRC_Update24(uint32_t const (*tables)[256], uint32_t crc, uint8_t const* data,
+		size_t length) {
+	uint32_t value = crc & 0xFFFFFF;
+
+#ifdef S2LP_CRC_SLICE_BY_4
+	for (; length >= 4; length -= 4, data += 4) {
+		uint32_t const head = value ^ (((uint32_t) data[0] << 16) | ((uint32_t) data[1] << 8) | data[2]);
+		value = tables[3][head >> 16] ^ tables[2][(head >> 8) & 0xFF] ^ tables[1][head & 0xFF]
+				^ tables[0][data[3]];
+	}
+#endif
+
+	for (; length > 0; length--, data++) {
+		value = tables[0][(value >> 16) ^ *data] ^ ((value << 8) & 0xFFFFFF);
+	}
+
+	return value;
+}
+
+static uint32_t S2LP_CRC_Update32(uint32_t const (*tables)[256], uint32_t crc, uint8_t const* data,
+		size_t length) {
+	uint32_t value = crc;
+
+#ifdef S2LP_CRC_SLICE_BY_4
+	for (; length >= 4; length -= 4, data += 4) {
+		uint32_t const head = value ^ (((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16)
+				| ((uint32_t) data[2] << 8) | data[3]);
+		value = tables[3][head >> 24] ^ tables[2][(head >> 16) & 0xFF] ^ tables[1][(head >> 8) & 0xFF]
+				^ tables[0][head & 0xFF];
+	}
+#endif
+
+	for (; length > 0; length--, data++) {
+		value = tables[0][(value >> 24) ^ *data] ^ (value << 8);
+	}
+
+	return value;
+}
+
+uint8_t S2LP_CRC_GetLength(S2LP_CRC_Mode mode) {
+	switch (mode) {
+		case S2LP_CRC_POLY_07:
+			return 1;
+		case S2LP_CRC_POLY_8005:
+		case S2LP_CRC_POLY_1021:
+			return 2;
+		case S2LP_CRC_POLY_864CFB:
+			return 3;
+		case S2LP_CRC_POLY_04C011BB7:
+			return 4;
+		case S2LP_CRC_NO_CRC:
+		default:
+			return 0;
+	}
+}
+
+uint32_t S2LP_CRC_GetInitialValue(S2LP_CRC_Mode mode) {
+	uint8_t const length = S2LP_CRC_GetLength(mode);
+	if (length == 0) {
+		return 0;
+	}
+
+	return 0xFFFFFFFFul >> (32 - 8 * length);
+}
+
+uint32_t S2LP_CRC_Update(S2LP_CRC_Mode mode, uint32_t crc, uint8_t const* data, size_t length) {
+	switch (mode) {
+		case S2LP_CRC_POLY_07:
+			return S2LP_CRC_Update8(S2LP_CRC_TABLES_07, crc, data, length);
+		case S2LP_CRC_POLY_8005:
+			return S2LP_CRC_Update16(S2LP_CRC_TABLES_8005, crc, data, length);
+		case S2LP_CRC_POLY_1021:
+			return S2LP_CRC_Update16(S2LP_CRC_TABLES_1021, crc, data, length);
+		case S2LP_CRC_POLY_864CFB:
+			return S2LP_CRC_Update24(S2LP_CRC_TABLES_864CFB, crc, data, length);
+		case S2LP_CRC_POLY_04C011BB7:
+			return S2LP_CRC_Update32(S2LP_CRC_TABLES_04C011BB7, crc, data, length);
+		case S2LP_CRC_NO_CRC:
+		default:
+			return 0;
+	}
+}
+
+uint32_t S2LP_CRC_Compute(S2LP_CRC_Mode mode, uint8_t const* data, size_t length) {
+	return S2LP_CRC_Update(mode, S2LP_CRC_GetInitialValue(mode), data, length);
+}
+
+size_t S2LP_CRC_Write(S2LP_CRC_Mode mode, uint32_t crc, uint8_t* output) {
+	uint8_t const length = S2LP_CRC_GetLength(mode);
+
+	for (uint8_t i = 0; i < length; i++) {
+		output[i] = (uint8_t) (crc >> (8 * (length - 1 - i)));
+	}
+
+	return length;
+}
+
+bool S2LP_CRC_Check(S2LP_CRC_Mode mode, uint8_t const* frame, size_t length) {
+	uint8_t const crc_length = S2LP_CRC_GetLength(mode);
+	if (length < crc_length) {
+		return false;
+	}
+
+	uint8_t expected[S2LP_CRC_MAX_LENGTH] = { 0 };
+	S2LP_CRC_Write(mode, S2LP_CRC_Compute(mode, frame, length - crc_length), expected);
+
+	for (uint8_t i = 0; i < crc_length; i++) {
+		if (expected[i] != frame[length - crc_length + i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * s2lp_crc.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_CRC_H_
+#define S2LP_S2LP_CRC_H_
+
+// Software CRC engine, computing the same CRCs as S2-LP packet handler (S2LP_CRC_Mode) - for frames
+// sent in direct FIFO mode (S2LP_TX_SOURCE_DIRECT_FIFO), or validating captured frames.
+// CRCs are computed like S2-LP does: MSB first, initial value with all bits set, no final XOR.
+// CRC is sent after the payload, MSB first (S2LP_CRC_Write). In BASIC packets, it covers the length
+// field, address and payload. 32-bit polynomial is 0x04C011BB7, as in the datasheet (and
+// S2LP_Utils_CRCToInt).
+// Lookup tables are generated at compile time, as constants. With S2LP_CRC_SLICE_BY_4, data is
+// processed 4 bytes at a time with 4 tables per polynomial (13kB of tables), otherwise
+// byte by byte with a single table (3.3kB).
+// Usage:
+//   uint32_t const crc = S2LP_CRC_Compute(S2LP_CRC_POLY_8005, frame, length);
+//   length += S2LP_CRC_Write(S2LP_CRC_POLY_8005, crc, frame + length);
+
+#include "s2lp_constants.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Define S2LP_CRC_SLICE_BY_4 to process 4 bytes per step, at the cost of 4 times bigger tables.
+// Defining S2LP_CRC_SLICE_BY_1 (e.g. in compiler flags) keeps it disabled, for single tables.
+#ifndef S2LP_CRC_SLICE_BY_1
+#define S2LP_CRC_SLICE_BY_4 1
+#endif
+
+// The longest CRC, in bytes
+#define S2LP_CRC_MAX_LENGTH 4
+
+// Length of CRC in bytes, 0 for S2LP_CRC_NO_CRC
+uint8_t S2LP_CRC_GetLength(S2LP_CRC_Mode mode);
+// Value the CRC starts from
+uint32_t S2LP_CRC_GetInitialValue(S2LP_CRC_Mode mode);
+
+// Continue the CRC calculation over the data. Start from S2LP_CRC_GetInitialValue.
+uint32_t S2LP_CRC_Update(S2LP_CRC_Mode mode, uint32_t crc, uint8_t const* data, size_t length);
+// Calculate the CRC of the data
+uint32_t S2LP_CRC_Compute(S2LP_CRC_Mode mode, uint8_t const* data, size_t length);
+
+// Store the CRC in the order it's sent over the air, returns the amount of bytes written
+size_t S2LP_CRC_Write(S2LP_CRC_Mode mode, uint32_t crc, uint8_t* output);
+// Check the frame ending with CRC. Returns false if it's shorter than the CRC.
+bool S2LP_CRC_Check(S2LP_CRC_Mode mode, uint8_t const* frame, size_t length);
+
+#endif /* S2LP_S2LP_CRC_H_ */
@@ -0,0 +1,828 @@
+/*
+ * s2lp_emulator.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_emulator.h"
+#include "s2lp_registers.h"
+#include "s2lp_rf_calc.h"
+#include "bit_helpers.h"
+
+#include <string.h>
+
+// SPI header bytes, see s2lp_mcu_interface.c
+#define S2LP_EMULATOR_HEADER_WRITE 0b00000000
+#define S2LP_EMULATOR_HEADER_READ 0b00000001
+#define S2LP_EMULATOR_HEADER_COMMAND 0b10000000
+
+// ===== FIFO helpers =====
+
+static void S2LP_Emulator_FIFOClear(S2LP_Emulator_FIFO* fifo) {
+	fifo->head = 0;
+	fifo->count = 0;
+}
+
+static bool S2LP_Emulator_FIFOPush(S2LP_Emulator_FIFO* fifo, uint8_t value) {
+	if (fifo->count >= S2LP_EMULATOR_FIFO_SIZE) {
+		return false;
+	}
+
+	fifo->data[(fifo->head + fifo->count) % S2LP_EMULATOR_FIFO_SIZE] = value;
+	fifo->count++;
+	return true;
+}
+
+static bool S2LP_Emulator_FIFOPop(S2LP_Emulator_FIFO* fifo, uint8_t* value) {
+	if (fifo->count == 0) {
+		return false;
+	}
+
+	*value = fifo->data[fifo->head];
+	fifo->head = (fifo->head + 1) % S2LP_EMULATOR_FIFO_SIZE;
+	fifo->count--;
+	return true;
+}
+
+// ===== Chip state helpers =====
+
+static uint8_t S2LP_Emulator_Threshold(S2LP_Emulator const* emulator, S2LP_Register reg) {
+	return (uint8_t) GETBITS(emulator->registers[reg], 0b1111111, 0);
+}
+
+static void S2LP_Emulator_UpdateStatus(S2LP_Emulator* emulator) {
+	uint8_t state0 = 0;
+	SETBIT(state0, 0); // XO is always on
+	SETBITS(state0, (uint8_t) emulator->state, 0b1111111, 1);
+	emulator->registers[S2LP_REG_MC_STATE0] = state0;
+
+	uint8_t state1 = emulator->registers[S2LP_REG_MC_STATE1];
+	CLEARBIT(state1, 1);
+	CLEARBIT(state1, 2);
+	if (emulator->rx_fifo.count == 0) {
+		SETBIT(state1, 1);
+	}
+	if (emulator->tx_fifo.count == S2LP_EMULATOR_FIFO_SIZE) {
+		SETBIT(state1, 2);
+	}
+	emulator->registers[S2LP_REG_MC_STATE1] = state1;
+
+	emulator->registers[S2LP_REG_TX_FIFO_STATUS] = emulator->tx_fifo.count;
+	emulator->registers[S2LP_REG_RX_FIFO_STATUS] = emulator->rx_fifo.count;
+}
+
+static uint8_t S2LP_Emulator_CRCLength(S2LP_Emulator const* emulator) {
+	switch (GETBITS(emulator->registers[S2LP_REG_PCKTCTRL1], 0b111, 5)) {
+		case S2LP_CRC_POLY_07:
+			return 1;
+		case S2LP_CRC_POLY_8005:
+		case S2LP_CRC_POLY_1021:
+			return 2;
+		case S2LP_CRC_POLY_864CFB:
+			return 3;
+		case S2LP_CRC_POLY_04C011BB7:
+			return 4;
+		case S2LP_CRC_NO_CRC:
+		default:
+			return 0;
+	}
+}
+
+// Preamble, sync word, length and address fields - sent before the payload
+static uint32_t S2LP_Emulator_HeaderBits(S2LP_Emulator const* emulator) {
+	uint8_t const* regs = emulator->registers;
+	uint32_t const preamble_pairs = (GETBITS(regs[S2LP_REG_PCKTCTRL6], 0b11, 0) << 8) | regs[S2LP_REG_PCKTCTRL5];
+	uint32_t const sync_bits = GETBITS(regs[S2LP_REG_PCKTCTRL6], 0b111111, 2);
+	uint32_t field_bytes = 0;
+
+	if (GETBIT(regs[S2LP_REG_PCKTCTRL2], 0)) {
+		field_bytes += (GETBIT(regs[S2LP_REG_PCKTCTRL4], 7) ? 2 : 1);
+	}
+	if (GETBIT(regs[S2LP_REG_PCKTCTRL4], 3)) {
+		field_bytes += 1;
+	}
+
+	return (preamble_pairs * 2) + sync_bits + (field_bytes * 8);
+}
+
+static void S2LP_Emulator_ProcessRadio(S2LP_Emulator* emulator);
+
+// ===== Air helpers =====
+
+static bool S2LP_Emulator_CanHear(S2LP_Emulator const* receiver, S2LP_Emulator const* transmitter) {
+	return receiver != transmitter && receiver->state == S2LP_STATE_RX && !receiver->air_active
+			&& receiver->rx_source == NULL
+			&& S2LP_Emulator_GetCarrierFrequency(receiver) == S2LP_Emulator_GetCarrierFrequency(transmitter)
+			&& S2LP_Emulator_GetByteTime(receiver) == S2LP_Emulator_GetByteTime(transmitter);
+}
+
+// Transmission started - chips listening on the same channel start receiving it
+static void S2LP_Emulator_AirStart(S2LP_Emulator* transmitter) {
+	if (transmitter->air == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < transmitter->air->chip_count; i++) {
+		S2LP_Emulator* const chip = transmitter->air->chips[i];
+		if (S2LP_Emulator_CanHear(chip, transmitter)) {
+			chip->rx_source = transmitter;
+			S2LP_Emulator_RaiseInterrupt(chip, S2LP_INT_VALID_PREAMBLE_DETECTED);
+			S2LP_Emulator_RaiseInterrupt(chip, S2LP_INT_SYNC_WORD_DETECTED);
+		}
+	}
+}
+
+static void S2LP_Emulator_AirSend(S2LP_Emulator* transmitter, uint8_t value) {
+	if (transmitter->air == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < transmitter->air->chip_count; i++) {
+		S2LP_Emulator* const chip = transmitter->air->chips[i];
+		if (chip->rx_source != transmitter) {
+			continue;
+		}
+
+		if (!S2LP_Emulator_FIFOPush(&chip->rx_fifo, value)) {
+			// Packet is lost on overflow
+			chip->rx_source = NULL;
+			chip->statistics.rx_fifo_overflows++;
+			S2LP_Emulator_RaiseInterrupt(chip, S2LP_INT_RX_FIFO_ERROR);
+			chip->state = S2LP_STATE_READY;
+		} else if (chip->rx_fifo.count == S2LP_Emulator_Threshold(chip, S2LP_REG_FIFO_CONFIG3)) {
+			S2LP_Emulator_RaiseInterrupt(chip, S2LP_INT_RX_FIFO_ALMOST_FULL);
+		}
+		S2LP_Emulator_UpdateStatus(chip);
+	}
+}
+
+// Transmission ended - completed packet is received, aborted one is lost
+static void S2LP_Emulator_AirEnd(S2LP_Emulator* transmitter, bool completed) {
+	if (transmitter->air == NULL) {
+		return;
+	}
+
+	bool delivered = false;
+	for (size_t i = 0; i < transmitter->air->chip_count; i++) {
+		S2LP_Emulator* const chip = transmitter->air->chips[i];
+		if (chip->rx_source != transmitter) {
+			continue;
+		}
+
+		chip->rx_source = NULL;
+		if (completed) {
+			chip->registers[S2LP_REG_RX_PCKT_LEN1] = (uint8_t) GETBYTE(transmitter->air_length, 1);
+			chip->registers[S2LP_REG_RX_PCKT_LEN0] = (uint8_t) GETBYTE(transmitter->air_length, 0);
+			chip->statistics.packets_received++;
+			S2LP_Emulator_RaiseInterrupt(chip, S2LP_INT_RX_DATA_READY);
+			chip->state = S2LP_STATE_READY;
+			S2LP_Emulator_UpdateStatus(chip);
+			delivered = true;
+		}
+	}
+
+	if (completed && delivered) {
+		transmitter->air->packets_delivered++;
+	} else if (completed) {
+		transmitter->air->packets_lost++;
+	}
+}
+
+static void S2LP_Emulator_StartAir(S2LP_Emulator* emulator, size_t length) {
+	uint64_t const byte_time = S2LP_Emulator_GetByteTime(emulator);
+
+	emulator->air_active = true;
+	emulator->air_length = length;
+	emulator->air_position = 0;
+	emulator->air_next_event_ns = emulator->time_ns + (byte_time * S2LP_Emulator_HeaderBits(emulator)) / 8 + byte_time;
+
+	if (emulator->state == S2LP_STATE_RX) {
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_VALID_PREAMBLE_DETECTED);
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_SYNC_WORD_DETECTED);
+	}
+}
+
+static void S2LP_Emulator_StopAir(S2LP_Emulator* emulator) {
+	emulator->air_active = false;
+	emulator->state = S2LP_STATE_READY;
+}
+
+static void S2LP_Emulator_ProcessTX(S2LP_Emulator* emulator) {
+	if (emulator->air_position == emulator->air_length) {
+		emulator->statistics.packets_sent++;
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_TX_DATA_SENT);
+		S2LP_Emulator_StopAir(emulator);
+		S2LP_Emulator_AirEnd(emulator, true);
+		return;
+	}
+
+	uint8_t value = 0;
+	if (!S2LP_Emulator_FIFOPop(&emulator->tx_fifo, &value)) {
+		emulator->statistics.tx_fifo_underflows++;
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_TX_FIFO_ERROR);
+		S2LP_Emulator_StopAir(emulator);
+		S2LP_Emulator_AirEnd(emulator, false);
+		return;
+	}
+
+	if (emulator->tx_fifo.count == S2LP_Emulator_Threshold(emulator, S2LP_REG_FIFO_CONFIG0)) {
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_TX_FIFO_ALMOST_EMPTY);
+	}
+
+	if (emulator->tx_sink != NULL && emulator->tx_sink_length < emulator->tx_sink_capacity) {
+		emulator->tx_sink[emulator->tx_sink_length++] = value;
+	}
+	S2LP_Emulator_AirSend(emulator, value);
+
+	emulator->air_position++;
+}
+
+static void S2LP_Emulator_ProcessRX(S2LP_Emulator* emulator) {
+	if (emulator->air_position == emulator->air_length) {
+		emulator->registers[S2LP_REG_RX_PCKT_LEN1] = (uint8_t) GETBYTE(emulator->air_length, 1);
+		emulator->registers[S2LP_REG_RX_PCKT_LEN0] = (uint8_t) GETBYTE(emulator->air_length, 0);
+		emulator->rx_packet = NULL;
+		emulator->statistics.packets_received++;
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_RX_DATA_READY);
+		S2LP_Emulator_StopAir(emulator);
+		return;
+	}
+
+	if (!S2LP_Emulator_FIFOPush(&emulator->rx_fifo, emulator->rx_packet[emulator->air_position])) {
+		// Packet is lost on overflow
+		emulator->rx_packet = NULL;
+		emulator->statistics.rx_fifo_overflows++;
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_RX_FIFO_ERROR);
+		S2LP_Emulator_StopAir(emulator);
+		return;
+	}
+
+	if (emulator->rx_fifo.count == S2LP_Emulator_Threshold(emulator, S2LP_REG_FIFO_CONFIG3)) {
+		S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_RX_FIFO_ALMOST_FULL);
+	}
+
+	emulator->air_position++;
+}
+
+static void S2LP_Emulator_ProcessRadio(S2LP_Emulator* emulator) {
+	while (emulator->air_active && emulator->air_next_event_ns <= emulator->time_ns) {
+		uint64_t const byte_time = S2LP_Emulator_GetByteTime(emulator);
+
+		if (emulator->state == S2LP_STATE_TX) {
+			S2LP_Emulator_ProcessTX(emulator);
+		} else if (emulator->state == S2LP_STATE_RX) {
+			S2LP_Emulator_ProcessRX(emulator);
+		} else {
+			emulator->air_active = false;
+		}
+
+		emulator->air_next_event_ns += byte_time;
+		if (emulator->air_position == emulator->air_length) {
+			// CRC goes after the last byte of payload
+			emulator->air_next_event_ns += byte_time * S2LP_Emulator_CRCLength(emulator);
+		}
+	}
+
+	S2LP_Emulator_UpdateStatus(emulator);
+}
+
+static void S2LP_Emulator_ExecuteCommand(S2LP_Emulator* emulator, uint8_t command) {
+	emulator->statistics.commands++;
+
+	switch (command) {
+		case S2LP_CMD_TX: {
+			uint8_t const* regs = emulator->registers;
+			size_t const length = ((size_t) regs[S2LP_REG_PCKTLEN1] << 8) | regs[S2LP_REG_PCKTLEN0];
+			emulator->state = S2LP_STATE_TX;
+			S2LP_Emulator_StartAir(emulator, length);
+			S2LP_Emulator_AirStart(emulator);
+			break;
+		}
+		case S2LP_CMD_RX:
+			emulator->state = S2LP_STATE_RX;
+			if (emulator->rx_packet != NULL) {
+				S2LP_Emulator_StartAir(emulator, emulator->rx_packet_length);
+			}
+			break;
+		case S2LP_CMD_READY:
+		case S2LP_CMD_SABORT:
+			if (emulator->air_active && emulator->state == S2LP_STATE_RX) {
+				// Reception in progress is lost
+				emulator->rx_packet = NULL;
+			} else if (emulator->air_active && emulator->state == S2LP_STATE_TX) {
+				S2LP_Emulator_AirEnd(emulator, false);
+			}
+			emulator->rx_source = NULL;
+			emulator->air_active = false;
+			emulator->state = S2LP_STATE_READY;
+			break;
+		case S2LP_CMD_STANDBY:
+			emulator->state = S2LP_STATE_STANDBY;
+			break;
+		case S2LP_CMD_SLEEP:
+			emulator->state = (GETBIT(emulator->registers[S2LP_REG_PM_CONF0], 0) ? S2LP_STATE_SLEEP_B :
+																					S2LP_STATE_SLEEP_A);
+			break;
+		case S2LP_CMD_LOCKRX:
+		case S2LP_CMD_LOCKTX:
+			emulator->state = S2LP_STATE_LOCK;
+			break;
+		case S2LP_CMD_SRES:
+			if (emulator->air_active && emulator->state == S2LP_STATE_TX) {
+				S2LP_Emulator_AirEnd(emulator, false);
+			}
+			S2LP_Emulator_Reset(emulator);
+			break;
+		case S2LP_CMD_FLUSHRXFIFO:
+			S2LP_Emulator_FIFOClear(&emulator->rx_fifo);
+			break;
+		case S2LP_CMD_FLUSHTXFIFO:
+			S2LP_Emulator_FIFOClear(&emulator->tx_fifo);
+			break;
+		default:
+			break;
+	}
+
+	S2LP_Emulator_UpdateStatus(emulator);
+}
+
+static uint8_t S2LP_Emulator_ReadByte(S2LP_Emulator* emulator, uint8_t address) {
+	uint8_t value = 0;
+
+	switch (address) {
+		case S2LP_ADDR_FIFO:
+			if (!S2LP_Emulator_FIFOPop(&emulator->rx_fifo, &value)) {
+				S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_RX_FIFO_ERROR);
+			} else if (emulator->rx_fifo.count == S2LP_Emulator_Threshold(emulator, S2LP_REG_FIFO_CONFIG2)) {
+				S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_RX_FIFO_ALMOST_EMPTY);
+			}
+			S2LP_Emulator_UpdateStatus(emulator);
+			return value;
+		case S2LP_REG_IRQ_STATUS3:
+		case S2LP_REG_IRQ_STATUS2:
+		case S2LP_REG_IRQ_STATUS1:
+		case S2LP_REG_IRQ_STATUS0:
+			// Clear-on-read
+			value = emulator->registers[address];
+			emulator->registers[address] = 0;
+			return value;
+		default:
+			return emulator->registers[address];
+	}
+}
+
+static void S2LP_Emulator_WriteByte(S2LP_Emulator* emulator, uint8_t address, uint8_t value) {
+	if (address == S2LP_ADDR_FIFO) {
+		if (!S2LP_Emulator_FIFOPush(&emulator->tx_fifo, value)) {
+			S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_TX_FIFO_ERROR);
+		} else if (emulator->tx_fifo.count == S2LP_Emulator_Threshold(emulator, S2LP_REG_FIFO_CONFIG1)) {
+			S2LP_Emulator_RaiseInterrupt(emulator, S2LP_INT_TX_FIFO_ALMOST_FULL);
+		}
+		S2LP_Emulator_UpdateStatus(emulator);
+		return;
+	}
+
+	// Status registers are read-only
+	if (address >= S2LP_REG_MC_STATE1) {
+		return;
+	}
+
+	emulator->registers[address] = value;
+}
+
+static uint8_t S2LP_Emulator_ProcessByte(S2LP_Emulator* emulator, uint8_t input) {
+	size_t const index = emulator->transaction_index++;
+	uint8_t output = 0;
+
+	switch (index) {
+		case 0:
+			emulator->header = input;
+			if (input == S2LP_EMULATOR_HEADER_READ) {
+				emulator->statistics.read_transactions++;
+			} else if (input == S2LP_EMULATOR_HEADER_WRITE) {
+				emulator->statistics.write_transactions++;
+			}
+			emulator->status_latch = emulator->registers[S2LP_REG_MC_STATE0];
+			return emulator->registers[S2LP_REG_MC_STATE1];
+		case 1:
+			emulator->address = input;
+			output = emulator->status_latch;
+			if (emulator->header == S2LP_EMULATOR_HEADER_COMMAND) {
+				S2LP_Emulator_ExecuteCommand(emulator, input);
+			}
+			return output;
+		default:
+			break;
+	}
+
+	if (emulator->header == S2LP_EMULATOR_HEADER_READ) {
+		output = S2LP_Emulator_ReadByte(emulator, emulator->address);
+	} else if (emulator->header == S2LP_EMULATOR_HEADER_WRITE) {
+		S2LP_Emulator_WriteByte(emulator, emulator->address, input);
+	}
+
+	// FIFO address does not auto-increment
+	if (emulator->address != S2LP_ADDR_FIFO) {
+		emulator->address++;
+	}
+
+	return output;
+}
+
+// ===== Timeline helpers =====
+
+// Chips sharing the timeline with the chip - the ones on it's bus or air, or only the chip itself
+static S2LP_Emulator* const* S2LP_Emulator_Timeline(S2LP_Emulator* const* emulator, size_t* count) {
+	if ((*emulator)->bus != NULL) {
+		*count = (*emulator)->bus->chip_count;
+		return (*emulator)->bus->chips;
+	}
+
+	if ((*emulator)->air != NULL) {
+		*count = (*emulator)->air->chip_count;
+		return (*emulator)->air->chips;
+	}
+
+	*count = 1;
+	return emulator;
+}
+
+// Let the time pass for the chip, and all the other chips on it's timeline
+static void S2LP_Emulator_Elapse(S2LP_Emulator* emulator, uint64_t nanoseconds) {
+	size_t count = 0;
+	S2LP_Emulator* const* chips = S2LP_Emulator_Timeline(&emulator, &count);
+
+	for (size_t i = 0; i < count; i++) {
+		chips[i]->time_ns += nanoseconds;
+		S2LP_Emulator_ProcessRadio(chips[i]);
+	}
+}
+
+// Move the CPU time back, used by DMA-like transfers
+static void S2LP_Emulator_Rewind(S2LP_Emulator* emulator, uint64_t nanoseconds) {
+	size_t count = 0;
+	S2LP_Emulator* const* chips = S2LP_Emulator_Timeline(&emulator, &count);
+
+	for (size_t i = 0; i < count; i++) {
+		chips[i]->time_ns -= nanoseconds;
+	}
+}
+
+// ===== Transport implementation =====
+
+static void S2LP_Emulator_Transfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_Emulator* const emulator = (S2LP_Emulator*) context;
+	uint64_t const byte_time = S2LP_Emulator_GetTransferTime(emulator, 1) - emulator->cs_overhead_ns;
+
+	for (size_t i = 0; i < length; i++) {
+		uint8_t const input = (tx_data != NULL ? tx_data[i] : 0);
+		uint8_t output = 0;
+
+		emulator->statistics.bus_time_ns += byte_time;
+		S2LP_Emulator_Elapse(emulator, byte_time);
+
+		if (emulator->selected && emulator->state != S2LP_STATE_SHUTDOWN) {
+			output = S2LP_Emulator_ProcessByte(emulator, input);
+		}
+
+		if (rx_data != NULL) {
+			rx_data[i] = output;
+		}
+	}
+
+	emulator->statistics.spi_bytes += length;
+}
+
+static void S2LP_Emulator_TransferStart(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_Emulator* const emulator = (S2LP_Emulator*) context;
+	uint64_t const start_time = emulator->time_ns;
+
+	// Data is exchanged immediately, but the CPU time goes back to the start
+	// of the transfer - the transfer is done when the time passes it's end.
+	S2LP_Emulator_Transfer(context, tx_data, rx_data, length);
+	emulator->transfer_done_ns = emulator->time_ns;
+	S2LP_Emulator_Rewind(emulator, emulator->time_ns - start_time);
+	emulator->transfer_active = true;
+}
+
+static bool S2LP_Emulator_TransferPoll(void* context) {
+	S2LP_Emulator* const emulator = (S2LP_Emulator*) context;
+
+	if (emulator->transfer_active && emulator->time_ns < emulator->transfer_done_ns) {
+		uint64_t const remaining = emulator->transfer_done_ns - emulator->time_ns;
+		uint64_t const step = (emulator->poll_time_ns > 0 && emulator->poll_time_ns < remaining ?
+				emulator->poll_time_ns : remaining);
+		S2LP_Emulator_AdvanceTime(emulator, step);
+		return false;
+	}
+
+	emulator->transfer_active = false;
+	return true;
+}
+
+static void S2LP_Emulator_WritePin(void* context, S2LP_Pin pin, bool state) {
+	S2LP_Emulator* const emulator = (S2LP_Emulator*) context;
+
+	switch (pin) {
+		case S2LP_PIN_CSN:
+			if (state == emulator->selected) {
+				// Active low - select on falling edge, deselect on rising edge
+				uint64_t const half_overhead = emulator->cs_overhead_ns / 2;
+				emulator->statistics.bus_time_ns += half_overhead;
+				S2LP_Emulator_Elapse(emulator, half_overhead);
+				emulator->selected = !state;
+				emulator->transaction_index = 0;
+				if (emulator->selected) {
+					emulator->statistics.transactions++;
+				}
+			}
+			break;
+		case S2LP_PIN_SDN:
+			if (state) {
+				if (emulator->air_active && emulator->state == S2LP_STATE_TX) {
+					S2LP_Emulator_AirEnd(emulator, false);
+				}
+				emulator->state = S2LP_STATE_SHUTDOWN;
+				emulator->air_active = false;
+				emulator->rx_source = NULL;
+			} else if (emulator->state == S2LP_STATE_SHUTDOWN) {
+				S2LP_Emulator_Reset(emulator);
+			}
+			break;
+		default:
+			// S2-LP GPIOs are outputs from MCU point of view
+			break;
+	}
+}
+
+static bool S2LP_Emulator_ReadPin(void* context, S2LP_Pin pin) {
+	S2LP_Emulator* const emulator = (S2LP_Emulator*) context;
+	uint8_t conf = 0;
+
+	switch (pin) {
+		case S2LP_PIN_GPIO_0:
+			conf = emulator->registers[S2LP_REG_GPIO0_CONF];
+			break;
+		case S2LP_PIN_GPIO_1:
+			conf = emulator->registers[S2LP_REG_GPIO1_CONF];
+			break;
+		case S2LP_PIN_GPIO_2:
+			conf = emulator->registers[S2LP_REG_GPIO2_CONF];
+			break;
+		case S2LP_PIN_GPIO_3:
+			conf = emulator->registers[S2LP_REG_GPIO3_CONF];
+			break;
+		case S2LP_PIN_CSN:
+			return !emulator->selected;
+		default:
+			return false;
+	}
+
+	// Pin is polled in a loop while waiting for the radio, so it takes CPU time
+	S2LP_Emulator_AdvanceTime(emulator, emulator->poll_time_ns);
+
+	uint8_t const pin_mode = GETBITS(conf, 0b11, 0);
+	if (pin_mode != S2LP_PINMODE_OUTPUT_LP && pin_mode != S2LP_PINMODE_OUTPUT_HP) {
+		return false;
+	}
+
+	switch ((S2LP_GPIO_Output_Mode) GETBITS(conf, 0b11111, 3)) {
+		case S2LP_GPIO_OUT_NIRQ: {
+			uint32_t const masks = ((uint32_t) emulator->registers[S2LP_REG_IRQ_MASK3] << 24)
+					| ((uint32_t) emulator->registers[S2LP_REG_IRQ_MASK2] << 16)
+					| ((uint32_t) emulator->registers[S2LP_REG_IRQ_MASK1] << 8)
+					| emulator->registers[S2LP_REG_IRQ_MASK0];
+			// Active low
+			return (S2LP_Emulator_GetPendingInterrupts(emulator) & masks) == 0;
+		}
+		case S2LP_GPIO_OUT_TX_STATE_OUT:
+			return emulator->state == S2LP_STATE_TX;
+		case S2LP_GPIO_OUT_RX_STATE_INDICATION:
+			return emulator->state == S2LP_STATE_RX;
+		case S2LP_GPIO_OUT_IN_READY:
+			return emulator->state == S2LP_STATE_READY;
+		case S2LP_GPIO_OUT_TX_RX_MODE_INDICATOR:
+			return emulator->state == S2LP_STATE_TX || emulator->state == S2LP_STATE_RX;
+		case S2LP_GPIO_OUT_VDD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static void S2LP_Emulator_Delay(void* context, uint32_t milliseconds) {
+	S2LP_Emulator_AdvanceTime((S2LP_Emulator*) context, (uint64_t) milliseconds * 1000000ull);
+}
+
+static uint32_t S2LP_Emulator_GetTime(void* context) {
+	return (uint32_t) (((S2LP_Emulator*) context)->time_ns / 1000ull);
+}
+
+S2LP_Transport const S2LP_Emulator_Transport = {
+	.transfer = S2LP_Emulator_Transfer,
+	.write_pin = S2LP_Emulator_WritePin,
+	.read_pin = S2LP_Emulator_ReadPin,
+	.delay = S2LP_Emulator_Delay,
+	.get_time_us = S2LP_Emulator_GetTime,
+};
+
+S2LP_Transport const S2LP_Emulator_DMATransport = {
+	.transfer = S2LP_Emulator_Transfer,
+	.write_pin = S2LP_Emulator_WritePin,
+	.read_pin = S2LP_Emulator_ReadPin,
+	.delay = S2LP_Emulator_Delay,
+	.get_time_us = S2LP_Emulator_GetTime,
+	.transfer_start = S2LP_Emulator_TransferStart,
+	.transfer_poll = S2LP_Emulator_TransferPoll,
+};
+
+// ===== Bus transport implementation =====
+
+// Chip driving the bus - the selected one. If none is selected, the transfer still
+// takes time, so it's done on any chip (which ignores the data).
+static S2LP_Emulator* S2LP_Emulator_BusSelectedChip(S2LP_Emulator_Bus* bus) {
+	for (size_t i = 0; i < bus->chip_count; i++) {
+		if (bus->chips[i]->selected) {
+			return bus->chips[i];
+		}
+	}
+
+	return bus->chips[0];
+}
+
+static void S2LP_Emulator_BusTransfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_Emulator_Bus* const bus = (S2LP_Emulator_Bus*) context;
+	S2LP_Emulator_Transfer(S2LP_Emulator_BusSelectedChip(bus), tx_data, rx_data, length);
+}
+
+static void S2LP_Emulator_BusTransferStart(void* context, uint8_t const* tx_data, uint8_t* rx_data,
+		size_t length) {
+	S2LP_Emulator_Bus* const bus = (S2LP_Emulator_Bus*) context;
+	bus->active = S2LP_Emulator_BusSelectedChip(bus);
+	S2LP_Emulator_TransferStart(bus->active, tx_data, rx_data, length);
+}
+
+static bool S2LP_Emulator_BusTransferPoll(void* context) {
+	S2LP_Emulator_Bus* const bus = (S2LP_Emulator_Bus*) context;
+
+	if (bus->active == NULL || S2LP_Emulator_TransferPoll(bus->active)) {
+		bus->active = NULL;
+		return true;
+	}
+
+	return false;
+}
+
+S2LP_Transport const S2LP_Emulator_BusTransport = {
+	.transfer = S2LP_Emulator_BusTransfer,
+	.transfer_start = S2LP_Emulator_BusTransferStart,
+	.transfer_poll = S2LP_Emulator_BusTransferPoll,
+};
+
+// ===== Public API =====
+
+void S2LP_Emulator_Init(S2LP_Emulator* emulator, S2LP_ClockFrequency frequency, uint32_t spi_clock_hz) {
+	memset(emulator, 0, sizeof(S2LP_Emulator));
+
+	emulator->xo_frequency = S2LP_RFCalc_ClockFrequency(frequency);
+	emulator->spi_clock_hz = spi_clock_hz;
+	emulator->cs_overhead_ns = S2LP_EMULATOR_DEFAULT_CS_OVERHEAD_NS;
+	emulator->poll_time_ns = S2LP_EMULATOR_DEFAULT_POLL_TIME_NS;
+
+	S2LP_Emulator_Reset(emulator);
+}
+
+void S2LP_Emulator_Reset(S2LP_Emulator* emulator) {
+	memset(emulator->registers, 0, sizeof(emulator->registers));
+	for (size_t i = 0; i < S2LP_REGISTER_COUNT; i++) {
+		emulator->registers[S2LP_REGISTER_MAP[i].address] = S2LP_REGISTER_MAP[i].default_value;
+	}
+
+	S2LP_Emulator_FIFOClear(&emulator->tx_fifo);
+	S2LP_Emulator_FIFOClear(&emulator->rx_fifo);
+	emulator->state = S2LP_STATE_READY;
+	emulator->air_active = false;
+	emulator->rx_packet = NULL;
+	emulator->rx_source = NULL;
+
+	S2LP_Emulator_UpdateStatus(emulator);
+}
+
+void S2LP_Emulator_AdvanceTime(S2LP_Emulator* emulator, uint64_t nanoseconds) {
+	S2LP_Emulator_Elapse(emulator, nanoseconds);
+}
+
+bool S2LP_Emulator_InjectPacket(S2LP_Emulator* emulator, uint8_t const* data, size_t length) {
+	if (emulator->rx_packet != NULL) {
+		return false;
+	}
+
+	emulator->rx_packet = data;
+	emulator->rx_packet_length = length;
+
+	if (emulator->state == S2LP_STATE_RX && !emulator->air_active) {
+		S2LP_Emulator_StartAir(emulator, length);
+	}
+
+	return true;
+}
+
+void S2LP_Emulator_SetTxSink(S2LP_Emulator* emulator, uint8_t* buffer, size_t capacity) {
+	emulator->tx_sink = buffer;
+	emulator->tx_sink_capacity = capacity;
+	emulator->tx_sink_length = 0;
+}
+
+void S2LP_Emulator_RaiseInterrupt(S2LP_Emulator* emulator, S2LP_Interrupt interrupt) {
+	// IRQ_STATUS0 keeps bits 0-7, IRQ_STATUS1 bits 8-15, and so on
+	uint8_t const address = (uint8_t) (S2LP_REG_IRQ_STATUS0 - ((uint8_t) interrupt / 8));
+	SETBIT(emulator->registers[address], ((uint8_t) interrupt % 8));
+}
+
+uint32_t S2LP_Emulator_GetPendingInterrupts(S2LP_Emulator const* emulator) {
+	return ((uint32_t) emulator->registers[S2LP_REG_IRQ_STATUS3] << 24)
+			| ((uint32_t) emulator->registers[S2LP_REG_IRQ_STATUS2] << 16)
+			| ((uint32_t) emulator->registers[S2LP_REG_IRQ_STATUS1] << 8)
+			| emulator->registers[S2LP_REG_IRQ_STATUS0];
+}
+
+uint32_t S2LP_Emulator_GetCarrierFrequency(S2LP_Emulator const* emulator) {
+	uint8_t const* regs = emulator->registers;
+	uint64_t const synth = ((uint64_t) GETBITS(regs[S2LP_REG_SYNT3], 0b1111, 0) << 24)
+			| ((uint64_t) regs[S2LP_REG_SYNT2] << 16) | ((uint64_t) regs[S2LP_REG_SYNT1] << 8) | regs[S2LP_REG_SYNT0];
+	// Datasheet section 5.3.1: fbase = fXO * SYNT / (2^20 * B/2 * D), fc = fbase + fXO / 2^15 * CHSPACE * CHNUM
+	uint64_t const half_pll_div = (GETBIT(regs[S2LP_REG_SYNT3], 4) ? 4 : 2);
+	uint64_t const ref_div = (GETBIT(regs[S2LP_REG_XO_RCO_CONF0], 3) ? 2 : 1);
+	uint64_t const base = (emulator->xo_frequency * synth) / ((half_pll_div * ref_div) << 20);
+	uint64_t const offset = ((uint64_t) emulator->xo_frequency * regs[S2LP_REG_CHSPACE] * regs[S2LP_REG_CHNUM]) >> 15;
+	return (uint32_t) (base + offset);
+}
+
+uint64_t S2LP_Emulator_GetByteTime(S2LP_Emulator const* emulator) {
+	uint8_t const* regs = emulator->registers;
+	uint64_t const mantissa = ((uint64_t) regs[S2LP_REG_MOD4] << 8) | regs[S2LP_REG_MOD3];
+	uint8_t const exponent = GETBITS(regs[S2LP_REG_MOD2], 0xF, 0);
+	uint64_t const fdig = (emulator->xo_frequency >= 48000000 ? emulator->xo_frequency / 2 : emulator->xo_frequency);
+
+	// Byte time is 8 / datarate, with datarate formulas from datasheet (section 5.4.4)
+	double byte_time = 0;
+	if (fdig == 0 || ((exponent == 0 || exponent == 15) && mantissa == 0)) {
+		// Datarate is zero, nothing will ever go over the air
+		return UINT64_MAX / 2;
+	} else if (exponent == 0) {
+		byte_time = (8.0e9 * 4294967296.0) / ((double) fdig * (double) mantissa);
+	} else if (exponent == 15) {
+		byte_time = (8.0e9 * 8.0 * (double) mantissa) / (double) fdig;
+	} else {
+		byte_time = (8.0e9 * 8589934592.0) / ((double) fdig * (double) (65536 + mantissa) * (double) (1u << exponent));
+	}
+
+	return (uint64_t) byte_time;
+}
+
+uint64_t S2LP_Emulator_GetTransferTime(S2LP_Emulator const* emulator, size_t length) {
+	return emulator->cs_overhead_ns + ((uint64_t) length * 8000000000ull) / emulator->spi_clock_hz;
+}
+
+void S2LP_Emulator_ResetStatistics(S2LP_Emulator* emulator) {
+	memset(&emulator->statistics, 0, sizeof(S2LP_Emulator_Statistics));
+}
+
+void S2LP_Emulator_InitBus(S2LP_Emulator_Bus* bus) {
+	memset(bus, 0, sizeof(S2LP_Emulator_Bus));
+}
+
+bool S2LP_Emulator_AttachToBus(S2LP_Emulator_Bus* bus, S2LP_Emulator* emulator) {
+	if (bus->chip_count >= S2LP_EMULATOR_BUS_MAX_CHIPS || emulator->air != NULL) {
+		return false;
+	}
+
+	if (bus->chip_count > 0) {
+		emulator->time_ns = bus->chips[0]->time_ns;
+	}
+
+	emulator->bus = bus;
+	bus->chips[bus->chip_count] = emulator;
+	bus->chip_count++;
+	return true;
+}
+
+void S2LP_Emulator_InitAir(S2LP_Emulator_Air* air) {
+	memset(air, 0, sizeof(S2LP_Emulator_Air));
+}
+
+bool S2LP_Emulator_AttachToAir(S2LP_Emulator_Air* air, S2LP_Emulator* emulator) {
+	if (air->chip_count >= S2LP_EMULATOR_AIR_MAX_CHIPS || emulator->bus != NULL) {
+		return false;
+	}
+
+	if (air->chip_count > 0) {
+		emulator->time_ns = air->chips[0]->time_ns;
+	}
+
+	emulator->air = air;
+	air->chips[air->chip_count] = emulator;
+	air->chip_count++;
+	return true;
+}
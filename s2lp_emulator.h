@@ -0,0 +1,191 @@
+/*
+ * s2lp_emulator.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_EMULATOR_H_
+#define S2LP_S2LP_EMULATOR_H_
+
+// Register-level S2-LP emulator, implemented as a transport backend.
+// It emulates:
+// * 256-byte register file, reset to datasheet defaults
+// * status bytes (MC_STATE1, MC_STATE0) returned at the beginning of every transaction
+// * clear-on-read IRQ_STATUS registers, and nIRQ output on GPIOs configured as NIRQ
+// * 128-byte TX and RX FIFOs behind S2LP_ADDR_FIFO, with almost full/empty and error interrupts
+// * command state machine (TX, RX, READY, SABORT, SRES, FLUSHRXFIFO, FLUSHTXFIFO, ...)
+// * BASIC packet transmission and reception timing, based on datarate and packet registers
+// * packets sent over the air between emulated chips, on matching carrier frequency and datarate
+// Everything runs on a simulated timeline - SPI transfers and delays advance the time
+// instead of waiting, so the results are fast and deterministic.
+// Usage:
+//   S2LP_Emulator emulator;
+//   S2LP_Emulator_Init(&emulator, S2LP_CLOCK_FREQ_50MHZ, 10000000);
+//   handle.transport = &S2LP_Emulator_Transport;
+//   handle.transport_context = &emulator;
+//   S2LP_Initialize(&handle, S2LP_CLOCK_FREQ_50MHZ);
+
+#include "s2lp_mcu_interface.h"
+
+#define S2LP_EMULATOR_FIFO_SIZE S2LP_FIFO_SIZE
+// Time needed to assert and release chip select around a transaction
+#define S2LP_EMULATOR_DEFAULT_CS_OVERHEAD_NS 1000
+// CPU time spent on a single poll of unfinished DMA transfer, or GPIO read
+#define S2LP_EMULATOR_DEFAULT_POLL_TIME_NS 100
+// Maximum amount of emulated chips on single bus
+#define S2LP_EMULATOR_BUS_MAX_CHIPS 8
+// Maximum amount of emulated chips sharing the air
+#define S2LP_EMULATOR_AIR_MAX_CHIPS 8
+
+typedef struct S2LP_Emulator_FIFO_t {
+	uint8_t data[S2LP_EMULATOR_FIFO_SIZE];
+	uint8_t head;
+	uint8_t count;
+} S2LP_Emulator_FIFO;
+
+typedef struct S2LP_Emulator_Statistics_t {
+	// Chip select frames, split by type
+	uint32_t transactions;
+	uint32_t read_transactions;
+	uint32_t write_transactions;
+	uint32_t commands;
+	// All bytes clocked over SPI, including headers and status bytes
+	uint64_t spi_bytes;
+	// Time spent with chip selected or transferring data
+	uint64_t bus_time_ns;
+	uint32_t packets_sent;
+	uint32_t packets_received;
+	uint32_t tx_fifo_underflows;
+	uint32_t rx_fifo_overflows;
+} S2LP_Emulator_Statistics;
+
+struct S2LP_Emulator_t;
+
+// Multiple emulated chips on one SPI bus, with a shared simulated timeline.
+// Time spent by any of the chips (transfers, delays, polls) passes for all of them.
+// Transfers go to the chip with chip select asserted, other chips stay silent.
+// Usage (with the bus arbiter, see s2lp_bus.h):
+//   S2LP_Emulator_InitBus(&emulator_bus);
+//   S2LP_Emulator_AttachToBus(&emulator_bus, &emulators[i]);
+//   S2LP_Bus_Init(&bus, &S2LP_Emulator_BusTransport, &emulator_bus);
+//   S2LP_Bus_Attach(&bus, &devices[i], &handles[i], &S2LP_Emulator_Transport, &emulators[i]);
+typedef struct S2LP_Emulator_Bus_t {
+	struct S2LP_Emulator_t* chips[S2LP_EMULATOR_BUS_MAX_CHIPS];
+	size_t chip_count;
+	// Chip which started DMA-like transfer
+	struct S2LP_Emulator_t* active;
+} S2LP_Emulator_Bus;
+
+// Radio medium shared by emulated chips, with a shared simulated timeline (just like on S2LP_Emulator_Bus).
+// Packet transmitted by one chip is received by every chip which was in RX at the start of transmission,
+// on the same carrier frequency and with the same datarate. Bytes get to RX FIFO of the receivers as the
+// transmitter sends them, and reception ends with the transmission. A chip can be either on the air or on a bus.
+// Usage:
+//   S2LP_Emulator_InitAir(&air);
+//   S2LP_Emulator_AttachToAir(&air, &transmitter);
+//   S2LP_Emulator_AttachToAir(&air, &receiver);
+typedef struct S2LP_Emulator_Air_t {
+	struct S2LP_Emulator_t* chips[S2LP_EMULATOR_AIR_MAX_CHIPS];
+	size_t chip_count;
+	// Transmitted packets received by at least one chip, and by none
+	uint32_t packets_delivered;
+	uint32_t packets_lost;
+} S2LP_Emulator_Air;
+
+typedef struct S2LP_Emulator_t {
+	uint8_t registers[256];
+	S2LP_Emulator_FIFO tx_fifo;
+	S2LP_Emulator_FIFO rx_fifo;
+	S2LP_State state;
+
+	// Configuration - can be changed after init
+	uint32_t xo_frequency;
+	uint32_t spi_clock_hz;
+	uint32_t cs_overhead_ns;
+	uint32_t poll_time_ns;
+
+	// Simulated time
+	uint64_t time_ns;
+	// Bus sharing the timeline, see S2LP_Emulator_AttachToBus
+	S2LP_Emulator_Bus* bus;
+	// Air sharing the timeline, see S2LP_Emulator_AttachToAir
+	S2LP_Emulator_Air* air;
+
+	// SPI transaction state
+	bool selected;
+	size_t transaction_index;
+	uint8_t header;
+	uint8_t address;
+	uint8_t status_latch;
+
+	// Transfer started with DMA transport, finishing at transfer_done_ns
+	bool transfer_active;
+	uint64_t transfer_done_ns;
+
+	// Packet currently being transmitted/received over the air
+	bool air_active;
+	size_t air_length;
+	size_t air_position;
+	uint64_t air_next_event_ns;
+
+	// Packet waiting for reception, see S2LP_Emulator_InjectPacket
+	uint8_t const* rx_packet;
+	size_t rx_packet_length;
+	// Chip transmitting the packet being received over the air
+	struct S2LP_Emulator_t* rx_source;
+
+	// Optional sink for transmitted payloads
+	uint8_t* tx_sink;
+	size_t tx_sink_capacity;
+	size_t tx_sink_length;
+
+	S2LP_Emulator_Statistics statistics;
+} S2LP_Emulator;
+
+// Blocking transport - CPU waits for every transfer
+extern S2LP_Transport const S2LP_Emulator_Transport;
+// DMA-like transport - transfers run in background on the simulated timeline,
+// and complete when the simulated time passes their end. Time spent by CPU
+// on other work should be added with S2LP_Emulator_AdvanceTime, so the gain
+// from overlapping it with SPI transfers can be measured.
+extern S2LP_Transport const S2LP_Emulator_DMATransport;
+// SPI transport of S2LP_Emulator_Bus (context) - implements only transfer operations
+// (with DMA-like transfer_start), chip select and other pins go through the chip transports.
+extern S2LP_Transport const S2LP_Emulator_BusTransport;
+
+// Initialize the emulator. spi_clock_hz is used to calculate the transfer times.
+void S2LP_Emulator_Init(S2LP_Emulator* emulator, S2LP_ClockFrequency frequency, uint32_t spi_clock_hz);
+// Reset the chip state (registers, FIFOs, state machine), just like SRES or power-on does.
+void S2LP_Emulator_Reset(S2LP_Emulator* emulator);
+// Advance simulated time, processing radio events on the way.
+void S2LP_Emulator_AdvanceTime(S2LP_Emulator* emulator, uint64_t nanoseconds);
+// Queue a packet to be received "over the air". Reception starts when the chip is (or gets)
+// in RX state. Data is not copied - keep it alive until RX_DATA_READY is raised.
+// Returns false if another packet is already queued.
+bool S2LP_Emulator_InjectPacket(S2LP_Emulator* emulator, uint8_t const* data, size_t length);
+// Set the buffer capturing transmitted payloads. Every transmitted byte is appended to it.
+void S2LP_Emulator_SetTxSink(S2LP_Emulator* emulator, uint8_t* buffer, size_t capacity);
+// Raise interrupt flag in IRQ_STATUS registers
+void S2LP_Emulator_RaiseInterrupt(S2LP_Emulator* emulator, S2LP_Interrupt interrupt);
+// Get IRQ_STATUS flags without clearing them
+uint32_t S2LP_Emulator_GetPendingInterrupts(S2LP_Emulator const* emulator);
+// Carrier frequency (base frequency and channel offset) set in registers, in Hz
+uint32_t S2LP_Emulator_GetCarrierFrequency(S2LP_Emulator const* emulator);
+// Air time of a single byte with current datarate settings, in nanoseconds
+uint64_t S2LP_Emulator_GetByteTime(S2LP_Emulator const* emulator);
+// SPI bus time of a transaction with `length` bytes (including the header), in nanoseconds
+uint64_t S2LP_Emulator_GetTransferTime(S2LP_Emulator const* emulator, size_t length);
+void S2LP_Emulator_ResetStatistics(S2LP_Emulator* emulator);
+
+void S2LP_Emulator_InitBus(S2LP_Emulator_Bus* bus);
+// Put the chip on the bus. It's time is synchronized with the other chips on the bus.
+// Returns false if the bus is full, or the chip is on the air.
+bool S2LP_Emulator_AttachToBus(S2LP_Emulator_Bus* bus, S2LP_Emulator* emulator);
+
+void S2LP_Emulator_InitAir(S2LP_Emulator_Air* air);
+// Put the chip on the air. It's time is synchronized with the other chips on the air.
+// Returns false if the air is full, or the chip is on a bus.
+bool S2LP_Emulator_AttachToAir(S2LP_Emulator_Air* air, S2LP_Emulator* emulator);
+
+#endif /* S2LP_S2LP_EMULATOR_H_ */
@@ -0,0 +1,173 @@
+/*
+ * s2lp_fhss.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_fhss.h"
+#include "s2lp_constants.h"
+
+#include <string.h>
+
+// xorshift32 - needs non-zero state
+static uint32_t S2LP_FHSS_Random(uint32_t* state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static void S2LP_FHSS_UpdateStatistics(S2LP_FHSS_Statistics* statistics, uint32_t dwell, uint32_t latency) {
+	statistics->hops++;
+
+	statistics->dwell_total_us += dwell;
+	statistics->dwell_min_us = (dwell < statistics->dwell_min_us ? dwell : statistics->dwell_min_us);
+	statistics->dwell_max_us = (dwell > statistics->dwell_max_us ? dwell : statistics->dwell_max_us);
+
+	statistics->latency_total_us += latency;
+	statistics->latency_min_us = (latency < statistics->latency_min_us ? latency : statistics->latency_min_us);
+	statistics->latency_max_us = (latency > statistics->latency_max_us ? latency : statistics->latency_max_us);
+}
+
+// Switch to the channel at current position of the sequence
+static void S2LP_FHSS_Retune(S2LP_FHSS* fhss) {
+	if (fhss->listen) {
+		// Synthesizer locks only on the way to RX, so the radio has to leave it first
+		S2LP_SendCommand(fhss->handle, S2LP_CMD_SABORT);
+	}
+
+	S2LP_ChannelPlan_SelectChannel(fhss->handle, fhss->plan, fhss->sequence[fhss->position]);
+
+	if (fhss->listen) {
+		S2LP_SendCommand(fhss->handle, S2LP_CMD_RX);
+	}
+}
+
+static void S2LP_FHSS_DoHop(S2LP_FHSS* fhss, size_t steps) {
+	uint32_t const start = S2LP_GetTime(fhss->handle);
+
+	fhss->position = (fhss->position + steps) % fhss->sequence_length;
+	S2LP_FHSS_Retune(fhss);
+
+	uint32_t const end = S2LP_GetTime(fhss->handle);
+	S2LP_FHSS_UpdateStatistics(&fhss->statistics, start - fhss->hop_start_us, end - start);
+	fhss->hop_start_us = start;
+}
+
+void S2LP_FHSS_Init(S2LP_FHSS* fhss, S2LP_Handle* handle, S2LP_ChannelPlan const* plan, uint32_t dwell_time_us) {
+	memset(fhss, 0, sizeof(S2LP_FHSS));
+	fhss->handle = handle;
+	fhss->plan = plan;
+	fhss->dwell_time_us = dwell_time_us;
+	S2LP_FHSS_ResetStatistics(fhss);
+}
+
+bool S2LP_FHSS_SetSequence(S2LP_FHSS* fhss, uint8_t const* channels, size_t length) {
+	if (length == 0 || length > S2LP_FHSS_MAX_HOPS) {
+		return false;
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		if (channels[i] >= fhss->plan->channel_count) {
+			return false;
+		}
+	}
+
+	memcpy(fhss->sequence, channels, length);
+	fhss->sequence_length = length;
+	fhss->position = 0;
+	return true;
+}
+
+void S2LP_FHSS_GenerateSequence(S2LP_FHSS* fhss, uint32_t seed) {
+	uint32_t state = (seed != 0 ? seed : 0x9E3779B9);
+	size_t const length = fhss->plan->channel_count;
+	if (length == 0) {
+		return;
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		fhss->sequence[i] = (uint8_t) i;
+	}
+
+	// Fisher-Yates shuffle
+	for (size_t i = length - 1; i > 0; i--) {
+		size_t const j = S2LP_FHSS_Random(&state) % (i + 1);
+		uint8_t const channel = fhss->sequence[i];
+		fhss->sequence[i] = fhss->sequence[j];
+		fhss->sequence[j] = channel;
+	}
+
+	fhss->sequence_length = length;
+	fhss->position = 0;
+}
+
+bool S2LP_FHSS_Start(S2LP_FHSS* fhss, bool listen) {
+	if (fhss->sequence_length == 0) {
+		return false;
+	}
+
+	fhss->listen = listen;
+	fhss->position = 0;
+
+	// Radio state is unknown here, so it's always stopped before the whole plan is written
+	S2LP_SendCommand(fhss->handle, S2LP_CMD_SABORT);
+	S2LP_ChannelPlan_Apply(fhss->handle, fhss->plan, fhss->sequence[0]);
+	if (listen) {
+		S2LP_SendCommand(fhss->handle, S2LP_CMD_RX);
+	}
+
+	fhss->slot_start_us = S2LP_GetTime(fhss->handle);
+	fhss->hop_start_us = fhss->slot_start_us;
+	fhss->running = true;
+	return true;
+}
+
+void S2LP_FHSS_Stop(S2LP_FHSS* fhss) {
+	fhss->running = false;
+}
+
+bool S2LP_FHSS_Process(S2LP_FHSS* fhss) {
+	if (!fhss->running || fhss->dwell_time_us == 0) {
+		return false;
+	}
+
+	uint32_t const elapsed = S2LP_GetTime(fhss->handle) - fhss->slot_start_us;
+	if (elapsed < fhss->dwell_time_us) {
+		return false;
+	}
+
+	// Hop to the slot the schedule is in now, not to the next one
+	uint32_t const slots = elapsed / fhss->dwell_time_us;
+	fhss->statistics.missed_hops += slots - 1;
+	fhss->slot_start_us += slots * fhss->dwell_time_us;
+	S2LP_FHSS_DoHop(fhss, slots % fhss->sequence_length);
+	return true;
+}
+
+void S2LP_FHSS_Hop(S2LP_FHSS* fhss) {
+	if (fhss->sequence_length == 0) {
+		return;
+	}
+
+	S2LP_FHSS_DoHop(fhss, 1);
+	fhss->slot_start_us = fhss->hop_start_us;
+}
+
+uint8_t S2LP_FHSS_GetChannel(S2LP_FHSS const* fhss) {
+	return fhss->sequence[fhss->position];
+}
+
+uint32_t S2LP_FHSS_GetTimeToHop(S2LP_FHSS* fhss) {
+	uint32_t const elapsed = S2LP_GetTime(fhss->handle) - fhss->slot_start_us;
+	return (elapsed < fhss->dwell_time_us ? fhss->dwell_time_us - elapsed : 0);
+}
+
+void S2LP_FHSS_ResetStatistics(S2LP_FHSS* fhss) {
+	memset(&fhss->statistics, 0, sizeof(S2LP_FHSS_Statistics));
+	fhss->statistics.dwell_min_us = UINT32_MAX;
+	fhss->statistics.latency_min_us = UINT32_MAX;
+}
@@ -0,0 +1,98 @@
+/*
+ * s2lp_fhss.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_FHSS_H_
+#define S2LP_S2LP_FHSS_H_
+
+// Frequency hopping - walks a hop sequence (channel indices of a channel plan), switching
+// the channel every dwell time. Channel register values come from the plan, so the hop
+// itself is only the commands needed around single precomputed write:
+// * listening node (listen = true): SABORT, channel write, RX - 3 transactions
+// * other nodes: channel write only - S2-LP locks the synthesizer on the new channel
+//   at the next TX/RX command, and transmission in progress is not interrupted
+// Hops are scheduled by the time of S2LP_GetTime (so the transport needs the time source).
+// Nodes started at the same time, with the same sequence and dwell time, stay on the same channel.
+// Usage:
+//   S2LP_FHSS fhss;
+//   S2LP_FHSS_Init(&fhss, &handle, &plan, 20000);
+//   S2LP_FHSS_GenerateSequence(&fhss, 0x1234);
+//   S2LP_FHSS_Start(&fhss, true);
+//   while (...) {
+//     S2LP_FHSS_Process(&fhss);
+//     ...
+//   }
+
+#include "s2lp_channel_plan.h"
+
+#define S2LP_FHSS_MAX_HOPS 256
+
+typedef struct S2LP_FHSS_Statistics_t {
+	uint32_t hops;
+	// Hops skipped, because S2LP_FHSS_Process was called too late for them
+	uint32_t missed_hops;
+	// Real time spent on a channel (between starts of consecutive hops), in microseconds.
+	// Average is dwell_total_us / hops.
+	uint32_t dwell_min_us;
+	uint32_t dwell_max_us;
+	uint64_t dwell_total_us;
+	// Time taken by the hop (until the radio is on the new channel), in microseconds.
+	// Average is latency_total_us / hops.
+	uint32_t latency_min_us;
+	uint32_t latency_max_us;
+	uint64_t latency_total_us;
+} S2LP_FHSS_Statistics;
+
+typedef struct S2LP_FHSS_t {
+	S2LP_Handle* handle;
+	S2LP_ChannelPlan const* plan;
+
+	// Hop sequence - indices of plan channels
+	uint8_t sequence[S2LP_FHSS_MAX_HOPS];
+	size_t sequence_length;
+	size_t position;
+
+	uint32_t dwell_time_us;
+	// Enter RX after every hop
+	bool listen;
+	bool running;
+	// Scheduled start of current dwell, and real start of the last hop
+	uint32_t slot_start_us;
+	uint32_t hop_start_us;
+
+	S2LP_FHSS_Statistics statistics;
+} S2LP_FHSS;
+
+// Initialize the engine for already applied (or not yet applied) channel plan.
+// Plan has to stay alive as long as the engine uses it.
+void S2LP_FHSS_Init(S2LP_FHSS* fhss, S2LP_Handle* handle, S2LP_ChannelPlan const* plan, uint32_t dwell_time_us);
+
+// Set user-defined hop sequence. Returns false if it's empty, too long or contains channel out of plan.
+bool S2LP_FHSS_SetSequence(S2LP_FHSS* fhss, uint8_t const* channels, size_t length);
+// Generate pseudo-random sequence visiting every channel of the plan exactly once.
+// Same seed gives the same sequence on every node.
+void S2LP_FHSS_GenerateSequence(S2LP_FHSS* fhss, uint32_t seed);
+
+// Apply the plan on the first channel of the sequence and start the hop schedule now.
+// Returns false if there's no sequence.
+bool S2LP_FHSS_Start(S2LP_FHSS* fhss, bool listen);
+// Stop hopping. Radio state is not changed.
+void S2LP_FHSS_Stop(S2LP_FHSS* fhss);
+
+// Hop if the dwell time has passed. If more than one hop was missed, the sequence skips them,
+// so the node stays in sync with the others. Returns true if the hop was done.
+bool S2LP_FHSS_Process(S2LP_FHSS* fhss);
+// Hop to the next channel of the sequence now, and restart the dwell time.
+void S2LP_FHSS_Hop(S2LP_FHSS* fhss);
+
+// Index of the current plan channel
+uint8_t S2LP_FHSS_GetChannel(S2LP_FHSS const* fhss);
+// Time left until the next hop, in microseconds (0 if it's due already)
+uint32_t S2LP_FHSS_GetTimeToHop(S2LP_FHSS* fhss);
+
+void S2LP_FHSS_ResetStatistics(S2LP_FHSS* fhss);
+
+#endif /* S2LP_S2LP_FHSS_H_ */
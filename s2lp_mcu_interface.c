@@ -6,8 +6,8 @@
  */
 
 #include "s2lp_mcu_interface.h"
-#include "main.h"
-#include "cmsis_os.h"
+#include "s2lp_bus.h"
+#include "bit_helpers.h"
 
 #include <string.h>
 
@@ -19,174 +19,604 @@ uint8_t const S2LP_HEADER_BYTE_COMMAND = 0b10000000;
 
 uint32_t const S2LP_RESET_TIMEOUT = 2;
 
-// MCU-specific functions implementation
+// Lock helpers - no-op when lock is not set. Handles on the bus use the bus lock.
 
-void S2LP_InitHandle(S2LP_Handle* handle) {
-	memset(handle->status, 0, 2);
-	memset(handle->tx_buffer, 0, S2LP_TX_BUFFER_SIZE);
-	memset(handle->rx_buffer, 0, S2LP_RX_BUFFER_SIZE);
+static void S2LP_AcquireLock(S2LP_Handle* handle) {
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
 
-	handle->tx_buffer_start = &(handle->tx_buffer[2]);
-	handle->rx_buffer_start = &(handle->rx_buffer[2]);
+	if (device != NULL) {
+		S2LP_Bus_Lock(device->bus);
+	} else if (handle->lock != NULL) {
+		handle->lock->lock(handle->lock_context);
+	}
+}
 
-	handle->frequency = S2LP_CLOCK_FREQ_INVALID;
+static void S2LP_ReleaseLock(S2LP_Handle* handle) {
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
 
-	// You can put your platform init code here
+	if (device != NULL) {
+		S2LP_Bus_Unlock(device->bus);
+	} else if (handle->lock != NULL) {
+		handle->lock->unlock(handle->lock_context);
+	}
 }
 
-void S2LP_GetPin(S2LP_Handle* handle, S2LP_Pin pin, GPIO_TypeDef** port_out, uint16_t* pin_out) {
-	switch (pin) {
-		case S2LP_PIN_CSN:
-			*port_out = handle->gpio_csn_port;
-			*pin_out = handle->gpio_csn_pin;
-			break;
-#ifndef S2LP_SOFTWARE_RESET
-		case S2LP_PIN_SDN:
-			*port_out = handle->gpio_sdn_port;
-			*pin_out = handle->gpio_sdn_pin;
-			break;
-#endif
-		case S2LP_PIN_GPIO_0:
-			*port_out = handle->gpio_port[0];
-			*pin_out = handle->gpio_pin[0];
-			break;
-		case S2LP_PIN_GPIO_1:
-			*port_out = handle->gpio_port[1];
-			*pin_out = handle->gpio_pin[1];
-			break;
-		case S2LP_PIN_GPIO_2:
-			*port_out = handle->gpio_port[2];
-			*pin_out = handle->gpio_pin[2];
-			break;
-		case S2LP_PIN_GPIO_3:
-			*port_out = handle->gpio_port[3];
-			*pin_out = handle->gpio_pin[3];
-			break;
-		default:
+// Register cache helpers
+
+static bool S2LP_IsCached(S2LP_Handle* handle, uint8_t address) {
+	if (!handle->cache_enabled || !S2LP_Registers_IsCacheable(address)) {
+		return false;
+	}
+
+	uint8_t const bit = address % 8;
+	return GETBIT(handle->cache_valid[address / 8], bit) != 0;
+}
+
+static bool S2LP_IsRangeCached(S2LP_Handle* handle, uint8_t start_address, size_t amount) {
+	for (size_t i = 0; i < amount; i++) {
+		if (!S2LP_IsCached(handle, (uint8_t) (start_address + i))) {
+			return false;
+		}
+	}
+
+	return amount > 0;
+}
+
+static bool S2LP_IsPending(S2LP_Handle* handle, uint8_t address) {
+	if (handle->batch_depth == 0 || !S2LP_Registers_IsCacheable(address)) {
+		return false;
+	}
+
+	uint8_t const bit = address % 8;
+	return GETBIT(handle->batch_pending[address / 8], bit) != 0;
+}
+
+// Keep the RF context in sync with registers it depends on
+static void S2LP_UpdateRFContext(S2LP_Handle* handle, size_t reg, uint8_t value) {
+	if (reg == S2LP_REG_SYNT3) {
+		handle->rf_context.band = (S2LP_SynthesizerBand) GETBIT(value, 4);
+	} else if (reg == S2LP_REG_XO_RCO_CONF0) {
+		handle->rf_context.ref_div = GETBIT(value, 3);
+	}
+}
+
+// Copy the data transferred from/to registers into the cache.
+// Register address auto-increments during burst transfers, except for FIFO.
+// Registers with pending writes keep their pending values.
+static void S2LP_UpdateCache(S2LP_Handle* handle, uint8_t address, uint8_t const* data, size_t length) {
+	if (address == S2LP_ADDR_FIFO) {
+		return;
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		size_t const reg = address + i;
+		if (reg >= S2LP_REGISTER_CACHE_SIZE) {
 			break;
+		}
+
+		if (S2LP_IsPending(handle, (uint8_t) reg)) {
+			continue;
+		}
+
+		uint8_t const bit = reg % 8;
+		handle->cache[reg] = data[i];
+		SETBIT(handle->cache_valid[reg / 8], bit);
+		S2LP_UpdateRFContext(handle, reg, data[i]);
 	}
 }
 
-#ifdef __GNUC__
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#endif
-void S2LP_WritePin(S2LP_Handle* handle, S2LP_Pin pin, bool state) {
-	GPIO_TypeDef* gpio_port = NULL;
-	uint16_t gpio_pin = 0;
+// Write batch helpers
+
+// Can the register be re-written with it's cached value to join two bursts?
+static bool S2LP_IsBridgeable(S2LP_Handle* handle, uint8_t address) {
+	return S2LP_IsCached(handle, address) && S2LP_Registers_Exists(address);
+}
 
-	S2LP_GetPin(handle, pin, &gpio_port, &gpio_pin);
+// Send all pending writes as contiguous bursts
+static void S2LP_FlushWriteBatch(S2LP_Handle* handle) {
+	if (handle->batch_depth == 0) {
+		return;
+	}
 
-	if (gpio_port != NULL) {
-		HAL_GPIO_WritePin(gpio_port, gpio_pin, state);
+	// Take a copy of pending bitmap and clear it first, so the writes below
+	// go straight to the chip and update the cache
+	uint8_t pending[sizeof(handle->batch_pending)];
+	memcpy(pending, handle->batch_pending, sizeof(pending));
+	memset(handle->batch_pending, 0, sizeof(handle->batch_pending));
+
+	uint8_t const depth = handle->batch_depth;
+	handle->batch_depth = 0;
+
+	size_t reg = 0;
+	while (reg < S2LP_REGISTER_CACHE_SIZE) {
+		if (!GETBIT(pending[reg / 8], reg % 8)) {
+			reg++;
+			continue;
+		}
+
+		size_t const start = reg;
+		size_t end = reg + 1;
+
+		while (end < S2LP_REGISTER_CACHE_SIZE) {
+			if (GETBIT(pending[end / 8], end % 8)) {
+				end++;
+				continue;
+			}
+
+			// Look for the next pending register after the gap, and check if
+			// all the registers in gap have known values
+			size_t gap_end = end;
+			while (gap_end < S2LP_REGISTER_CACHE_SIZE && gap_end - end < S2LP_WRITE_BATCH_MAX_GAP
+					&& !GETBIT(pending[gap_end / 8], gap_end % 8)
+					&& S2LP_IsBridgeable(handle, (uint8_t) gap_end)) {
+				gap_end++;
+			}
+
+			if (gap_end < S2LP_REGISTER_CACHE_SIZE && GETBIT(pending[gap_end / 8], gap_end % 8)) {
+				end = gap_end;
+			} else {
+				break;
+			}
+		}
+
+		S2LP_BatchWriteRegisters(handle, (S2LP_Register) start, &(handle->cache[start]), end - start);
+		reg = end;
 	}
+
+	handle->batch_depth = depth;
 }
 
-#ifdef __GNUC__
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#endif
-bool S2LP_ReadPin(S2LP_Handle* handle, S2LP_Pin pin) {
-	GPIO_TypeDef* gpio_port = NULL;
-	uint16_t gpio_pin = 0;
+// Store writes in the batch. Returns false if the range is not batchable,
+// in which case the pending writes are flushed, and caller should do the write.
+static bool S2LP_StageWrite(S2LP_Handle* handle, uint8_t address, uint8_t const* data, size_t amount) {
+	if (handle->batch_depth == 0) {
+		return false;
+	}
 
-	S2LP_GetPin(handle, pin, &gpio_port, &gpio_pin);
+	if (amount == 0 || (size_t) address + amount > S2LP_REGISTER_CACHE_SIZE) {
+		S2LP_FlushWriteBatch(handle);
+		return false;
+	}
 
-	if (gpio_port != NULL) {
-		return (HAL_GPIO_ReadPin(gpio_port, gpio_pin));
+	for (size_t i = 0; i < amount; i++) {
+		uint8_t const reg = (uint8_t) (address + i);
+		uint8_t const bit = reg % 8;
+		handle->cache[reg] = data[i];
+		SETBIT(handle->cache_valid[reg / 8], bit);
+		SETBIT(handle->batch_pending[reg / 8], bit);
+		S2LP_UpdateRFContext(handle, reg, data[i]);
 	}
 
-	return (false);
+	return true;
 }
 
-void S2LP_Write(S2LP_Handle* handle, uint8_t address, size_t length) {
-	handle->tx_buffer[0] = S2LP_HEADER_BYTE_WRITE;
-	handle->tx_buffer[1] = address;
+// Transfer the header of transaction, and update the status
+static void S2LP_TransferHeader(S2LP_Handle* handle, uint8_t header, uint8_t address) {
+	handle->tx_header[0] = header;
+	handle->tx_header[1] = address;
 
-	// ACTUAL PLATFORM CODE START
-	taskENTER_CRITICAL();
-	HAL_SPI_TransmitReceive(handle->spi, &(handle->tx_buffer[0]), &(handle->rx_buffer[0]), (uint16_t) (length + 2),
-	HAL_MAX_DELAY);
-	taskEXIT_CRITICAL();
-	// ACTUAL PLATFORM CODE END
+	handle->transport->transfer(handle->transport_context, handle->tx_header, handle->rx_header,
+			S2LP_HEADER_SIZE);
 
 	// First two bytes are S2-LP status bits, so we copy them (in reverse order)
-	handle->status[0] = handle->rx_buffer[1];
-	handle->status[1] = handle->rx_buffer[0];
+	handle->status[0] = handle->rx_header[1];
+	handle->status[1] = handle->rx_header[0];
 }
 
-void S2LP_Read(S2LP_Handle* handle, uint8_t address, size_t amount) {
-	handle->tx_buffer[0] = S2LP_HEADER_BYTE_READ;
-	handle->tx_buffer[1] = address;
+// Asynchronous transactions helpers
 
-	// ACTUAL PLATFORM CODE START
-	taskENTER_CRITICAL();
-	HAL_SPI_TransmitReceive(handle->spi, &(handle->tx_buffer[0]), &(handle->rx_buffer[0]), (uint16_t) (amount + 2),
-	HAL_MAX_DELAY);
-	taskEXIT_CRITICAL();
-	// ACTUAL PLATFORM CODE END
+// Release chip select and complete the transaction on the top of the queue
+static void S2LP_FinishTransaction(S2LP_Handle* handle) {
+	S2LP_Transaction* const transaction = handle->queue_head;
+	S2LP_WritePin(handle, S2LP_PIN_CSN, true);
 
-	handle->status[0] = handle->rx_buffer[1];
-	handle->status[1] = handle->rx_buffer[0];
+	transaction->status[0] = handle->status[0];
+	transaction->status[1] = handle->status[1];
+
+	switch (transaction->type) {
+		case S2LP_TRANSACTION_READ:
+		case S2LP_TRANSACTION_WRITE:
+			S2LP_UpdateCache(handle, transaction->address, transaction->data, transaction->length);
+			break;
+		case S2LP_TRANSACTION_COMMAND:
+			// Software reset brings all the registers back to their default values
+			if (transaction->address == S2LP_CMD_SRES) {
+				S2LP_LoadRegisterCacheDefaults(handle);
+			}
+			break;
+	}
+
+	handle->queue_head = transaction->next;
+	if (handle->queue_head == NULL) {
+		handle->queue_tail = NULL;
+	}
+
+	transaction->done = true;
+	if (transaction->callback != NULL) {
+		transaction->callback(handle, transaction);
+	}
 }
 
-void S2LP_SendCommand(S2LP_Handle* handle, uint8_t command) {
-	handle->tx_buffer[0] = S2LP_HEADER_BYTE_COMMAND;
-	handle->tx_buffer[1] = command;
+// Put the queued transactions on the bus, until one of them goes asynchronous.
+// On the shared bus, it's up to the arbiter to decide which one goes first.
+static void S2LP_StartTransactions(S2LP_Handle* handle) {
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
+	if (device != NULL) {
+		S2LP_Bus_Schedule(device->bus);
+		return;
+	}
+
+	while (!handle->transfer_active && handle->queue_head != NULL) {
+		S2LP_StartQueuedTransaction(handle);
+	}
+}
+
+static void S2LP_EnqueueTransaction(S2LP_Handle* handle, S2LP_Transaction* transaction) {
+	transaction->done = false;
+	transaction->next = NULL;
+
+	if (handle->queue_head == NULL) {
+		handle->queue_head = transaction;
+	} else {
+		handle->queue_tail->next = transaction;
+	}
+	handle->queue_tail = transaction;
+
+	S2LP_StartTransactions(handle);
+}
+
+// Run the transaction synchronously, after everything that's already queued
+static void S2LP_ExecuteTransaction(S2LP_Handle* handle, S2LP_TransactionType type, uint8_t address,
+		uint8_t* data, size_t length) {
+	S2LP_Transaction transaction;
+	S2LP_InitTransaction(&transaction, type, address, data, length, NULL, NULL);
+	S2LP_EnqueueTransaction(handle, &transaction);
+	S2LP_WaitTransaction(handle, &transaction);
+}
+
+// Platform-independent implementation, everything goes through the transport
+
+void S2LP_InitHandle(S2LP_Handle* handle) {
+	handle->lock = NULL;
+	handle->lock_context = NULL;
+
+	memset(handle->status, 0, 2);
+	memset(handle->tx_header, 0, S2LP_HEADER_SIZE);
+	memset(handle->rx_header, 0, S2LP_HEADER_SIZE);
+
+	handle->frequency = S2LP_CLOCK_FREQ_INVALID;
+	S2LP_RFCalc_InitContext(&(handle->rf_context), S2LP_CLOCK_FREQ_INVALID, S2LP_SYNTH_BAND_HIGH, false);
+
+#ifdef S2LP_REGISTER_CACHE
+	handle->cache_enabled = true;
+#else
+	handle->cache_enabled = false;
+#endif
+	S2LP_InvalidateRegisterCache(handle);
+
+	handle->batch_depth = 0;
+	memset(handle->batch_pending, 0, sizeof(handle->batch_pending));
+
+	handle->queue_head = NULL;
+	handle->queue_tail = NULL;
+	handle->transfer_active = false;
+}
 
-	// ACTUAL PLATFORM CODE START
-	S2LP_Select(handle);
-	taskENTER_CRITICAL();
-	HAL_SPI_TransmitReceive(handle->spi, &(handle->tx_buffer[0]), &(handle->rx_buffer[0]), 2,
-	HAL_MAX_DELAY);
-	taskEXIT_CRITICAL();
-	S2LP_Deselect(handle);
-	// ACTUAL PLATFORM CODE END
+void S2LP_SetLock(S2LP_Handle* handle, S2LP_Lock const* lock, void* lock_context) {
+	handle->lock = lock;
+	handle->lock_context = lock_context;
+}
+
+void S2LP_WritePin(S2LP_Handle* handle, S2LP_Pin pin, bool state) {
+	handle->transport->write_pin(handle->transport_context, pin, state);
+}
+
+bool S2LP_ReadPin(S2LP_Handle* handle, S2LP_Pin pin) {
+	return handle->transport->read_pin(handle->transport_context, pin);
+}
+
+void S2LP_Write(S2LP_Handle* handle, uint8_t address, uint8_t const* data, size_t length) {
+	S2LP_TransferHeader(handle, S2LP_HEADER_BYTE_WRITE, address);
+	handle->transport->transfer(handle->transport_context, data, NULL, length);
+	S2LP_UpdateCache(handle, address, data, length);
+}
+
+void S2LP_Read(S2LP_Handle* handle, uint8_t address, uint8_t* output, size_t amount) {
+	S2LP_TransferHeader(handle, S2LP_HEADER_BYTE_READ, address);
+	handle->transport->transfer(handle->transport_context, NULL, output, amount);
+	S2LP_UpdateCache(handle, address, output, amount);
+}
 
-	handle->status[0] = handle->rx_buffer[1];
-	handle->status[1] = handle->rx_buffer[0];
+void S2LP_SendCommand(S2LP_Handle* handle, uint8_t command) {
+	S2LP_AcquireLock(handle);
+	S2LP_FlushWriteBatch(handle);
+	S2LP_ExecuteTransaction(handle, S2LP_TRANSACTION_COMMAND, command, NULL, 0);
+	S2LP_ReleaseLock(handle);
 }
 
 uint8_t S2LP_ReadRegister(S2LP_Handle* handle, S2LP_Register address) {
-	S2LP_Select(handle);
-	S2LP_Read(handle, address, 1);
-	S2LP_Deselect(handle);
-	return handle->rx_buffer_start[0];
+	uint8_t value = 0;
+	S2LP_AcquireLock(handle);
+
+	// Queued writes have to land in the cache first
+	S2LP_WaitAllTransactions(handle);
+
+	if (S2LP_IsPending(handle, address) || S2LP_IsCached(handle, address)) {
+		value = handle->cache[address];
+	} else {
+		S2LP_Select(handle);
+		S2LP_Read(handle, address, &value, 1);
+		S2LP_Deselect(handle);
+	}
+
+	S2LP_ReleaseLock(handle);
+	return value;
 }
 
 void S2LP_WriteRegister(S2LP_Handle* handle, S2LP_Register address, uint8_t new_value) {
-	handle->tx_buffer_start[0] = new_value;
-	S2LP_Select(handle);
-	S2LP_Write(handle, address, 1);
-	S2LP_Deselect(handle);
+	S2LP_AcquireLock(handle);
+
+	if (!S2LP_StageWrite(handle, address, &new_value, 1)) {
+		S2LP_Select(handle);
+		S2LP_Write(handle, address, &new_value, 1);
+		S2LP_Deselect(handle);
+	}
+
+	S2LP_ReleaseLock(handle);
 }
 
 void S2LP_BatchReadRegisters(S2LP_Handle* handle, S2LP_Register start_address, uint8_t* output, size_t amount) {
-	S2LP_Select(handle);
-	S2LP_Read(handle, start_address, amount);
-	S2LP_Deselect(handle);
-	memcpy(output, handle->rx_buffer_start, amount);
+	S2LP_AcquireLock(handle);
+	S2LP_WaitAllTransactions(handle);
+
+	if (S2LP_IsRangeCached(handle, start_address, amount)) {
+		memcpy(output, &(handle->cache[start_address]), amount);
+	} else {
+		S2LP_ExecuteTransaction(handle, S2LP_TRANSACTION_READ, start_address, output, amount);
+
+		// Chip doesn't know about pending writes yet
+		for (size_t i = 0; i < amount; i++) {
+			uint8_t const reg = (uint8_t) (start_address + i);
+			if (S2LP_IsPending(handle, reg)) {
+				output[i] = handle->cache[reg];
+			}
+		}
+	}
+
+	S2LP_ReleaseLock(handle);
 }
 
 void S2LP_BatchWriteRegisters(S2LP_Handle* handle, S2LP_Register start_address, uint8_t* data, size_t amount) {
-	memcpy(handle->tx_buffer_start, data, amount);
-	S2LP_Select(handle);
-	S2LP_Write(handle, start_address, amount);
-	S2LP_Deselect(handle);
+	S2LP_AcquireLock(handle);
+
+	if (!S2LP_StageWrite(handle, start_address, data, amount)) {
+		S2LP_ExecuteTransaction(handle, S2LP_TRANSACTION_WRITE, start_address, data, amount);
+	}
+
+	S2LP_ReleaseLock(handle);
+}
+
+bool S2LP_PeekRegister(S2LP_Handle* handle, S2LP_Register address, uint8_t* value) {
+	if (!S2LP_IsPending(handle, address) && !S2LP_IsCached(handle, address)) {
+		return false;
+	}
+
+	*value = handle->cache[address];
+	return true;
+}
+
+void S2LP_SetRegisterCacheState(S2LP_Handle* handle, bool enabled) {
+	S2LP_AcquireLock(handle);
+
+	if (enabled && !handle->cache_enabled) {
+		S2LP_InvalidateRegisterCache(handle);
+	}
+
+	handle->cache_enabled = enabled;
+	S2LP_ReleaseLock(handle);
+}
+
+bool S2LP_GetRegisterCacheState(S2LP_Handle* handle) {
+	return handle->cache_enabled;
+}
+
+void S2LP_InvalidateRegisterCache(S2LP_Handle* handle) {
+	memset(handle->cache_valid, 0, sizeof(handle->cache_valid));
+}
+
+void S2LP_LoadRegisterCacheDefaults(S2LP_Handle* handle) {
+	// Undocumented addresses are left invalid, so they will always go to the chip
+	S2LP_InvalidateRegisterCache(handle);
+
+	for (size_t i = 0; i < S2LP_REGISTER_COUNT; i++) {
+		uint8_t const address = S2LP_REGISTER_MAP[i].address;
+		if (!S2LP_Registers_IsCacheable(address)) {
+			break;
+		}
+
+		uint8_t const bit = address % 8;
+		handle->cache[address] = S2LP_REGISTER_MAP[i].default_value;
+		SETBIT(handle->cache_valid[address / 8], bit);
+	}
+
+	// RF context follows the reset values too
+	S2LP_UpdateRFContext(handle, S2LP_REG_SYNT3, S2LP_REG_DEFAULT_SYNT3);
+	S2LP_UpdateRFContext(handle, S2LP_REG_XO_RCO_CONF0, S2LP_REG_DEFAULT_XO_RCO_CONF0);
+}
+
+void S2LP_BeginWriteBatch(S2LP_Handle* handle) {
+	// Lock is held until commit, so the batch (and read-modify-write
+	// operations inside it) can't interleave with other threads
+	S2LP_AcquireLock(handle);
+	handle->batch_depth++;
+}
+
+void S2LP_CommitWriteBatch(S2LP_Handle* handle) {
+	if (handle->batch_depth == 0) {
+		return;
+	}
+
+	if (handle->batch_depth == 1) {
+		S2LP_FlushWriteBatch(handle);
+	}
+
+	handle->batch_depth--;
+	S2LP_ReleaseLock(handle);
+}
+
+void S2LP_InitTransaction(S2LP_Transaction* transaction, S2LP_TransactionType type, uint8_t address,
+		uint8_t* data, size_t length, S2LP_TransactionCallback callback, void* user_data) {
+	transaction->type = type;
+	transaction->address = address;
+	transaction->data = data;
+	transaction->length = (type == S2LP_TRANSACTION_COMMAND ? 0 : length);
+	transaction->callback = callback;
+	transaction->user_data = user_data;
+	transaction->done = false;
+
+	// Draining RX FIFO is the most urgent, as it can overflow
+	if (address == S2LP_ADDR_FIFO && type == S2LP_TRANSACTION_READ) {
+		transaction->priority = S2LP_PRIORITY_HIGH;
+	} else if (address == S2LP_ADDR_FIFO || type == S2LP_TRANSACTION_COMMAND) {
+		transaction->priority = S2LP_PRIORITY_NORMAL;
+	} else {
+		transaction->priority = S2LP_PRIORITY_LOW;
+	}
+
+	transaction->status[0] = 0;
+	transaction->status[1] = 0;
+	transaction->next = NULL;
+}
+
+bool S2LP_SubmitTransaction(S2LP_Handle* handle, S2LP_Transaction* transaction) {
+	if (transaction->data == NULL && transaction->length > 0) {
+		return false;
+	}
+
+	S2LP_AcquireLock(handle);
+	// Pending batched writes go first, to keep the order of operations
+	S2LP_FlushWriteBatch(handle);
+	S2LP_EnqueueTransaction(handle, transaction);
+	S2LP_ReleaseLock(handle);
+	return true;
+}
+
+bool S2LP_PollTransactions(S2LP_Handle* handle) {
+	S2LP_AcquireLock(handle);
+
+	// On the shared bus, the transfer in progress can belong to another device
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
+	if (device != NULL) {
+		S2LP_Bus_Poll(device->bus);
+	} else if (handle->transfer_active && handle->transport->transfer_poll != NULL
+			&& handle->transport->transfer_poll(handle->transport_context)) {
+		S2LP_OnTransferComplete(handle);
+	}
+
+	bool const empty = (handle->queue_head == NULL);
+	S2LP_ReleaseLock(handle);
+	return empty;
+}
+
+void S2LP_WaitTransaction(S2LP_Handle* handle, S2LP_Transaction* transaction) {
+	while (!transaction->done) {
+		S2LP_PollTransactions(handle);
+	}
+}
+
+void S2LP_WaitAllTransactions(S2LP_Handle* handle) {
+	while (!S2LP_PollTransactions(handle)) {
+	}
+}
+
+void S2LP_OnTransferComplete(S2LP_Handle* handle) {
+	if (!handle->transfer_active) {
+		return;
+	}
+
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
+	if (device != NULL) {
+		S2LP_Bus_OnTransferComplete(device->bus);
+		return;
+	}
+
+	S2LP_FinishQueuedTransaction(handle);
+	S2LP_StartTransactions(handle);
+}
+
+bool S2LP_StartQueuedTransaction(S2LP_Handle* handle) {
+	S2LP_Transaction* const transaction = handle->queue_head;
+	uint8_t const* tx_data = NULL;
+	uint8_t* rx_data = NULL;
+	uint8_t header = S2LP_HEADER_BYTE_COMMAND;
+
+	switch (transaction->type) {
+		case S2LP_TRANSACTION_READ:
+			header = S2LP_HEADER_BYTE_READ;
+			rx_data = transaction->data;
+			break;
+		case S2LP_TRANSACTION_WRITE:
+			header = S2LP_HEADER_BYTE_WRITE;
+			tx_data = transaction->data;
+			break;
+		case S2LP_TRANSACTION_COMMAND:
+			break;
+	}
+
+	// Header is short, so it's always transferred synchronously
+	S2LP_WritePin(handle, S2LP_PIN_CSN, false);
+	S2LP_TransferHeader(handle, header, transaction->address);
+
+	if (transaction->length > 0) {
+		if (handle->transport->transfer_start != NULL) {
+			handle->transfer_active = true;
+			handle->transport->transfer_start(handle->transport_context, tx_data, rx_data,
+					transaction->length);
+			return true;
+		}
+
+		handle->transport->transfer(handle->transport_context, tx_data, rx_data, transaction->length);
+	}
+
+	S2LP_FinishTransaction(handle);
+	return false;
+}
+
+void S2LP_FinishQueuedTransaction(S2LP_Handle* handle) {
+	handle->transfer_active = false;
+	S2LP_FinishTransaction(handle);
 }
 
 void S2LP_Select(S2LP_Handle* handle) {
+	S2LP_AcquireLock(handle);
+	// Bus has to be free before we take it
+	S2LP_WaitAllTransactions(handle);
+
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
+	if (device != NULL) {
+		S2LP_Bus_Claim(device->bus, device);
+	}
+
 	S2LP_WritePin(handle, S2LP_PIN_CSN, false);
 }
 
 void S2LP_Deselect(S2LP_Handle* handle) {
 	S2LP_WritePin(handle, S2LP_PIN_CSN, true);
+
+	S2LP_BusDevice* const device = S2LP_Bus_GetDevice(handle);
+	if (device != NULL) {
+		S2LP_Bus_Release(device->bus);
+	}
+
+	S2LP_ReleaseLock(handle);
 }
 
 void S2LP_Reset(S2LP_Handle* handle) {
 #ifndef S2LP_SOFTWARE_RESET
 	S2LP_Shutdown(handle);
-	S2LP_Delay(S2LP_RESET_TIMEOUT);
+	S2LP_Delay(handle, S2LP_RESET_TIMEOUT);
 	S2LP_Wakeup(handle);
-	S2LP_Delay(S2LP_RESET_TIMEOUT);
+	S2LP_Delay(handle, S2LP_RESET_TIMEOUT);
 #else
 	S2LP_SendCommand(handle, S2LP_CMD_SRES);
 #endif
@@ -195,13 +625,25 @@ void S2LP_Reset(S2LP_Handle* handle) {
 #ifndef S2LP_SOFTWARE_RESET
 void S2LP_Shutdown(S2LP_Handle* handle) {
 	S2LP_WritePin(handle, S2LP_PIN_SDN, true);
+	// Registers are lost in shutdown
+	S2LP_InvalidateRegisterCache(handle);
 }
 
 void S2LP_Wakeup(S2LP_Handle* handle) {
 	S2LP_WritePin(handle, S2LP_PIN_SDN, false);
+	// After wakeup, S2-LP goes through power-on reset
+	S2LP_LoadRegisterCacheDefaults(handle);
 }
 #endif
 
-void S2LP_Delay(uint32_t milliseconds) {
-	osDelay(milliseconds);
+void S2LP_Delay(S2LP_Handle* handle, uint32_t milliseconds) {
+	handle->transport->delay(handle->transport_context, milliseconds);
+}
+
+uint32_t S2LP_GetTime(S2LP_Handle* handle) {
+	if (handle->transport->get_time_us == NULL) {
+		return 0;
+	}
+
+	return handle->transport->get_time_us(handle->transport_context);
 }
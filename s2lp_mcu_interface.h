@@ -8,36 +8,156 @@
 #ifndef S2LP_S2LP_MCU_INTERFACE_H_
 #define S2LP_S2LP_MCU_INTERFACE_H_
 
-// The size of internal S2LP IO buffer, stored in the handle.
-#define S2LP_TX_BUFFER_SIZE 130
-#define S2LP_RX_BUFFER_SIZE 130
+// The size of transaction header - header byte and address/command going out,
+// and S2-LP status bytes coming in.
+#define S2LP_HEADER_SIZE 2
 
 #include "s2lp_constants.h"
+#include "s2lp_registers.h"
+#include "s2lp_rf_calc.h"
 
 // If your toolchain does not have stdbool.h, implement
 // the boolean value with enum or macro
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-#include <stm32l4xx.h>
-
 // In case when S2-LP CSD (shutdown) pin is not avaialble,
 // the library can issue software reset via SRES command
 // Define S2LP_SOFTWARE_RESET to enable this behaviour,
 // instead of using GPIO to reset spirit.
 #define S2LP_SOFTWARE_RESET 1
 
+// Register cache keeps a write-through copy of configuration registers in the
+// handle, so reads of these registers (and read-modify-write operations done by
+// setters) don't need any SPI transfers. Volatile registers (state, IRQ, RSSI,
+// FIFO, link quality...) are always read from the chip.
+// Define S2LP_REGISTER_CACHE to enable the cache by default in every handle,
+// it can also be toggled per-handle with S2LP_SetRegisterCacheState.
+// Keep in mind that the cache assumes that the library is the only one
+// changing S2-LP configuration - if the chip is reset or reconfigured in any
+// other way, call S2LP_InvalidateRegisterCache.
+#define S2LP_REGISTER_CACHE 1
+
+// Fixed-point math - RF coefficients (datarate, frequency deviation, synthesizer word, ...)
+// are calculated exactly with 64-bit integers instead of double, so the setters don't need
+// floating point support, which is slow and big on MCUs without FPU. Functions returning
+// physical values as double convert the result only at the end.
+// Define S2LP_FIXED_POINT_MATH to enable it. Defining S2LP_FLOATING_POINT_MATH (e.g. in compiler
+// flags) keeps it disabled, so both implementations can be built and compared.
+#ifndef S2LP_FLOATING_POINT_MATH
+#define S2LP_FIXED_POINT_MATH 1
+#endif
+
+// The size of register cache, covers all configuration registers
+#define S2LP_REGISTER_CACHE_SIZE S2LP_CONFIG_REGISTERS_END
+
+// When committing write batch, gaps between pending registers up to this size
+// are filled with known (cached) values of registers in between, if possible.
+// Re-writing a register with it's current value costs 1 byte on the bus, while
+// starting a new burst costs 2 header bytes and chip select toggle.
+#define S2LP_WRITE_BATCH_MAX_GAP 2
+
+// Transport backend - set of platform-specific operations used by the library
+// to talk to S2-LP. Every operation gets the `context` pointer stored in the handle,
+// so the backend can keep it's own state there (SPI peripheral, pins, emulated chip, ...).
+// Backends shipped with the library:
+// * STM32 HAL - s2lp_transport_stm32.h
+// * Linux spidev + GPIO character device - s2lp_transport_linux.h
+typedef struct S2LP_Transport_t {
+	// Full-duplex SPI transfer of `length` bytes. Chip select is controlled by
+	// the library via write_pin, so don't touch it here - single transaction is
+	// made of multiple transfers (header, then data directly from/to user buffer).
+	// tx_data can be NULL (send anything, S2-LP ignores it), and rx_data can be
+	// NULL (discard received data).
+	void (*transfer)(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length);
+
+	// MCU GPIO I/O. Ignore the pins that are not connected.
+	void (*write_pin)(void* context, S2LP_Pin pin, bool state);
+	bool (*read_pin)(void* context, S2LP_Pin pin);
+
+	// Millisecond delay
+	void (*delay)(void* context, uint32_t milliseconds);
+
+	// Monotonic time source, in microseconds. Can be NULL if not available.
+	uint32_t (*get_time_us)(void* context);
+
+	// Optional non-blocking transfer (DMA, interrupt-driven SPI), used for the data
+	// part of asynchronous transactions. Same rules as for `transfer`. Starts the transfer
+	// and returns immediately. The end of transfer is reported either by transfer_poll
+	// returning true, or by calling S2LP_OnTransferComplete (for example from DMA
+	// interrupt) - use only one of these. Don't report completion from inside transfer_start.
+	// Leave NULL if not supported - asynchronous transactions will use `transfer` then.
+	void (*transfer_start)(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length);
+	// Optional. Returns true when the transfer started with transfer_start is finished.
+	bool (*transfer_poll)(void* context);
+} S2LP_Transport;
+
+// Lock protecting the handle (I/O buffers, register cache, transaction queue) and
+// chip select line, when the handle is used from multiple threads. The lock has to
+// be recursive - it's held by the thread from S2LP_Select to S2LP_Deselect and from
+// S2LP_BeginWriteBatch to S2LP_CommitWriteBatch, and library functions nest.
+// Handles sharing the SPI bus should share the lock context too, or use the bus
+// arbiter (s2lp_bus.h), which has it's own lock.
+// Available implementations:
+// * RTOS recursive mutex - s2lp_transport_stm32.h
+// * pthread recursive mutex and spinlock - s2lp_transport_linux.h
+// For single-threaded builds, don't set any lock.
+typedef struct S2LP_Lock_t {
+	void (*lock)(void* context);
+	void (*unlock)(void* context);
+} S2LP_Lock;
+
+// Asynchronous transactions - every transaction is a single chip select frame.
+// Transactions are owned by the caller and must stay alive until they are done,
+// the handle only keeps a queue of pointers to them.
+typedef enum S2LP_TransactionType_t {
+	S2LP_TRANSACTION_READ, S2LP_TRANSACTION_WRITE, S2LP_TRANSACTION_COMMAND
+} S2LP_TransactionType;
+
+// Priority of transaction on the shared bus (see s2lp_bus.h). Transactions of a single
+// handle are always executed in order, priorities decide which device goes next.
+// S2LP_InitTransaction sets the default priority - high for RX FIFO reads, normal for
+// TX FIFO writes and commands, and low for register access.
+typedef enum S2LP_TransactionPriority_t {
+	S2LP_PRIORITY_LOW, S2LP_PRIORITY_NORMAL, S2LP_PRIORITY_HIGH
+} S2LP_TransactionPriority;
+
+typedef struct S2LP_Transaction_t S2LP_Transaction;
+struct S2LP_Handle_t;
+
+// Called when transaction is done. If completion is reported by interrupt,
+// the callback is called from the interrupt context, so keep it short.
+typedef void (*S2LP_TransactionCallback)(struct S2LP_Handle_t* handle, S2LP_Transaction* transaction);
+
+struct S2LP_Transaction_t {
+	// Set by the user, see S2LP_InitTransaction
+	S2LP_TransactionType type;
+	// Register address, or command for S2LP_TRANSACTION_COMMAND
+	uint8_t address;
+	// Data to write, or buffer for read data. Not used by commands.
+	uint8_t* data;
+	size_t length;
+	S2LP_TransactionCallback callback;
+	void* user_data;
+	// Can be changed after S2LP_InitTransaction
+	S2LP_TransactionPriority priority;
+
+	// Set by the library
+	volatile bool done;
+	// Status bytes received during this transaction (same order as handle status)
+	uint8_t status[2];
+	S2LP_Transaction* next;
+};
+
 typedef struct S2LP_Handle_t {
 	// S2-LP common handle fields - don't modify directly!
 	uint8_t status[2];
-	uint8_t tx_buffer[S2LP_TX_BUFFER_SIZE];
-	uint8_t rx_buffer[S2LP_RX_BUFFER_SIZE];
 
-	// Since TX and RX buffer are modified by low-level functions below,
-	// these two pointers will be initialized to addresses of
-	// buffers that are safe to use by API functions
-	uint8_t* tx_buffer_start;
-	uint8_t const* rx_buffer_start;
+	// Transaction header buffers. Transaction data is transferred directly
+	// from/to the user buffers, without copying it through the handle.
+	uint8_t tx_header[S2LP_HEADER_SIZE];
+	uint8_t rx_header[S2LP_HEADER_SIZE];
 
 	// Additional data required for library to calculate some
 	// stuff correctly
@@ -45,45 +165,64 @@ typedef struct S2LP_Handle_t {
 	// S2-LP oscillator frequency, going into XIN input
 	S2LP_ClockFrequency frequency;
 
-	// Add your platform fields down below.
-	// SPI for communication
-	SPI_HandleTypeDef* spi;
+	// Context of RF calculations. Synthesizer band and reference divider state follow
+	// every transfer of SYNT3 and XO_RCO_CONF0 (also with register cache disabled), so
+	// setters don't have to read them. See S2LP_RF_GetContext.
+	S2LP_RF_Context rf_context;
 
-	// Chip select pin
-	GPIO_TypeDef* gpio_csn_port;
-	uint16_t gpio_csn_pin;
+	// Register cache - copy of configuration registers, and bitmap of
+	// registers which values are known
+	bool cache_enabled;
+	uint8_t cache[S2LP_REGISTER_CACHE_SIZE];
+	uint8_t cache_valid[(S2LP_REGISTER_CACHE_SIZE + 7) / 8];
 
-	// Shutdown pin
-#ifndef S2LP_SOFTWARE_RESET
-	GPIO_TypeDef* gpio_sdn_port;
-	uint16_t gpio_sdn_pin;
-#endif
+	// Write batch - nesting depth, and bitmap of registers waiting to be written.
+	// Pending values are stored in the cache array.
+	uint8_t batch_depth;
+	uint8_t batch_pending[(S2LP_REGISTER_CACHE_SIZE + 7) / 8];
+
+	// Asynchronous transactions queue. The first transaction is the one on the bus.
+	S2LP_Transaction* volatile queue_head;
+	S2LP_Transaction* queue_tail;
+	volatile bool transfer_active;
+
+	// Platform fields - set them up before calling S2LP_Initialize.
+	// Transport backend and it's context, passed to every transport operation.
+	S2LP_Transport const* transport;
+	void* transport_context;
 
-	// GPIO
-	GPIO_TypeDef* gpio_port[4];
-	uint16_t gpio_pin[4];
+	// Optional lock, see S2LP_SetLock
+	S2LP_Lock const* lock;
+	void* lock_context;
 } S2LP_Handle;
 
-// Functions below are implemented for STM32 HAL by default
-// change them for your preferred platform if you need
+// Functions below are platform-independent, all the platform-specific stuff
+// is done via transport backend stored in the handle.
 
-// Init the handle. Don't change the default implementation, just add your
-// own code after it.
+// Init the handle. Does not touch the transport fields, and removes the lock.
 void S2LP_InitHandle(S2LP_Handle* handle);
 
+// Set the lock used by the handle (NULL to disable locking). Do it after
+// S2LP_Initialize, before the handle is shared between threads.
+// Handles attached to the bus use the bus lock instead, see S2LP_Bus_SetLock.
+void S2LP_SetLock(S2LP_Handle* handle, S2LP_Lock const* lock, void* lock_context);
+
 // MCU GPIO I/O operations
 void S2LP_WritePin(S2LP_Handle* handle, S2LP_Pin pin, bool state);
 bool S2LP_ReadPin(S2LP_Handle* handle, S2LP_Pin pin);
 
-// These functions will use internal buffer from handle to store/read data.
-// The address for Write/Read operations should be stored in the first byte of I/O buffer
-void S2LP_Write(S2LP_Handle* handle, uint8_t address, size_t length);
-void S2LP_Read(S2LP_Handle* handle, uint8_t address, size_t amount);
+// Raw register/FIFO access. These have to be called between S2LP_Select and S2LP_Deselect.
+// Data is transferred directly from/to the provided buffer, the length is not limited.
+void S2LP_Write(S2LP_Handle* handle, uint8_t address, uint8_t const* data, size_t length);
+void S2LP_Read(S2LP_Handle* handle, uint8_t address, uint8_t* output, size_t amount);
 void S2LP_SendCommand(S2LP_Handle* handle, uint8_t command);
 
-// Millisecond delay. Make sure to use the correct one, depending on whether you use
-// RTOS (osDelay in that case), or not (HAL_Delay or your own implementation in that case)
-void S2LP_Delay(uint32_t milliseconds);
+// Millisecond delay, done by transport backend
+void S2LP_Delay(S2LP_Handle* handle, uint32_t milliseconds);
+
+// Current time in microseconds, from transport backend time source.
+// Returns 0 if backend has no time source.
+uint32_t S2LP_GetTime(S2LP_Handle* handle);
 
 // These are additional functions that depend directly on the functions above, so you
 // don't have to worry about reimplementing them.
@@ -103,7 +242,63 @@ void S2LP_BatchReadRegisters(S2LP_Handle* handle, S2LP_Register start_address,
 void S2LP_BatchWriteRegisters(S2LP_Handle* handle, S2LP_Register start_address,
 		uint8_t* data, size_t amount);
 
-// Chip select control
+// Get the register value known by the handle (cached, or waiting in write batch) without
+// touching the chip. Returns false if the value is not known.
+bool S2LP_PeekRegister(S2LP_Handle* handle, S2LP_Register address, uint8_t* value);
+
+// Register cache control. Disabling the cache does not drop it's content, but
+// enabling it invalidates it, since the chip could've been changed in the meantime.
+void S2LP_SetRegisterCacheState(S2LP_Handle* handle, bool enabled);
+bool S2LP_GetRegisterCacheState(S2LP_Handle* handle);
+// Forget all cached values, next access to every register will go to the chip.
+void S2LP_InvalidateRegisterCache(S2LP_Handle* handle);
+// Fill the cache with reset values of registers, and RF context with reset
+// synthesizer band and reference divider state. Called automatically after
+// reset done by the library.
+void S2LP_LoadRegisterCacheDefaults(S2LP_Handle* handle);
+
+// Write batch - configuration register writes done between Begin and Commit
+// are not sent immediately, but recorded in the handle. Commit sends them as
+// the minimal amount of burst writes over contiguous address ranges.
+// Batches can be nested, the data is sent when the outermost batch is committed.
+// Reads of pending registers return the pending values. Commands, writes to
+// non-configuration registers (FIFO, IRQ...) flush the pending writes first,
+// so the order of operations visible by S2-LP is preserved.
+void S2LP_BeginWriteBatch(S2LP_Handle* handle);
+void S2LP_CommitWriteBatch(S2LP_Handle* handle);
+
+// Asynchronous transactions.
+// Transactions are executed in order of submission. The header goes synchronously,
+// the data part is transferred with transport's transfer_start directly from/to
+// transaction buffer, if available.
+// Synchronous functions wait for all the queued transactions before touching the bus,
+// so they can be freely mixed with asynchronous ones (but not from interrupts).
+// Submitting and completion (S2LP_OnTransferComplete) must not run concurrently -
+// when completion is reported from interrupt, submit with that interrupt masked.
+void S2LP_InitTransaction(S2LP_Transaction* transaction, S2LP_TransactionType type, uint8_t address,
+		uint8_t* data, size_t length, S2LP_TransactionCallback callback, void* user_data);
+// Queue the transaction. Returns false if it's invalid (no data buffer) - it won't be executed then.
+bool S2LP_SubmitTransaction(S2LP_Handle* handle, S2LP_Transaction* transaction);
+// Check for transfer completion using transport's transfer_poll, and advance the queue.
+// Returns true if there are no more transactions in the queue.
+bool S2LP_PollTransactions(S2LP_Handle* handle);
+// Block until transaction is done
+void S2LP_WaitTransaction(S2LP_Handle* handle, S2LP_Transaction* transaction);
+// Block until the queue is empty
+void S2LP_WaitAllTransactions(S2LP_Handle* handle);
+// To be called by transport backend (or it's interrupt handler) when transfer
+// started by transfer_start is done.
+void S2LP_OnTransferComplete(S2LP_Handle* handle);
+
+// Low-level queue operations, used by the bus arbiter - don't call them directly.
+// Put the first queued transaction on the bus. Returns true if it's still in progress
+// (data part was started with transfer_start), false if it's done already.
+bool S2LP_StartQueuedTransaction(S2LP_Handle* handle);
+// Complete the transaction which was in progress.
+void S2LP_FinishQueuedTransaction(S2LP_Handle* handle);
+
+// Chip select control. Select takes the lock (and the bus, if handle is attached to one),
+// and Deselect releases it, so the whole transaction between them is exclusive.
 void S2LP_Select(S2LP_Handle* handle);
 void S2LP_Deselect(S2LP_Handle* handle);
 
@@ -0,0 +1,152 @@
+/*
+ * s2lp_modem.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_modem.h"
+#include "s2lp.h"
+#include "s2lp_rf.h"
+#include "s2lp_rx.h"
+
+// Widths of AGC register fields - 5 bits of hold time, 4 bits of measurement time
+#define S2LP_MODEM_AGC_HOLD_TIME_MAX 31
+#define S2LP_MODEM_AGC_MEASURE_TIME_MAX 15
+
+static bool S2LP_Modem_IsFourLevel(S2LP_Modulation modulation) {
+	return modulation == S2LP_MODULATION_4FSK || modulation == S2LP_MODULATION_4GFSK
+			|| modulation == S2LP_MODULATION_4GFSK_UNSHAPED;
+}
+
+static bool S2LP_Modem_IsFrequencyModulation(S2LP_Modulation modulation) {
+	return modulation == S2LP_MODULATION_2FSK || modulation == S2LP_MODULATION_2GFSK
+			|| modulation == S2LP_MODULATION_2GFSK_UNSHAPED || S2LP_Modem_IsFourLevel(modulation);
+}
+
+static uint32_t S2LP_Modem_RequiredBandwidth(S2LP_ModemSolution const* solution, uint32_t symbol_rate,
+		uint32_t frequency_offset) {
+	uint64_t bandwidth = 0;
+	if (solution->modulation == S2LP_MODULATION_ASK_OOK) {
+		// Main lobe of the keyed carrier
+		bandwidth = 2ull * solution->datarate;
+	} else {
+		// Carson's rule, outer 4-level symbols are at 3 times the deviation
+		uint64_t const deviation = (uint64_t) solution->frequency_deviation
+				* (S2LP_Modem_IsFourLevel(solution->modulation) ? 3 : 1);
+		bandwidth = 2 * deviation + symbol_rate;
+	}
+
+	// Offset moves the signal to either side
+	bandwidth += 2ull * frequency_offset;
+	return (bandwidth > UINT32_MAX ? UINT32_MAX : (uint32_t) bandwidth);
+}
+
+static void S2LP_Modem_SolveAGC(S2LP_ModemSolution* solution, uint32_t fdig, uint32_t symbol_rate) {
+	// Measurement time is 12 * 2^T / fdig
+	uint8_t measure = 0;
+	if (solution->modulation == S2LP_MODULATION_ASK_OOK) {
+		// At least two symbols: 12 * 2^T * symbol_rate >= 2 * fdig
+		while (measure < S2LP_MODEM_AGC_MEASURE_TIME_MAX
+				&& (12ull << measure) * symbol_rate < 2ull * fdig) {
+			measure++;
+		}
+	} else {
+		// Up to half of the symbol: 12 * 2^T * symbol_rate <= fdig / 2
+		while (measure < S2LP_MODEM_AGC_MEASURE_TIME_MAX
+				&& (24ull << (measure + 1)) * symbol_rate <= fdig) {
+			measure++;
+		}
+	}
+
+	// Hold time is 12 * H / fdig, filter settles in about 2 / bandwidth
+	uint64_t hold = (2ull * fdig + 12ull * solution->filter_bandwidth - 1) / (12ull * solution->filter_bandwidth);
+	hold = (hold == 0 ? 1 : hold);
+	hold = (hold > S2LP_MODEM_AGC_HOLD_TIME_MAX ? S2LP_MODEM_AGC_HOLD_TIME_MAX : hold);
+
+	solution->agc_measure_time = measure;
+	solution->agc_hold_time = (uint8_t) hold;
+}
+
+bool S2LP_Modem_Solve(S2LP_Handle* handle, S2LP_ModemParameters const* parameters, S2LP_ModemSolution* solution) {
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+
+	bool const frequency_modulation = S2LP_Modem_IsFrequencyModulation(parameters->modulation);
+	solution->modulation = parameters->modulation;
+
+	S2LP_RFCalc_Solution datarate;
+	if (parameters->datarate == 0 || !S2LP_RFCalc_SolveDataRate(&context, parameters->datarate, &datarate)) {
+		return false;
+	}
+	solution->datarate_mantissa = datarate.mantissa;
+	solution->datarate_exponent = datarate.exponent;
+	solution->datarate = datarate.value;
+
+	uint32_t const symbol_rate = solution->datarate / (S2LP_Modem_IsFourLevel(parameters->modulation) ? 2 : 1);
+
+	solution->deviation_mantissa = 0;
+	solution->deviation_exponent = 0;
+	solution->frequency_deviation = 0;
+	if (frequency_modulation) {
+		uint32_t const deviation = (parameters->frequency_deviation != 0 ? parameters->frequency_deviation :
+				symbol_rate / 2);
+		S2LP_RFCalc_Solution fdev;
+		if (!S2LP_RFCalc_SolveFrequencyDeviation(&context, deviation, &fdev)) {
+			return false;
+		}
+		solution->deviation_mantissa = (uint8_t) fdev.mantissa;
+		solution->deviation_exponent = fdev.exponent;
+		solution->frequency_deviation = fdev.value;
+	}
+
+	solution->required_bandwidth = S2LP_Modem_RequiredBandwidth(solution, symbol_rate,
+			parameters->frequency_offset);
+	if (!S2LP_RX_CalculateChannelFilterCoeffs(handle, solution->required_bandwidth, &solution->filter_mantissa,
+			&solution->filter_exponent)) {
+		return false;
+	}
+	solution->filter_bandwidth = (uint32_t) (S2LP_RX_CalculateChannelFilterBandwidth(handle,
+			solution->filter_mantissa, solution->filter_exponent) * 1000.0);
+
+	// Slicer correction can't bring back symbols moved over the decision threshold
+	solution->afc_enabled = frequency_modulation && parameters->frequency_offset > 0;
+	solution->afc_mode = (solution->afc_enabled && parameters->frequency_offset > solution->frequency_deviation ?
+			S2LP_AFC_2ND_IF_CORRECTION : S2LP_AFC_SLICER_CORRECTION);
+
+	S2LP_Modem_SolveAGC(solution, context.fdig, symbol_rate);
+
+	solution->clock_recovery = (parameters->whitened_data ? S2LP_CLOCK_RECOVERY_DLL : S2LP_CLOCK_RECOVERY_PLL);
+	return true;
+}
+
+void S2LP_Modem_Apply(S2LP_Handle* handle, S2LP_ModemSolution const* solution) {
+	S2LP_BeginWriteBatch(handle);
+
+	S2LP_RF_SetModulationType(handle, solution->modulation);
+	S2LP_RF_SetDataRateRaw(handle, solution->datarate_mantissa, solution->datarate_exponent);
+	if (S2LP_Modem_IsFrequencyModulation(solution->modulation)) {
+		S2LP_RF_SetFrequencyDeviationRaw(handle, solution->deviation_mantissa, solution->deviation_exponent);
+	}
+	S2LP_RX_SetChannelFilterValueRaw(handle, solution->filter_mantissa, solution->filter_exponent);
+
+	S2LP_RX_SetAFCState(handle, solution->afc_enabled);
+	S2LP_RX_SetAFCMode(handle, solution->afc_mode);
+	S2LP_RX_SetAFCFreezeOnSyncState(handle, true);
+
+	S2LP_RX_SetAGCMeasureTimeRaw(handle, solution->agc_measure_time);
+	S2LP_RX_SetAGCHoldTimeRaw(handle, solution->agc_hold_time);
+	S2LP_RX_SetAGCState(handle, true);
+
+	S2LP_RX_SetClockRecoveryAlgorithm(handle, solution->clock_recovery);
+
+	S2LP_CommitWriteBatch(handle);
+}
+
+void S2LP_Modem_BuildProfile(S2LP_Profile* profile, S2LP_ClockFrequency frequency,
+		S2LP_ModemSolution const* solution) {
+	S2LP_Handle builder;
+	S2LP_Profile_BeginBuild(&builder, frequency);
+	S2LP_Modem_Apply(&builder, solution);
+	S2LP_Profile_EndBuild(&builder, profile);
+}
@@ -0,0 +1,78 @@
+/*
+ * s2lp_modem.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_MODEM_H_
+#define S2LP_S2LP_MODEM_H_
+
+// Modem solver - derives the whole consistent modem configuration from the link parameters:
+// * datarate and frequency deviation coefficients with minimal error (see s2lp_rf_calc.h)
+// * channel filter - the narrowest one covering Carson bandwidth of the signal, widened
+//   by the frequency offset between the nodes
+// * AFC - enabled (frozen on sync) only for frequency modulations with non-zero offset,
+//   correcting on the 2nd IF stage when offset exceeds the deviation. Loop gains are kept
+//   at datasheet values, the loop works on samples, so they don't depend on the datarate.
+// * AGC - measurement time up to half of the symbol (FSK), or at least two symbols (ASK,
+//   so the measurement sees the carrier), hold time long enough for the channel filter to settle
+// * clock recovery - DLL for whitened/coded data, PLL for data with long runs of equal bits
+// The solution is written with a single write batch, or stored as a profile (s2lp_profile.h).
+// Usage:
+//   S2LP_ModemParameters parameters = { .modulation = S2LP_MODULATION_2GFSK, .datarate = 38400,
+//       .frequency_deviation = 20000, .frequency_offset = 2 * 868 * 20, .whitened_data = true };
+//   S2LP_ModemSolution solution;
+//   if (S2LP_Modem_Solve(&handle, &parameters, &solution)) {
+//     S2LP_Modem_Apply(&handle, &solution);
+//   }
+
+#include "s2lp_profile.h"
+
+typedef struct S2LP_ModemParameters_t {
+	S2LP_Modulation modulation;
+	uint32_t datarate;
+	// Frequency deviation in Hz, 0 for modulation index 1 (deviation = symbol rate / 2)
+	uint32_t frequency_deviation;
+	// Maximal carrier frequency offset between transmitter and receiver
+	// (sum of both crystal tolerances), in Hz
+	uint32_t frequency_offset;
+	// Payload is whitened or coded, so it has no long runs of equal bits
+	bool whitened_data;
+} S2LP_ModemParameters;
+
+typedef struct S2LP_ModemSolution_t {
+	S2LP_Modulation modulation;
+	// Coefficients and the values they give, in Hz and bps
+	uint16_t datarate_mantissa;
+	uint8_t datarate_exponent;
+	uint32_t datarate;
+	uint8_t deviation_mantissa;
+	uint8_t deviation_exponent;
+	uint32_t frequency_deviation;
+	// Bandwidth the filter has to pass (Carson bandwidth with frequency offset), and the filter
+	uint32_t required_bandwidth;
+	uint8_t filter_mantissa;
+	uint8_t filter_exponent;
+	uint32_t filter_bandwidth;
+	bool afc_enabled;
+	S2LP_AFC_Mode afc_mode;
+	// Raw values, see S2LP_RX_SetAGCMeasureTimeRaw and S2LP_RX_SetAGCHoldTimeRaw
+	uint8_t agc_measure_time;
+	uint8_t agc_hold_time;
+	S2LP_ClockRecoveryAlgorithm clock_recovery;
+} S2LP_ModemSolution;
+
+// Solve the configuration for the clock of the handle (and synthesizer band, which the deviation
+// depends on - tracked by the handle, see S2LP_RF_GetContext). Nothing is accessed on the chip.
+// Returns false for invalid clock or datarate, or if no channel filter is wide enough.
+bool S2LP_Modem_Solve(S2LP_Handle* handle, S2LP_ModemParameters const* parameters, S2LP_ModemSolution* solution);
+
+// Write the solution, as a single write batch
+void S2LP_Modem_Apply(S2LP_Handle* handle, S2LP_ModemSolution const* solution);
+
+// Store the solution in a profile, containing only the modem registers
+void S2LP_Modem_BuildProfile(S2LP_Profile* profile, S2LP_ClockFrequency frequency,
+		S2LP_ModemSolution const* solution);
+
+#endif /* S2LP_S2LP_MODEM_H_ */
@@ -142,6 +142,7 @@ void S2LP_PCKT_DisableDataCoding(S2LP_Handle* handle) {
 }
 
 void S2LP_PCKT_SetDataCoding(S2LP_Handle* handle, S2LP_Data_Coding mode) {
+	S2LP_BeginWriteBatch(handle);
 	S2LP_PCKT_DisableDataCoding(handle);
 	uint8_t reg_val = 0;
 
@@ -167,6 +168,7 @@ void S2LP_PCKT_SetDataCoding(S2LP_Handle* handle, S2LP_Data_Coding mode) {
 		default: {
 		}
 	}
+	S2LP_CommitWriteBatch(handle);
 }
 
 void S2LP_PCKT_SetDataWhiteningState(S2LP_Handle* handle, bool enabled) {
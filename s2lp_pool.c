@@ -0,0 +1,166 @@
+/*
+ * s2lp_pool.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_pool.h"
+#include "s2lp.h"
+
+// Lock helpers - no-op when lock is not set
+
+static void S2LP_Pool_Lock(S2LP_Pool* pool) {
+	if (pool->lock != NULL) {
+		pool->lock->lock(pool->lock_context);
+	}
+}
+
+static void S2LP_Pool_Unlock(S2LP_Pool* pool) {
+	if (pool->lock != NULL) {
+		pool->lock->unlock(pool->lock_context);
+	}
+}
+
+void S2LP_Pool_Init(S2LP_Pool* pool) {
+	pool->free_list = NULL;
+	for (size_t i = S2LP_POOL_MAX_BUFFERS; i > 0; i--) {
+		pool->buffers[i - 1].next = pool->free_list;
+		pool->free_list = &pool->buffers[i - 1];
+	}
+
+	pool->free_count = S2LP_POOL_MAX_BUFFERS;
+	pool->lock = NULL;
+	pool->lock_context = NULL;
+	pool->statistics.allocations = 0;
+	pool->statistics.frees = 0;
+	pool->statistics.exhaustions = 0;
+	pool->statistics.min_free = S2LP_POOL_MAX_BUFFERS;
+}
+
+void S2LP_Pool_SetLock(S2LP_Pool* pool, S2LP_Lock const* lock, void* lock_context) {
+	pool->lock = lock;
+	pool->lock_context = lock_context;
+}
+
+S2LP_Buffer* S2LP_Pool_Alloc(S2LP_Pool* pool) {
+	S2LP_Pool_Lock(pool);
+
+	S2LP_Buffer* const buffer = pool->free_list;
+	if (buffer == NULL) {
+		pool->statistics.exhaustions++;
+		S2LP_Pool_Unlock(pool);
+		return NULL;
+	}
+
+	pool->free_list = buffer->next;
+	pool->free_count--;
+	pool->statistics.allocations++;
+	pool->statistics.min_free = (pool->free_count < pool->statistics.min_free ? pool->free_count :
+			pool->statistics.min_free);
+
+	S2LP_Pool_Unlock(pool);
+
+	buffer->next = NULL;
+	buffer->data = buffer->memory + S2LP_POOL_HEADROOM;
+	buffer->length = 0;
+	buffer->rssi = 0;
+	buffer->timestamp = 0;
+	return buffer;
+}
+
+void S2LP_Pool_Free(S2LP_Pool* pool, S2LP_Buffer* buffer) {
+	if (buffer == NULL) {
+		return;
+	}
+
+	S2LP_Pool_Lock(pool);
+	buffer->next = pool->free_list;
+	pool->free_list = buffer;
+	pool->free_count++;
+	pool->statistics.frees++;
+	S2LP_Pool_Unlock(pool);
+}
+
+size_t S2LP_Pool_GetFreeCount(S2LP_Pool* pool) {
+	return pool->free_count;
+}
+
+uint8_t* S2LP_Buffer_Prepend(S2LP_Buffer* buffer, size_t size) {
+	if ((size_t) (buffer->data - buffer->memory) < size) {
+		return NULL;
+	}
+
+	buffer->data -= size;
+	buffer->length += size;
+	return buffer->data;
+}
+
+size_t S2LP_Buffer_GetTailroom(S2LP_Buffer const* buffer) {
+	return (size_t) ((buffer->memory + sizeof(buffer->memory)) - (buffer->data + buffer->length));
+}
+
+void S2LP_BufferQueue_Init(S2LP_BufferQueue* queue) {
+	queue->head = NULL;
+	queue->tail = NULL;
+	queue->count = 0;
+}
+
+void S2LP_Pool_Enqueue(S2LP_Pool* pool, S2LP_BufferQueue* queue, S2LP_Buffer* buffer) {
+	buffer->next = NULL;
+
+	S2LP_Pool_Lock(pool);
+	if (queue->tail != NULL) {
+		queue->tail->next = buffer;
+	} else {
+		queue->head = buffer;
+	}
+	queue->tail = buffer;
+	queue->count++;
+	S2LP_Pool_Unlock(pool);
+}
+
+S2LP_Buffer* S2LP_Pool_Dequeue(S2LP_Pool* pool, S2LP_BufferQueue* queue) {
+	S2LP_Pool_Lock(pool);
+
+	S2LP_Buffer* const buffer = queue->head;
+	if (buffer != NULL) {
+		queue->head = buffer->next;
+		if (queue->head == NULL) {
+			queue->tail = NULL;
+		}
+		queue->count--;
+		buffer->next = NULL;
+	}
+
+	S2LP_Pool_Unlock(pool);
+	return buffer;
+}
+
+S2LP_Buffer* S2LP_Pool_ReceivePacket(S2LP_Pool* pool, S2LP_Handle* handle) {
+	size_t const length = S2LP_PCKT_GetRxPacketLength(handle);
+	S2LP_Buffer* buffer = NULL;
+	if (length <= S2LP_FIFO_SIZE && length <= S2LP_POOL_BUFFER_SIZE) {
+		buffer = S2LP_Pool_Alloc(pool);
+	}
+
+	S2LP_PacketMetadata metadata;
+	if (!S2LP_ReadReceivedPacket(handle, length, (buffer != NULL ? buffer->data : NULL), &metadata)) {
+		return NULL;
+	}
+
+	buffer->length = metadata.length;
+	buffer->rssi = metadata.rssi;
+	buffer->timestamp = metadata.timestamp;
+	return buffer;
+}
+
+bool S2LP_Pool_WritePacket(S2LP_Handle* handle, S2LP_Buffer* buffer) {
+	if (buffer->length > S2LP_FIFO_SIZE) {
+		return false;
+	}
+
+	S2LP_PCKT_SetPacketLength(handle, buffer->length);
+	S2LP_WriteFIFO(handle, buffer->length, buffer->data);
+	return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * s2lp_pool.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_POOL_H_
+#define S2LP_S2LP_POOL_H_
+
+// Static pool of packet buffers - frames move between interrupt handler, driver and application
+// as pointers, with explicit ownership: the code holding the pointer owns the buffer, until it
+// hands it over (queue, stream, FIFO write) or frees it.
+// * allocation and freeing are O(1) (free list), there's no malloc
+// * every buffer has headroom before the data, so headers can be prepended without moving it
+// * buffers are handed over with queues (S2LP_BufferQueue), linked through the buffers themselves
+// * packets are read from RX FIFO and written to TX FIFO directly from/to the buffers
+// Pool and it's queues can be shared between interrupt handler and application, or between
+// threads, with a lock (S2LP_Pool_SetLock) - on MCUs it should mask the radio interrupt.
+// Buffers hold packets up to the FIFO size (S2LP_POOL_BUFFER_SIZE is S2LP_FIFO_SIZE), longer packets
+// (s2lp_stream.h) aren't pooled.
+// Usage:
+//   // nIRQ handler
+//   S2LP_Buffer* buffer = S2LP_Pool_ReceivePacket(&pool, &handle);
+//   if (buffer != NULL) {
+//     S2LP_Pool_Enqueue(&pool, &rx_queue, buffer);
+//   }
+//   // application
+//   while ((buffer = S2LP_Pool_Dequeue(&pool, &rx_queue)) != NULL) {
+//     process(buffer->data, buffer->length);
+//     S2LP_Pool_Free(&pool, buffer);
+//   }
+
+#include "s2lp_mcu_interface.h"
+
+// Amount of buffers in the pool
+#define S2LP_POOL_MAX_BUFFERS 16
+// Data capacity of a buffer, and the space reserved for headers before it
+#define S2LP_POOL_BUFFER_SIZE S2LP_FIFO_SIZE
+#define S2LP_POOL_HEADROOM 8
+
+typedef struct S2LP_Buffer_t {
+	uint8_t memory[S2LP_POOL_HEADROOM + S2LP_POOL_BUFFER_SIZE];
+	// Start of the data (inside memory) and it's length
+	uint8_t* data;
+	size_t length;
+	// Metadata of received packets, see S2LP_Pool_ReceivePacket
+	uint8_t rssi;
+	uint32_t timestamp;
+	// Link used by the free list and queues
+	struct S2LP_Buffer_t* next;
+} S2LP_Buffer;
+
+// FIFO queue of buffers, for handing them over
+typedef struct S2LP_BufferQueue_t {
+	S2LP_Buffer* head;
+	S2LP_Buffer* tail;
+	size_t count;
+} S2LP_BufferQueue;
+
+typedef struct S2LP_Pool_Statistics_t {
+	uint32_t allocations;
+	uint32_t frees;
+	// Allocations failed because all the buffers were taken
+	uint32_t exhaustions;
+	// The lowest amount of free buffers seen
+	size_t min_free;
+} S2LP_Pool_Statistics;
+
+typedef struct S2LP_Pool_t {
+	S2LP_Buffer buffers[S2LP_POOL_MAX_BUFFERS];
+	S2LP_Buffer* free_list;
+	size_t free_count;
+	// Optional lock, see S2LP_Pool_SetLock
+	S2LP_Lock const* lock;
+	void* lock_context;
+	S2LP_Pool_Statistics statistics;
+} S2LP_Pool;
+
+void S2LP_Pool_Init(S2LP_Pool* pool);
+// Set the lock protecting the pool and it's queues, or NULL if it's used from single context only.
+// Unlike the handle lock, it doesn't have to be recursive.
+void S2LP_Pool_SetLock(S2LP_Pool* pool, S2LP_Lock const* lock, void* lock_context);
+
+// Take a buffer, with empty data after the headroom. Returns NULL if the pool is exhausted.
+S2LP_Buffer* S2LP_Pool_Alloc(S2LP_Pool* pool);
+// Give the buffer back. NULL is ignored.
+void S2LP_Pool_Free(S2LP_Pool* pool, S2LP_Buffer* buffer);
+size_t S2LP_Pool_GetFreeCount(S2LP_Pool* pool);
+
+// Move the start of the data `size` bytes back, into the headroom, and return it.
+// Returns NULL if there's not enough headroom left.
+uint8_t* S2LP_Buffer_Prepend(S2LP_Buffer* buffer, size_t size);
+// Space left for the data after it's current end
+size_t S2LP_Buffer_GetTailroom(S2LP_Buffer const* buffer);
+
+void S2LP_BufferQueue_Init(S2LP_BufferQueue* queue);
+// Hand the buffer over to the queue
+void S2LP_Pool_Enqueue(S2LP_Pool* pool, S2LP_BufferQueue* queue, S2LP_Buffer* buffer);
+// Take the oldest buffer from the queue, or NULL if it's empty
+S2LP_Buffer* S2LP_Pool_Dequeue(S2LP_Pool* pool, S2LP_BufferQueue* queue);
+
+// Read the received packet from RX FIFO straight into a new buffer, with RSSI and timestamp.
+// Call it after RX_DATA_READY. If the pool is exhausted, or the packet doesn't fit in a single
+// FIFO read, the packet is flushed from the FIFO and NULL is returned.
+S2LP_Buffer* S2LP_Pool_ReceivePacket(S2LP_Pool* pool, S2LP_Handle* handle);
+// Set packet length and write the buffer data to TX FIFO (up to S2LP_FIFO_SIZE bytes). The buffer
+// stays owned by the caller. Returns false if the data doesn't fit in the FIFO.
+bool S2LP_Pool_WritePacket(S2LP_Handle* handle, S2LP_Buffer* buffer);
+
+#endif /* S2LP_S2LP_POOL_H_ */
@@ -0,0 +1,148 @@
+/*
+ * s2lp_profile.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_profile.h"
+#include "s2lp.h"
+#include "s2lp_packet.h"
+#include "s2lp_rf.h"
+#include "s2lp_rx.h"
+#include "s2lp_tx.h"
+#include "bit_helpers.h"
+
+#include <string.h>
+
+// ===== Offline transport of the builder =====
+// Builder keeps everything in it's write batch, so nothing should reach the transport.
+// Just in case some setter reads a volatile register, it reads zeros.
+
+static void S2LP_Profile_Transfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	(void) context;
+	(void) tx_data;
+	if (rx_data != NULL) {
+		memset(rx_data, 0, length);
+	}
+}
+
+static void S2LP_Profile_WritePin(void* context, S2LP_Pin pin, bool state) {
+	(void) context;
+	(void) pin;
+	(void) state;
+}
+
+static bool S2LP_Profile_ReadPin(void* context, S2LP_Pin pin) {
+	(void) context;
+	(void) pin;
+	return false;
+}
+
+static void S2LP_Profile_Delay(void* context, uint32_t milliseconds) {
+	(void) context;
+	(void) milliseconds;
+}
+
+static S2LP_Transport const S2LP_Profile_BuilderTransport = {
+	.transfer = S2LP_Profile_Transfer,
+	.write_pin = S2LP_Profile_WritePin,
+	.read_pin = S2LP_Profile_ReadPin,
+	.delay = S2LP_Profile_Delay,
+};
+
+// ===== Public API =====
+
+void S2LP_Profile_BeginBuild(S2LP_Handle* builder, S2LP_ClockFrequency frequency) {
+	S2LP_InitHandle(builder);
+	builder->transport = &S2LP_Profile_BuilderTransport;
+	builder->transport_context = NULL;
+	builder->frequency = frequency;
+	S2LP_RFCalc_InitContext(&(builder->rf_context), frequency, S2LP_SYNTH_BAND_HIGH, false);
+
+	// Setters work on top of reset values, and all their writes stay in the batch
+	S2LP_SetRegisterCacheState(builder, true);
+	S2LP_LoadRegisterCacheDefaults(builder);
+	S2LP_BeginWriteBatch(builder);
+
+	// Same as S2LP_Initialize does, frequency calculations depend on it
+	S2LP_SetRefDivState(builder, S2LP_IsDigitalClockDivided(builder));
+}
+
+void S2LP_Profile_EndBuild(S2LP_Handle* builder, S2LP_Profile* profile) {
+	profile->frequency = builder->frequency;
+	memcpy(profile->image, builder->cache, sizeof(profile->image));
+	memcpy(profile->mask, builder->batch_pending, sizeof(profile->mask));
+
+	// Image of registers not set by profile is meaningless
+	for (size_t reg = 0; reg < S2LP_REGISTER_CACHE_SIZE; reg++) {
+		if (!GETBIT(profile->mask[reg / 8], reg % 8)) {
+			profile->image[reg] = 0;
+		}
+	}
+
+	// Commit goes to the offline transport
+	S2LP_CommitWriteBatch(builder);
+}
+
+bool S2LP_Profile_Build(S2LP_Profile* profile, S2LP_ClockFrequency frequency,
+		S2LP_ProfileParameters const* parameters) {
+	S2LP_SynthesizerBand band = S2LP_SYNTH_BAND_HIGH;
+	if (!S2LP_RFCalc_SynthBandForFrequency(parameters->base_frequency, &band)) {
+		return false;
+	}
+
+	S2LP_Handle builder;
+	S2LP_Profile_BeginBuild(&builder, frequency);
+
+	// Band goes first, synthesizer word depends on it
+	S2LP_RF_SetSynthBand(&builder, band);
+	S2LP_RF_SetBaseFrequency(&builder, parameters->base_frequency);
+	S2LP_RF_SetChargePumpCurrent(&builder, parameters->charge_pump_current);
+	S2LP_RF_SetChannelSpacing(&builder, parameters->channel_spacing);
+	S2LP_RF_SetChannelNumber(&builder, parameters->channel_number);
+	S2LP_RF_SetModulationType(&builder, parameters->modulation);
+	S2LP_RF_SetDataRate(&builder, parameters->datarate);
+	S2LP_RF_SetFrequencyDeviation(&builder, parameters->frequency_deviation);
+	S2LP_RX_SetChannelFilterValueRaw(&builder, parameters->channel_filter_mantissa,
+			parameters->channel_filter_exponent);
+
+	S2LP_PCKT_SetPacketFormat(&builder, parameters->packet_format);
+	S2LP_PCKT_SetPreambleLength(&builder, parameters->preamble_length);
+	S2LP_PCKT_SetSyncLength(&builder, parameters->sync_length);
+	S2LP_PCKT_SetPacketLength(&builder, parameters->packet_length);
+	S2LP_PCKT_SetVariablePacketLengthState(&builder, parameters->variable_packet_length);
+	S2LP_PCKT_SetCRCMode(&builder, parameters->crc_mode);
+	S2LP_PCKT_SetDataCoding(&builder, parameters->data_coding);
+	S2LP_PCKT_SetDataWhiteningState(&builder, parameters->data_whitening);
+
+	S2LP_TX_SetStaticPowerLevel(&builder, parameters->power_level);
+	S2LP_RX_SetRSSIThreshold(&builder, parameters->rssi_threshold);
+
+	S2LP_Profile_EndBuild(&builder, profile);
+	return true;
+}
+
+bool S2LP_Profile_Apply(S2LP_Handle* handle, S2LP_Profile const* profile) {
+	if (profile->frequency != handle->frequency) {
+		return false;
+	}
+
+	S2LP_BeginWriteBatch(handle);
+
+	for (size_t reg = 0; reg < S2LP_REGISTER_CACHE_SIZE; reg++) {
+		if (!GETBIT(profile->mask[reg / 8], reg % 8)) {
+			continue;
+		}
+
+		uint8_t current = 0;
+		if (S2LP_PeekRegister(handle, (S2LP_Register) reg, &current) && current == profile->image[reg]) {
+			continue;
+		}
+
+		S2LP_WriteRegister(handle, (S2LP_Register) reg, profile->image[reg]);
+	}
+
+	S2LP_CommitWriteBatch(handle);
+	return true;
+}
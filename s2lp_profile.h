@@ -0,0 +1,84 @@
+/*
+ * s2lp_profile.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_PROFILE_H_
+#define S2LP_S2LP_PROFILE_H_
+
+// Configuration profiles - precomputed image of configuration registers, applied
+// to the chip in a handful of burst writes instead of separate read-modify-write
+// of every setting.
+// Profile is built with regular setters (S2LP_RF_*, S2LP_PCKT_*, S2LP_RX_*, ...) called
+// on offline builder handle, which does not talk to any chip - all the calculations and
+// register changes land in the profile. Profile is plain data, so it can be built once
+// (even on PC, at build time) and stored as a constant.
+// Usage:
+//   S2LP_Handle builder;
+//   S2LP_Profile profile;
+//   S2LP_Profile_BeginBuild(&builder, S2LP_CLOCK_FREQ_50MHZ);
+//   S2LP_RF_SetBaseFrequency(&builder, 868000000);
+//   S2LP_RF_SetDataRate(&builder, 38400);
+//   S2LP_Profile_EndBuild(&builder, &profile);
+//   ...
+//   S2LP_Initialize(&handle, S2LP_CLOCK_FREQ_50MHZ);
+//   S2LP_Profile_Apply(&handle, &profile);
+
+#include "s2lp_mcu_interface.h"
+
+typedef struct S2LP_Profile_t {
+	// Clock frequency the profile was built for
+	S2LP_ClockFrequency frequency;
+	// Register values, and bitmap of registers set by the profile
+	uint8_t image[S2LP_REGISTER_CACHE_SIZE];
+	uint8_t mask[(S2LP_REGISTER_CACHE_SIZE + 7) / 8];
+} S2LP_Profile;
+
+// High-level parameters of the most common radio setup, see S2LP_Profile_Build.
+// All the fields are applied. Synthesizer band is the one covering base_frequency.
+typedef struct S2LP_ProfileParameters_t {
+	// RF
+	uint32_t base_frequency;
+	uint32_t datarate;
+	S2LP_Modulation modulation;
+	uint32_t frequency_deviation;
+	uint8_t channel_spacing;
+	uint8_t channel_number;
+	uint8_t channel_filter_mantissa;
+	uint8_t channel_filter_exponent;
+	S2LP_ChargePumpCurrent charge_pump_current;
+
+	// Packet
+	S2LP_Packet_Format packet_format;
+	size_t preamble_length;
+	size_t sync_length;
+	size_t packet_length;
+	bool variable_packet_length;
+	S2LP_CRC_Mode crc_mode;
+	S2LP_Data_Coding data_coding;
+	bool data_whitening;
+
+	// TX and RX
+	uint8_t power_level;
+	uint8_t rssi_threshold;
+} S2LP_ProfileParameters;
+
+// Init the offline builder handle. Registers start with their reset values.
+void S2LP_Profile_BeginBuild(S2LP_Handle* builder, S2LP_ClockFrequency frequency);
+// Store registers changed by setters called on builder into the profile.
+void S2LP_Profile_EndBuild(S2LP_Handle* builder, S2LP_Profile* profile);
+
+// Build the profile from high-level parameters.
+// Returns false if base frequency is out of synthesizer bands - profile is not changed then.
+bool S2LP_Profile_Build(S2LP_Profile* profile, S2LP_ClockFrequency frequency,
+		S2LP_ProfileParameters const* parameters);
+
+// Write the profile to the chip, preferably right after S2LP_Initialize or S2LP_Reset.
+// Registers which are known to already have the right values are skipped, the rest goes
+// out as a write batch (contiguous bursts).
+// Returns false if the profile was built for another clock frequency - nothing is written then.
+bool S2LP_Profile_Apply(S2LP_Handle* handle, S2LP_Profile const* profile);
+
+#endif /* S2LP_S2LP_PROFILE_H_ */
@@ -0,0 +1,178 @@
+/*
+ * s2lp_registers.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_registers.h"
+
+#include <stddef.h>
+
+// @formatter:off
+S2LP_RegisterInfo const S2LP_REGISTER_MAP[S2LP_REGISTER_COUNT] = {
+	{ S2LP_REG_GPIO0_CONF, S2LP_REG_DEFAULT_GPIO0_CONF },
+	{ S2LP_REG_GPIO1_CONF, S2LP_REG_DEFAULT_GPIO1_CONF },
+	{ S2LP_REG_GPIO2_CONF, S2LP_REG_DEFAULT_GPIO2_CONF },
+	{ S2LP_REG_GPIO3_CONF, S2LP_REG_DEFAULT_GPIO3_CONF },
+	{ S2LP_REG_SYNT3, S2LP_REG_DEFAULT_SYNT3 },
+	{ S2LP_REG_SYNT2, S2LP_REG_DEFAULT_SYNT2 },
+	{ S2LP_REG_SYNT1, S2LP_REG_DEFAULT_SYNT1 },
+	{ S2LP_REG_SYNT0, S2LP_REG_DEFAULT_SYNT0 },
+	{ S2LP_REG_IF_OFFSET_ANA, S2LP_REG_DEFAULT_IF_OFFSET_ANA },
+	{ S2LP_REG_IF_OFFSET_DIG, S2LP_REG_DEFAULT_IF_OFFSET_DIG },
+	{ S2LP_REG_CHSPACE, S2LP_REG_DEFAULT_CHSPACE },
+	{ S2LP_REG_CHNUM, S2LP_REG_DEFAULT_CHNUM },
+	{ S2LP_REG_MOD4, S2LP_REG_DEFAULT_MOD4 },
+	{ S2LP_REG_MOD3, S2LP_REG_DEFAULT_MOD3 },
+	{ S2LP_REG_MOD2, S2LP_REG_DEFAULT_MOD2 },
+	{ S2LP_REG_MOD1, S2LP_REG_DEFAULT_MOD1 },
+	{ S2LP_REG_MOD0, S2LP_REG_DEFAULT_MOD0 },
+	{ S2LP_REG_CHFLT, S2LP_REG_DEFAULT_CHFLT },
+	{ S2LP_REG_AFC2, S2LP_REG_DEFAULT_AFC2 },
+	{ S2LP_REG_AFC1, S2LP_REG_DEFAULT_AFC1 },
+	{ S2LP_REG_AFC0, S2LP_REG_DEFAULT_AFC0 },
+	{ S2LP_REG_RSSI_FLT, S2LP_REG_DEFAULT_RSSI_FLT },
+	{ S2LP_REG_RSSI_TH, S2LP_REG_DEFAULT_RSSI_TH },
+	{ S2LP_REG_AGCCTRL4, S2LP_REG_DEFAULT_AGCCTRL4 },
+	{ S2LP_REG_AGCCTRL3, S2LP_REG_DEFAULT_AGCCTRL3 },
+	{ S2LP_REG_AGCCTRL2, S2LP_REG_DEFAULT_AGCCTRL2 },
+	{ S2LP_REG_AGCCTRL1, S2LP_REG_DEFAULT_AGCCTRL1 },
+	{ S2LP_REG_AGCCTRL0, S2LP_REG_DEFAULT_AGCCTRL0 },
+	{ S2LP_REG_ANT_SELECT_CONF, S2LP_REG_DEFAULT_ANT_SELECT_CONF },
+	{ S2LP_REG_CLOCKREC2, S2LP_REG_DEFAULT_CLOCKREC2 },
+	{ S2LP_REG_CLOCKREC1, S2LP_REG_DEFAULT_CLOCKREC1 },
+	{ S2LP_REG_PCKTCTRL6, S2LP_REG_DEFAULT_PCKTCTRL6 },
+	{ S2LP_REG_PCKTCTRL5, S2LP_REG_DEFAULT_PCKTCTRL5 },
+	{ S2LP_REG_PCKTCTRL4, S2LP_REG_DEFAULT_PCKTCTRL4 },
+	{ S2LP_REG_PCKTCTRL3, S2LP_REG_DEFAULT_PCKTCTRL3 },
+	{ S2LP_REG_PCKTCTRL2, S2LP_REG_DEFAULT_PCKTCTRL2 },
+	{ S2LP_REG_PCKTCTRL1, S2LP_REG_DEFAULT_PCKTCTRL1 },
+	{ S2LP_REG_PCKTLEN1, S2LP_REG_DEFAULT_PCKTLEN1 },
+	{ S2LP_REG_PCKTLEN0, S2LP_REG_DEFAULT_PCKTLEN0 },
+	{ S2LP_REG_SYNC3, S2LP_REG_DEFAULT_SYNC3 },
+	{ S2LP_REG_SYNC2, S2LP_REG_DEFAULT_SYNC2 },
+	{ S2LP_REG_SYNC1, S2LP_REG_DEFAULT_SYNC1 },
+	{ S2LP_REG_SYNC0, S2LP_REG_DEFAULT_SYNC0 },
+	{ S2LP_REG_QI, S2LP_REG_DEFAULT_QI },
+	{ S2LP_REG_PCKT_PSTMBL, S2LP_REG_DEFAULT_PCKT_PSTMBL },
+	{ S2LP_REG_PROTOCOL2, S2LP_REG_DEFAULT_PROTOCOL2 },
+	{ S2LP_REG_PROTOCOL1, S2LP_REG_DEFAULT_PROTOCOL1 },
+	{ S2LP_REG_PROTOCOL0, S2LP_REG_DEFAULT_PROTOCOL0 },
+	{ S2LP_REG_FIFO_CONFIG3, S2LP_REG_DEFAULT_FIFO_CONFIG3 },
+	{ S2LP_REG_FIFO_CONFIG2, S2LP_REG_DEFAULT_FIFO_CONFIG2 },
+	{ S2LP_REG_FIFO_CONFIG1, S2LP_REG_DEFAULT_FIFO_CONFIG1 },
+	{ S2LP_REG_FIFO_CONFIG0, S2LP_REG_DEFAULT_FIFO_CONFIG0 },
+	{ S2LP_REG_PCKT_FLT_OPTIONS, S2LP_REG_DEFAULT_PCKT_FLT_OPTIONS },
+	{ S2LP_REG_PCKT_FLT_GOALS4, S2LP_REG_DEFAULT_PCKT_FLT_GOALS4 },
+	{ S2LP_REG_PCKT_FLT_GOALS3, S2LP_REG_DEFAULT_PCKT_FLT_GOALS3 },
+	{ S2LP_REG_PCKT_FLT_GOALS2, S2LP_REG_DEFAULT_PCKT_FLT_GOALS2 },
+	{ S2LP_REG_PCKT_FLT_GOALS1, S2LP_REG_DEFAULT_PCKT_FLT_GOALS1 },
+	{ S2LP_REG_PCKT_FLT_GOALS0, S2LP_REG_DEFAULT_PCKT_FLT_GOALS0 },
+	{ S2LP_REG_TIMERS5, S2LP_REG_DEFAULT_TIMERS5 },
+	{ S2LP_REG_TIMERS4, S2LP_REG_DEFAULT_TIMERS4 },
+	{ S2LP_REG_TIMERS3, S2LP_REG_DEFAULT_TIMERS3 },
+	{ S2LP_REG_TIMERS2, S2LP_REG_DEFAULT_TIMERS2 },
+	{ S2LP_REG_TIMERS1, S2LP_REG_DEFAULT_TIMERS1 },
+	{ S2LP_REG_TIMERS0, S2LP_REG_DEFAULT_TIMERS0 },
+	{ S2LP_REG_CSMA_CONF3, S2LP_REG_DEFAULT_CSMA_CONF3 },
+	{ S2LP_REG_CSMA_CONF2, S2LP_REG_DEFAULT_CSMA_CONF2 },
+	{ S2LP_REG_CSMA_CONF1, S2LP_REG_DEFAULT_CSMA_CONF1 },
+	{ S2LP_REG_CSMA_CONF0, S2LP_REG_DEFAULT_CSMA_CONF0 },
+	{ S2LP_REG_IRQ_MASK3, S2LP_REG_DEFAULT_IRQ_MASK3 },
+	{ S2LP_REG_IRQ_MASK2, S2LP_REG_DEFAULT_IRQ_MASK2 },
+	{ S2LP_REG_IRQ_MASK1, S2LP_REG_DEFAULT_IRQ_MASK1 },
+	{ S2LP_REG_IRQ_MASK0, S2LP_REG_DEFAULT_IRQ_MASK0 },
+	{ S2LP_REG_FAST_RX_TIMER, S2LP_REG_DEFAULT_FAST_RX_TIMER },
+	{ S2LP_REG_PA_POWER8, S2LP_REG_DEFAULT_PA_POWER8 },
+	{ S2LP_REG_PA_POWER7, S2LP_REG_DEFAULT_PA_POWER7 },
+	{ S2LP_REG_PA_POWER6, S2LP_REG_DEFAULT_PA_POWER6 },
+	{ S2LP_REG_PA_POWER5, S2LP_REG_DEFAULT_PA_POWER5 },
+	{ S2LP_REG_PA_POWER4, S2LP_REG_DEFAULT_PA_POWER4 },
+	{ S2LP_REG_PA_POWER3, S2LP_REG_DEFAULT_PA_POWER3 },
+	{ S2LP_REG_PA_POWER2, S2LP_REG_DEFAULT_PA_POWER2 },
+	{ S2LP_REG_PA_POWER1, S2LP_REG_DEFAULT_PA_POWER1 },
+	{ S2LP_REG_PA_POWER0, S2LP_REG_DEFAULT_PA_POWER0 },
+	{ S2LP_REG_PA_CONFIG1, S2LP_REG_DEFAULT_PA_CONFIG1 },
+	{ S2LP_REG_PA_CONFIG0, S2LP_REG_DEFAULT_PA_CONFIG0 },
+	{ S2LP_REG_SYNTH_CONFIG2, S2LP_REG_DEFAULT_SYNTH_CONFIG2 },
+	{ S2LP_REG_VCO_CONFIG, S2LP_REG_DEFAULT_VCO_CONFIG },
+	{ S2LP_REG_VCO_CALIBR_IN2, S2LP_REG_DEFAULT_VCO_CALIBR_IN2 },
+	{ S2LP_REG_VCO_CALIBR_IN1, S2LP_REG_DEFAULT_VCO_CALIBR_IN1 },
+	{ S2LP_REG_VCO_CALIBR_IN0, S2LP_REG_DEFAULT_VCO_CALIBR_IN0 },
+	{ S2LP_REG_XO_RCO_CONF1, S2LP_REG_DEFAULT_XO_RCO_CONF1 },
+	{ S2LP_REG_XO_RCO_CONF0, S2LP_REG_DEFAULT_XO_RCO_CONF0 },
+	{ S2LP_REG_RCO_CALIBR_CONF3, S2LP_REG_DEFAULT_RCO_CALIBR_CONF3 },
+	{ S2LP_REG_RCO_CALIBR_CONF2, S2LP_REG_DEFAULT_RCO_CALIBR_CONF2 },
+	{ S2LP_REG_PM_CONF4, S2LP_REG_DEFAULT_PM_CONF4 },
+	{ S2LP_REG_PM_CONF3, S2LP_REG_DEFAULT_PM_CONF3 },
+	{ S2LP_REG_PM_CONF2, S2LP_REG_DEFAULT_PM_CONF2 },
+	{ S2LP_REG_PM_CONF1, S2LP_REG_DEFAULT_PM_CONF1 },
+	{ S2LP_REG_PM_CONF0, S2LP_REG_DEFAULT_PM_CONF0 },
+	{ S2LP_REG_MC_STATE1, S2LP_REG_DEFAULT_MC_STATE1 },
+	{ S2LP_REG_MC_STATE0, S2LP_REG_DEFAULT_MC_STATE0 },
+	{ S2LP_REG_TX_FIFO_STATUS, S2LP_REG_DEFAULT_TX_FIFO_STATUS },
+	{ S2LP_REG_RX_FIFO_STATUS, S2LP_REG_DEFAULT_RX_FIFO_STATUS },
+	{ S2LP_REG_RCO_CALIBR_OUT4, S2LP_REG_DEFAULT_RCO_CALIBR_OUT4 },
+	{ S2LP_REG_RCO_CALIBR_OUT3, S2LP_REG_DEFAULT_RCO_CALIBR_OUT3 },
+	{ S2LP_REG_RCO_CALIBR_OUT1, S2LP_REG_DEFAULT_RCO_CALIBR_OUT1 },
+	{ S2LP_REG_VCO_CALIBROUT0, S2LP_REG_DEFAULT_VCO_CALIBROUT0 },
+	{ S2LP_REG_TX_PCKT_INFO, S2LP_REG_DEFAULT_TX_PCKT_INFO },
+	{ S2LP_REG_RX_PCKT_INFO, S2LP_REG_DEFAULT_RX_PCKT_INFO },
+	{ S2LP_REG_AFC_CORR, S2LP_REG_DEFAULT_AFC_CORR },
+	{ S2LP_REG_LINK_QUALIF2, S2LP_REG_DEFAULT_LINK_QUALIF2 },
+	{ S2LP_REG_LINK_QUALIF1, S2LP_REG_DEFAULT_LINK_QUALIF1 },
+	{ S2LP_REG_RSSI_LEVEL, S2LP_REG_DEFAULT_RSSI_LEVEL },
+	{ S2LP_REG_RX_PCKT_LEN1, S2LP_REG_DEFAULT_RX_PCKT_LEN1 },
+	{ S2LP_REG_RX_PCKT_LEN0, S2LP_REG_DEFAULT_RX_PCKT_LEN0 },
+	{ S2LP_REG_CRC_FIELD3, S2LP_REG_DEFAULT_CRC_FIELD3 },
+	{ S2LP_REG_CRC_FIELD2, S2LP_REG_DEFAULT_CRC_FIELD2 },
+	{ S2LP_REG_CRC_FIELD1, S2LP_REG_DEFAULT_CRC_FIELD1 },
+	{ S2LP_REG_CRC_FIELD0, S2LP_REG_DEFAULT_CRC_FIELD0 },
+	{ S2LP_REG_RX_ADDRE_FIELD1, S2LP_REG_DEFAULT_RX_ADDRE_FIELD1 },
+	{ S2LP_REG_RX_ADDRE_FIELD0, S2LP_REG_DEFAULT_RX_ADDRE_FIELD0 },
+	{ S2LP_REG_RSSI_LEVEL_RUN, S2LP_REG_DEFAULT_RSSI_LEVEL_RUN },
+	{ S2LP_REG_DEVICE_INFO1, S2LP_REG_DEFAULT_DEVICE_INFO1 },
+	{ S2LP_REG_DEVICE_INFO0, S2LP_REG_DEFAULT_DEVICE_INFO0 },
+	{ S2LP_REG_IRQ_STATUS3, S2LP_REG_DEFAULT_IRQ_STATUS3 },
+	{ S2LP_REG_IRQ_STATUS2, S2LP_REG_DEFAULT_IRQ_STATUS2 },
+	{ S2LP_REG_IRQ_STATUS1, S2LP_REG_DEFAULT_IRQ_STATUS1 },
+	{ S2LP_REG_IRQ_STATUS0, S2LP_REG_DEFAULT_IRQ_STATUS0 },};
+// @formatter:on
+
+static S2LP_RegisterInfo const* S2LP_Registers_Find(uint8_t address) {
+	size_t low = 0;
+	size_t high = S2LP_REGISTER_COUNT;
+
+	while (low < high) {
+		size_t const middle = low + (high - low) / 2;
+		if (S2LP_REGISTER_MAP[middle].address < address) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	if (low < S2LP_REGISTER_COUNT && S2LP_REGISTER_MAP[low].address == address) {
+		return &S2LP_REGISTER_MAP[low];
+	}
+
+	return NULL;
+}
+
+bool S2LP_Registers_Exists(uint8_t address) {
+	return S2LP_Registers_Find(address) != NULL;
+}
+
+uint8_t S2LP_Registers_GetDefaultValue(uint8_t address) {
+	S2LP_RegisterInfo const* info = S2LP_Registers_Find(address);
+	if (info == NULL) {
+		return 0;
+	}
+
+	return info->default_value;
+}
+
+bool S2LP_Registers_IsCacheable(uint8_t address) {
+	return address < S2LP_CONFIG_REGISTERS_END;
+}
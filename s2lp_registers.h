@@ -0,0 +1,43 @@
+/*
+ * s2lp_registers.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_REGISTERS_H_
+#define S2LP_S2LP_REGISTERS_H_
+
+#include "s2lp_constants.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ==== Register map metadata ====
+
+// The amount of documented registers (not counting FIFO address)
+#define S2LP_REGISTER_COUNT 127
+
+// Configuration registers occupy the addresses from 0 up to PM_CONF0. They are
+// only changed by the MCU, so their values can be safely cached. Everything above
+// is volatile (state, FIFO status, IRQ status, RSSI, link quality, FIFO itself...).
+#define S2LP_CONFIG_REGISTERS_END (S2LP_REG_PM_CONF0 + 1)
+// The amount of documented configuration registers
+#define S2LP_CONFIG_REGISTER_COUNT 98
+
+typedef struct S2LP_RegisterInfo_t {
+	uint8_t address;
+	uint8_t default_value;
+} S2LP_RegisterInfo;
+
+// All documented registers with their reset values, sorted by address.
+extern S2LP_RegisterInfo const S2LP_REGISTER_MAP[S2LP_REGISTER_COUNT];
+
+// Check if there's a documented register at specified address
+bool S2LP_Registers_Exists(uint8_t address);
+// Get the reset value of register. Returns 0 for undocumented addresses.
+uint8_t S2LP_Registers_GetDefaultValue(uint8_t address);
+// Check if register value can be cached (it's a configuration register)
+bool S2LP_Registers_IsCacheable(uint8_t address);
+
+#endif /* S2LP_S2LP_REGISTERS_H_ */
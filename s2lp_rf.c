@@ -8,7 +8,6 @@
 #include "s2lp_rf.h"
 #include "bit_helpers.h"
 #include "s2lp.h"
-#include <math.h>
 
 void S2LP_RF_SetChargePumpCurrent(S2LP_Handle* handle, S2LP_ChargePumpCurrent current) {
 	uint8_t isel_value = 0;
@@ -36,6 +35,7 @@ void S2LP_RF_SetChargePumpCurrent(S2LP_Handle* handle, S2LP_ChargePumpCurrent cu
 			return;
 	}
 
+	S2LP_BeginWriteBatch(handle);
 	uint8_t synt3_val = S2LP_ReadRegister(handle, S2LP_REG_SYNT3);
 	uint8_t synth_config_val = S2LP_ReadRegister(handle, S2LP_REG_SYNTH_CONFIG2);
 
@@ -50,6 +50,7 @@ void S2LP_RF_SetChargePumpCurrent(S2LP_Handle* handle, S2LP_ChargePumpCurrent cu
 
 	S2LP_WriteRegister(handle, S2LP_REG_SYNT3, synt3_val);
 	S2LP_WriteRegister(handle, S2LP_REG_SYNTH_CONFIG2, synth_config_val);
+	S2LP_CommitWriteBatch(handle);
 }
 
 void S2LP_RF_SetSynthBand(S2LP_Handle* handle, S2LP_SynthesizerBand band) {
@@ -68,13 +69,12 @@ void S2LP_RF_SetSynthBand(S2LP_Handle* handle, S2LP_SynthesizerBand band) {
 	S2LP_WriteRegister(handle, S2LP_REG_SYNT3, reg_val);
 }
 
-void S2LP_RF_SetSynthValue(S2LP_Handle* handle, uint32_t value) {
+// Write the synthesizer value, with current value of SYNT3 (which contains other settings) passed by caller
+static void S2LP_RF_WriteSynthValue(S2LP_Handle* handle, uint8_t synt3, uint32_t value) {
 	// Register order is reversed (index 0 is SYNT3, 1 is SYNT2, and so on)
 	uint8_t reg_vals[4] = { 0 };
 
-	// 3 out of 4 SYNT registers are used only for storing divider,
-	// so i'm gonna read only SYNT3 as it contains other settings
-	reg_vals[0] = S2LP_ReadRegister(handle, S2LP_REG_SYNT3);
+	reg_vals[0] = synt3;
 	CLEARBITS(reg_vals[0], 0b1111, 0);
 
 	// Write the values to correct registers
@@ -86,9 +86,15 @@ void S2LP_RF_SetSynthValue(S2LP_Handle* handle, uint32_t value) {
 	S2LP_BatchWriteRegisters(handle, S2LP_REG_SYNT3, reg_vals, 4);
 }
 
+void S2LP_RF_SetSynthValue(S2LP_Handle* handle, uint32_t value) {
+	// 3 out of 4 SYNT registers are used only for storing divider,
+	// so i'm gonna read only SYNT3 as it contains other settings
+	S2LP_RF_WriteSynthValue(handle, S2LP_ReadRegister(handle, S2LP_REG_SYNT3), value);
+}
+
 void S2LP_RF_SetBaseFrequency(S2LP_Handle* handle, uint32_t frequency) {
-	uint32_t sync_word = S2LP_RF_CalculateSyncForBaseFrequency(handle, frequency);
-	S2LP_RF_SetSynthValue(handle, sync_word);
+	uint32_t const value = S2LP_RFCalc_SyncForBaseFrequency(&(handle->rf_context), frequency);
+	S2LP_RF_WriteSynthValue(handle, S2LP_ReadRegister(handle, S2LP_REG_SYNT3), value);
 }
 
 void S2LP_RF_SetChannelSpacing(S2LP_Handle* handle, uint8_t value) {
@@ -145,8 +151,9 @@ void S2LP_RF_SetFrequencyDeviationRaw(S2LP_Handle* handle, uint8_t mantissa, uin
 }
 
 void S2LP_RF_SetFrequencyDeviation(S2LP_Handle* handle, uint32_t deviation) {
-	uint8_t const exponent = S2LP_RF_CalculateFreqDevExponent(handle, deviation);
-	uint8_t const mantissa = S2LP_RF_CalculateFreqDevMantissa(handle, exponent, deviation);
+	uint8_t exponent = 0;
+	uint8_t mantissa = 0;
+	S2LP_RFCalc_FreqDevCoeffs(&(handle->rf_context), deviation, &mantissa, &exponent);
 	S2LP_RF_SetFrequencyDeviationRaw(handle, mantissa, exponent);
 }
 
@@ -168,93 +175,70 @@ void S2LP_RF_SetFrequencyInterpolation(S2LP_Handle* handle, bool state) {
 	S2LP_WriteRegister(handle, S2LP_REG_MOD1, reg_val);
 }
 
-uint32_t S2LP_RF_CalculateSyncForBaseFrequency(S2LP_Handle* handle, uint32_t frequency) {
-	double const fbase = frequency;
-	double const pll_div = (S2LP_RF_GetSynthBand(handle) == S2LP_SYNTH_BAND_HIGH ? 4.0 : 8.0);
-	double const ref_div = (S2LP_IsRefDivEnabled(handle) ? 2.0 : 1.0);
-	double const fxo = S2LP_GetClockFrequency(handle);
-	double const pow20 = (1 << 20);
+void S2LP_RF_GetContext(S2LP_Handle* handle, S2LP_RF_Context* context) {
+	*context = handle->rf_context;
+}
 
-	double const div_const = ((pll_div / 2.0) * ref_div) / fxo;
-	return (uint32_t) (fbase * div_const * pow20);
+void S2LP_RF_RefreshContext(S2LP_Handle* handle) {
+	// Transfers update the context
+	S2LP_RF_GetSynthBand(handle);
+	S2LP_IsRefDivEnabled(handle);
 }
 
-uint32_t S2LP_RF_CalculateDataRateValue(S2LP_Handle* handle, uint16_t mantissa, uint8_t exponent) {
-	double datarate = 0;
-	double fdig = S2LP_GetDigitalClockFrequency(handle);
-
-	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
-		double const pow_32 = (1ull << 32ull);
-		datarate = (double) fdig * ((double) mantissa / pow_32);
-	} else if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
-		datarate = fdig / (8.0 * (double) mantissa);
-	} else {
-		double const pow_33 = (1ull << 33ull);
-		double const pow_16 = (1ull << 16ull);
-		double const exponent_pow = (1 << exponent);
-		double const nominator = (pow_16 + (double) mantissa) * exponent_pow;
-		datarate = (double) fdig * (nominator / pow_33);
-	}
+// Context for calculations depending only on the clock frequency, which does not need any reads
+static void S2LP_RF_GetClockContext(S2LP_Handle* handle, S2LP_RF_Context* context) {
+	S2LP_RFCalc_InitContext(context, handle->frequency, S2LP_SYNTH_BAND_HIGH, false);
+}
 
-	return (uint32_t) round(datarate);
+uint32_t S2LP_RF_CalculateSyncForBaseFrequency(S2LP_Handle* handle, uint32_t frequency) {
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+	return S2LP_RFCalc_SyncForBaseFrequency(&context, frequency);
 }
 
-uint8_t S2LP_RF_CalculateDataRateExponent(S2LP_Handle* handle, uint32_t datarate) {
-	for (uint8_t exponent = S2LP_DATARATE_EXPONENT_MIN; exponent <= S2LP_DATARATE_EXPONENT_MAX; exponent++) {
-		if (S2LP_RF_CalculateDataRateValue(handle, S2LP_DATARATE_MANTISSA_MAX, exponent) > datarate) {
-			return exponent;
-		}
-	}
+uint32_t S2LP_RF_CalculateDataRateValue(S2LP_Handle* handle, uint16_t mantissa, uint8_t exponent) {
+	S2LP_RF_Context context;
+	S2LP_RF_GetClockContext(handle, &context);
+	return S2LP_RFCalc_DataRateValue(&context, mantissa, exponent);
+}
 
-	return S2LP_DATARATE_EXPONENT_INVALID;
+uint8_t S2LP_RF_CalculateDataRateExponent(S2LP_Handle* handle, uint32_t datarate) {
+	S2LP_RF_Context context;
+	S2LP_RF_GetClockContext(handle, &context);
+	return S2LP_RFCalc_DataRateExponent(&context, datarate);
 }
 
 uint16_t S2LP_RF_CalculateDataRateMantissa(S2LP_Handle* handle, uint32_t datarate, uint8_t exponent) {
-	double mantissa = 0;
-	double fdig = S2LP_GetDigitalClockFrequency(handle);
-
-	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
-		double const pow_32 = (1ull << 32ull);
-		mantissa = (pow_32 * (double) datarate) / fdig;
-	} else if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
-		mantissa = fdig / (8.0 * datarate);
-	} else {
-		double const pow_33 = (1ull << 33ull);
-		double const pow_16 = (1ull << 16ull);
-		double const exponent_pow = (1 << exponent);
-		double const nominator = pow_33 * datarate;
-		double const denominator = fdig * exponent_pow;
-		mantissa = (nominator / denominator) - pow_16;
-	}
-
-	return (uint16_t) round(mantissa);
+	S2LP_RF_Context context;
+	S2LP_RF_GetClockContext(handle, &context);
+	return S2LP_RFCalc_DataRateMantissa(&context, datarate, exponent);
 }
 
 void S2LP_RF_CalculateDataRateCoeffs(S2LP_Handle* handle, uint32_t datarate, uint16_t* mantissa, uint8_t* exponent) {
-	*exponent = S2LP_RF_CalculateDataRateExponent(handle, datarate);
-	*mantissa = S2LP_RF_CalculateDataRateMantissa(handle, datarate, *exponent);
+	S2LP_RF_Context context;
+	S2LP_RF_GetClockContext(handle, &context);
+	S2LP_RFCalc_DataRateCoeffs(&context, datarate, mantissa, exponent);
 }
 
 double S2LP_RF_CalculateBaseFrequency(S2LP_Handle* handle, uint32_t synth_value) {
-	double const pll_div = (S2LP_RF_GetSynthBand(handle) == S2LP_SYNTH_BAND_HIGH ? 4.0 : 8.0);
-	double const ref_div = (S2LP_IsRefDivEnabled(handle) ? 2.0 : 1.0);
-	double const fxo = S2LP_GetClockFrequency(handle);
-
-	double const synth_divided = synth_value / ((double) (1ull << 20ull));
-	double const fxo_denominator = (pll_div / 2.0) * ref_div;
-	return round((fxo / fxo_denominator) * synth_divided);
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+	return S2LP_RFCalc_BaseFrequency(&context, synth_value);
 }
 
 double S2LP_RF_CalculateCenterFrequency(S2LP_Handle* handle, double base_frequency, uint8_t channel_spacing,
 		uint8_t channel_number) {
-	double const fxo = S2LP_GetClockFrequency(handle);
-	double const fxo_divided = fxo / (double) (1ull << 15ull);
-	return round(base_frequency + (fxo_divided * (double) channel_spacing) * (double) channel_number);
+	S2LP_RF_Context context;
+	S2LP_RF_GetClockContext(handle, &context);
+	return S2LP_RFCalc_CenterFrequency(&context, base_frequency, channel_spacing, channel_number);
 }
 
 double S2LP_RF_CalculateBaseFreqResolution(S2LP_Handle* handle) {
-	double const first_freq = S2LP_RF_CalculateBaseFrequency(handle, 100000);
-	double const second_freq = S2LP_RF_CalculateBaseFrequency(handle, 100001);
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+
+	double const first_freq = S2LP_RFCalc_BaseFrequency(&context, 100000);
+	double const second_freq = S2LP_RFCalc_BaseFrequency(&context, 100001);
 	return second_freq - first_freq;
 }
 
@@ -267,47 +251,21 @@ double S2LP_RF_CalculateChannelResolution(S2LP_Handle* handle, double base_frequ
 }
 
 double S2LP_RF_CalculateFrequencyDeviation(S2LP_Handle* handle, uint8_t mantissa, uint8_t exponent) {
-	double const fxo = S2LP_GetClockFrequency(handle);
-	double const fxo_divided = fxo / (double) (1ull << 19ull);
-	double const pll_div = (S2LP_RF_GetSynthBand(handle) == S2LP_SYNTH_BAND_HIGH ? 4.0 : 8.0);
-	double const ref_div = (S2LP_IsRefDivEnabled(handle) ? 2.0 : 1.0);
-	double const denominator = pll_div * ref_div;
-
-	if (exponent == 0) {
-		double const nominator = round(ref_div * (double) mantissa * (pll_div / 8.0));
-		return fxo_divided * (nominator / denominator);
-	} else {
-		double const d_fdev = ref_div * (256.0 + (double) mantissa);
-		double const exponent_pow = (1ull << (exponent - 1));
-		double const nominator = round(d_fdev * exponent_pow * (pll_div / 8.0));
-		return fxo_divided * (nominator / denominator);
-	}
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+	return S2LP_RFCalc_FrequencyDeviation(&context, mantissa, exponent);
 }
 
 uint8_t S2LP_RF_CalculateFreqDevExponent(S2LP_Handle* handle, uint32_t deviation) {
-	for (uint8_t exponent = S2LP_FDEV_EXPONENT_MIN; exponent <= S2LP_FDEV_EXPONENT_MAX; exponent++) {
-		if (S2LP_RF_CalculateFrequencyDeviation(handle, S2LP_FDEV_MANTISSA_MAX, exponent) > deviation) {
-			return exponent;
-		}
-	}
-
-	return S2LP_FDEV_EXPONENT_INVALID;
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+	return S2LP_RFCalc_FreqDevExponent(&context, deviation);
 }
 
 uint8_t S2LP_RF_CalculateFreqDevMantissa(S2LP_Handle* handle, uint8_t exponent, uint32_t deviation) {
-	uint32_t const frequency_max = S2LP_RF_CalculateFrequencyDeviation(handle,
-	S2LP_FDEV_MANTISSA_MAX, exponent);
-	uint32_t const frequency_min = (exponent > 0 ? S2LP_RF_CalculateFrequencyDeviation(handle,
-	S2LP_FDEV_MANTISSA_MAX, exponent - 1) :
-													0);
-
-	uint32_t const frequency_range = frequency_max - frequency_min;
-	uint32_t const corrected_frequency_start = deviation - frequency_min;
-	double const frequency_position = (double) (corrected_frequency_start) / (double) (frequency_range);
-	double approx_mantissa = (double) (S2LP_FDEV_MANTISSA_MIN) * (1.0 - frequency_position)
-			+ ((double) (S2LP_FDEV_MANTISSA_MAX) * frequency_position);
-
-	return (uint8_t) round(approx_mantissa);
+	S2LP_RF_Context context;
+	S2LP_RF_GetContext(handle, &context);
+	return S2LP_RFCalc_FreqDevMantissa(&context, exponent, deviation);
 }
 
 S2LP_ChargePumpCurrent S2LP_RF_GetChargePumpCurrent(S2LP_Handle* handle) {
@@ -9,6 +9,7 @@
 #define S2LP_S2LP_RF_H_
 
 #include "s2lp_mcu_interface.h"
+#include "s2lp_rf_calc.h"
 
 // ==== Radio management ====
 
@@ -36,13 +37,21 @@ void S2LP_RF_SetDataRate(S2LP_Handle* handle, uint32_t datarate);
 // Set frequency deviation mantissa/exponent
 void S2LP_RF_SetFrequencyDeviationRaw(S2LP_Handle* handle, uint8_t mantissa, uint8_t exponent);
 // Calculates closest factors for frequency deviation and writes it to S2-LP
-// Read it from S2-LP to check the real deviation
+// Read it from S2-LP (or use S2LP_RFCalc_SolveFrequencyDeviation) to check the real deviation
 void S2LP_RF_SetFrequencyDeviation(S2LP_Handle* handle, uint32_t deviation);
 // Set constelattion mapping (see table 41 and 42 in datasheet for details)
 void S2LP_RF_SetConstellationMapping(S2LP_Handle* handle, uint8_t mapping);
 // Set frequency interpolation state for GFSK shaping
 void S2LP_RF_SetFrequencyInterpolation(S2LP_Handle* handle, bool state);
 
+// Capture the context for RF calculations (see s2lp_rf_calc.h). Synthesizer band and
+// reference divider state are tracked by the handle, so it does not access S2-LP.
+void S2LP_RF_GetContext(S2LP_Handle* handle, S2LP_RF_Context* context);
+// Read synthesizer band and reference divider state from S2-LP into the handle context.
+// Needed only when they were changed outside of the library - invalidate the register
+// cache first, if it's enabled.
+void S2LP_RF_RefreshContext(S2LP_Handle* handle);
+
 // Helper calculation functions - datarate
 /* HOW TO USE THEM
  * First, you HAVE to init S2LP_Handle with the correct clock frequency,
@@ -57,11 +66,17 @@ void S2LP_RF_SetFrequencyInterpolation(S2LP_Handle* handle, bool state);
  * different from expected value, usually by margin of few bytes per second.
  *
  * To calculate mantissa or exponent separately, you can use CalculateDataRateExponent
- * and CalculateDataRateMantissa functions. These are used in CalculateDataRateCoeffs,
- * which is used in SetDataRate function of this module.
+ * and CalculateDataRateMantissa functions. CalculateDataRateCoeffs (used by SetDataRate)
+ * doesn't use them - it searches all the exponents for the pair giving minimal error,
+ * see S2LP_RFCalc_SolveDataRate, which also reports the error.
+ *
+ * Functions below are wrappers of S2LP_RFCalc_* functions from s2lp_rf_calc.h.
+ * The ones depending on synthesizer band and reference divider take them from
+ * the context tracked by the handle, none of them accesses S2-LP.
  */
 
-// Calculate the sync word for specified frequency. Does not access S2-LP
+// Calculate the sync word for specified frequency.
+// Uses band and refdiv state tracked by the handle
 uint32_t S2LP_RF_CalculateSyncForBaseFrequency(S2LP_Handle* handle, uint32_t frequency);
 
 // Calculate the datarate based on mantissa, exponent and S2-LP clock frequency.
@@ -74,14 +89,14 @@ uint8_t S2LP_RF_CalculateDataRateExponent(S2LP_Handle* handle, uint32_t datarate
 // Does not access S2-LP. There's no real way to check for errors here,
 // so double-check it by re-calculating datarate.
 uint16_t S2LP_RF_CalculateDataRateMantissa(S2LP_Handle* handle, uint32_t datarate, uint8_t exponent);
-// Calculate the closest mantissa and exponent for specified datarate.
+// Calculate the mantissa and exponent giving the closest datarate.
 // Does not access S2-LP
 void S2LP_RF_CalculateDataRateCoeffs(S2LP_Handle* handle, uint32_t datarate, uint16_t* mantissa, uint8_t* exponent);
 
 // Helper calculation functions - channel base frequency and spacing
 
 // Returns the base frequency based on frequency band and synthesizer value
-// Frequency band and reference divider state is read from S2-LP.
+// Uses band and refdiv state tracked by the handle
 double S2LP_RF_CalculateBaseFrequency(S2LP_Handle* handle, uint32_t synth_value);
 
 // Returns the center frequency of channel, specified by base frequency and channel config
@@ -90,23 +105,23 @@ double S2LP_RF_CalculateCenterFrequency(S2LP_Handle* handle, double base_frequen
 
 // Returns the resolution of base frequency (by calculating the frequency difference
 // between calculated frequencies with different synth values)
-// Reads information about the current band from S2-LP
+// Uses band and refdiv state tracked by the handle
 double S2LP_RF_CalculateBaseFreqResolution(S2LP_Handle* handle);
 
 // Returns the channel spacing resolution (by calculating the frequency difference
 // between neighbour channels)
 double S2LP_RF_CalculateChannelResolution(S2LP_Handle* handle, double base_frequency);
 
-// Calculate frequency deviation. Reads info about reference divider and
-// synthesizer band from S2-LP
+// Calculate frequency deviation.
+// Uses band and refdiv state tracked by the handle
 double S2LP_RF_CalculateFrequencyDeviation(S2LP_Handle* handle, uint8_t mantissa, uint8_t exponent);
 
 // Calculate minimal frequency deviation exponent for specified frequency deviation
-// Reads the data about band and refdiv from S2-LP
+// Uses band and refdiv state tracked by the handle
 uint8_t S2LP_RF_CalculateFreqDevExponent(S2LP_Handle* handle, uint32_t deviation);
 
 // Calculate closest mantissa for specified deviation with specified exponent
-// Reads the data about band and refdiv from S2-LP (calls CalculateFrequencyDeviation function)
+// Uses band and refdiv state tracked by the handle
 uint8_t S2LP_RF_CalculateFreqDevMantissa(S2LP_Handle* handle, uint8_t exponent, uint32_t deviation);
 
 // Getters. Self-explanatory. See functions above and documentation for details.
@@ -0,0 +1,554 @@
+/*
+ * s2lp_rf_calc.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_rf_calc.h"
+#include "s2lp_mcu_interface.h"
+#include <math.h>
+
+// Integer helpers, used by fixed-point calculations and solvers
+
+// Integer division rounding half up, just like round() does for positive values
+static uint64_t S2LP_RFCalc_DivRound(uint64_t numerator, uint64_t denominator) {
+	return (numerator + denominator / 2) / denominator;
+}
+
+static uint32_t S2LP_RFCalc_PLLDivider(S2LP_RF_Context const* context) {
+	return (context->band == S2LP_SYNTH_BAND_HIGH ? 4 : 8);
+}
+
+static uint32_t S2LP_RFCalc_RefDivider(S2LP_RF_Context const* context) {
+	return (context->ref_div ? 2 : 1);
+}
+
+// Frequency deviation is fxo * nominator / (2^19 * pll_div * ref_div). Returns the numerator
+// of this fraction, and the denominator via pointer.
+static uint64_t S2LP_RFCalc_FrequencyDeviationFraction(uint32_t fxo, uint32_t pll_div, uint32_t ref_div,
+		uint8_t mantissa, uint8_t exponent, uint64_t* denominator) {
+	uint64_t nominator = 0;
+
+	if (exponent == 0) {
+		nominator = S2LP_RFCalc_DivRound((uint64_t) ref_div * mantissa * pll_div, 8);
+	} else {
+		uint64_t const d_fdev = (uint64_t) ref_div * (256 + mantissa);
+		nominator = S2LP_RFCalc_DivRound((d_fdev << (exponent - 1)) * pll_div, 8);
+	}
+
+	*denominator = ((uint64_t) pll_div * ref_div) << 19;
+	return (uint64_t) fxo * nominator;
+}
+
+static uint64_t S2LP_RFCalc_AbsDiff(uint64_t a, uint64_t b) {
+	return (a > b ? a - b : b - a);
+}
+
+// Number of significant bits of the value
+static int S2LP_RFCalc_BitLength(uint64_t value) {
+	int length = 0;
+	for (int shift = 32; shift > 0; shift >>= 1) {
+		if ((value >> shift) != 0) {
+			value >>= shift;
+			length += shift;
+		}
+	}
+	return length + (int) value;
+}
+
+// Clamp the octave found from the value, so the exponents around it can be checked
+static int S2LP_RFCalc_ClampOctave(int octave, int min, int max) {
+	return (octave < min ? min : (octave > max ? max : octave));
+}
+
+uint32_t S2LP_RFCalc_ClockFrequency(S2LP_ClockFrequency frequency) {
+	switch (frequency) {
+		case S2LP_CLOCK_FREQ_24MHZ:
+			return 24000000;
+		case S2LP_CLOCK_FREQ_25MHZ:
+			return 25000000;
+		case S2LP_CLOCK_FREQ_26MHZ:
+			return 26000000;
+		case S2LP_CLOCK_FREQ_48MHZ:
+			return 48000000;
+		case S2LP_CLOCK_FREQ_50MHZ:
+			return 50000000;
+		case S2LP_CLOCK_FREQ_52MHZ:
+			return 52000000;
+		case S2LP_CLOCK_FREQ_INVALID:
+		default:
+			return 0;
+	}
+}
+
+bool S2LP_RFCalc_IsDigitalClockDivided(S2LP_ClockFrequency frequency) {
+	return (frequency == S2LP_CLOCK_FREQ_48MHZ || frequency == S2LP_CLOCK_FREQ_50MHZ
+			|| frequency == S2LP_CLOCK_FREQ_52MHZ);
+}
+
+void S2LP_RFCalc_InitContext(S2LP_RF_Context* context, S2LP_ClockFrequency frequency, S2LP_SynthesizerBand band,
+		bool ref_div) {
+	context->fxo = S2LP_RFCalc_ClockFrequency(frequency);
+	context->fdig = (S2LP_RFCalc_IsDigitalClockDivided(frequency) ? context->fxo / 2 : context->fxo);
+	context->band = band;
+	context->ref_div = ref_div;
+}
+
+bool S2LP_RFCalc_SynthBandForFrequency(uint32_t frequency, S2LP_SynthesizerBand* band) {
+	if (frequency >= S2LP_SYNTH_HIGH_BAND_MIN && frequency <= S2LP_SYNTH_HIGH_BAND_MAX) {
+		*band = S2LP_SYNTH_BAND_HIGH;
+	} else if (frequency >= S2LP_SYNTH_MID_BAND_MIN && frequency <= S2LP_SYNTH_MID_BAND_MAX) {
+		*band = S2LP_SYNTH_BAND_MID;
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+uint32_t S2LP_RFCalc_SyncForBaseFrequency(S2LP_RF_Context const* context, uint32_t frequency) {
+#ifdef S2LP_FIXED_POINT_MATH
+	uint64_t const fxo = context->fxo;
+	if (fxo == 0) {
+		return 0;
+	}
+
+	uint64_t const multiplier = (S2LP_RFCalc_PLLDivider(context) / 2) * S2LP_RFCalc_RefDivider(context);
+	return (uint32_t) ((((uint64_t) frequency * multiplier) << 20) / fxo);
+#else
+	double const fbase = frequency;
+	double const pll_div = (context->band == S2LP_SYNTH_BAND_HIGH ? 4.0 : 8.0);
+	double const ref_div = (context->ref_div ? 2.0 : 1.0);
+	double const fxo = context->fxo;
+	double const pow20 = (1 << 20);
+
+	double const div_const = ((pll_div / 2.0) * ref_div) / fxo;
+	return (uint32_t) (fbase * div_const * pow20);
+#endif
+}
+
+uint32_t S2LP_RFCalc_DataRateValue(S2LP_RF_Context const* context, uint16_t mantissa, uint8_t exponent) {
+#ifdef S2LP_FIXED_POINT_MATH
+	uint64_t const fdig = context->fdig;
+
+	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+		return (uint32_t) S2LP_RFCalc_DivRound(fdig * mantissa, 1ull << 32);
+	} else if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		return (mantissa == 0 ? 0 : (uint32_t) S2LP_RFCalc_DivRound(fdig, 8ull * mantissa));
+	} else {
+		return (uint32_t) S2LP_RFCalc_DivRound(fdig * (65536ull + mantissa), 1ull << (33 - exponent));
+	}
+#else
+	double datarate = 0;
+	double fdig = context->fdig;
+
+	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+		double const pow_32 = (1ull << 32ull);
+		datarate = (double) fdig * ((double) mantissa / pow_32);
+	} else if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		// Same as fixed-point, instead of rounding infinity
+		datarate = (mantissa == 0 ? 0 : fdig / (8.0 * (double) mantissa));
+	} else {
+		double const pow_33 = (1ull << 33ull);
+		double const pow_16 = (1ull << 16ull);
+		double const exponent_pow = (1 << exponent);
+		double const nominator = (pow_16 + (double) mantissa) * exponent_pow;
+		datarate = (double) fdig * (nominator / pow_33);
+	}
+
+	return (uint32_t) round(datarate);
+#endif
+}
+
+uint8_t S2LP_RFCalc_DataRateExponent(S2LP_RF_Context const* context, uint32_t datarate) {
+	for (uint8_t exponent = S2LP_DATARATE_EXPONENT_MIN; exponent <= S2LP_DATARATE_EXPONENT_MAX; exponent++) {
+		if (S2LP_RFCalc_DataRateValue(context, S2LP_DATARATE_MANTISSA_MAX, exponent) > datarate) {
+			return exponent;
+		}
+	}
+
+	return S2LP_DATARATE_EXPONENT_INVALID;
+}
+
+uint16_t S2LP_RFCalc_DataRateMantissa(S2LP_RF_Context const* context, uint32_t datarate, uint8_t exponent) {
+#ifdef S2LP_FIXED_POINT_MATH
+	uint64_t const fdig = context->fdig;
+	if (fdig == 0) {
+		return 0;
+	}
+
+	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+		return (uint16_t) S2LP_RFCalc_DivRound((uint64_t) datarate << 32, fdig);
+	} else if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		return (datarate == 0 ? 0 : (uint16_t) S2LP_RFCalc_DivRound(fdig, 8ull * datarate));
+	} else {
+		return (uint16_t) (S2LP_RFCalc_DivRound((uint64_t) datarate << (33 - exponent), fdig) - 65536);
+	}
+#else
+	double mantissa = 0;
+	double fdig = context->fdig;
+
+	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+		double const pow_32 = (1ull << 32ull);
+		mantissa = (pow_32 * (double) datarate) / fdig;
+	} else if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		mantissa = (datarate == 0 ? 0 : fdig / (8.0 * datarate));
+	} else {
+		double const pow_33 = (1ull << 33ull);
+		double const pow_16 = (1ull << 16ull);
+		double const exponent_pow = (1 << exponent);
+		double const nominator = pow_33 * datarate;
+		double const denominator = fdig * exponent_pow;
+		mantissa = (nominator / denominator) - pow_16;
+	}
+
+	// Datarates below the exponent's range wrap around, like in fixed-point
+	return (uint16_t) (int64_t) round(mantissa);
+#endif
+}
+
+// ===== Solvers =====
+// Both datarate and frequency deviation are linear in mantissa for given exponent, and exponents
+// cover consecutive octaves, so the requested value is first converted to a position on the
+// octave scale. The best coefficients are then among the mantissas around the exact solution
+// in this octave and its neighbours (rounding can move the optimum across the octave border).
+// Errors are compared exactly, in integers.
+
+typedef struct S2LP_RFCalc_Candidate_t {
+	uint16_t mantissa;
+	uint8_t exponent;
+	uint64_t error;
+} S2LP_RFCalc_Candidate;
+
+// Datarate of coefficients multiplied by 2^33, exact for all exponents except the maximal one
+static uint64_t S2LP_RFCalc_ScaledDataRate(uint64_t fdig, uint16_t mantissa, uint8_t exponent) {
+	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+		return (fdig * mantissa) << 1;
+	}
+
+	return (fdig * (65536ull + mantissa)) << exponent;
+}
+
+static void S2LP_RFCalc_TryDataRate(S2LP_RFCalc_Candidate* best, uint64_t fdig, uint32_t datarate, int64_t mantissa,
+		uint8_t exponent) {
+	// Mantissa of 0 with maximal exponent would mean infinite datarate
+	int64_t const mantissa_min = (exponent == S2LP_DATARATE_EXPONENT_MAX ? 1 : S2LP_DATARATE_MANTISSA_MIN);
+	if (mantissa < mantissa_min) {
+		mantissa = mantissa_min;
+	} else if (mantissa > S2LP_DATARATE_MANTISSA_MAX) {
+		mantissa = S2LP_DATARATE_MANTISSA_MAX;
+	}
+
+	// Error in 1/2^33 bps units
+	uint64_t error = 0;
+	if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		// fdig / (8 * mantissa), error is difference * 2^30 / mantissa. It's rarely better than
+		// the linear one, so it's compared without division first.
+		uint64_t const difference = S2LP_RFCalc_AbsDiff(fdig, 8ull * (uint64_t) mantissa * datarate);
+		if (best->error < (1ull << 47) && (difference << 30) >= best->error * (uint64_t) mantissa) {
+			return;
+		}
+
+		error = S2LP_RFCalc_DivRound(difference << 30, (uint64_t) mantissa);
+	} else {
+		error = S2LP_RFCalc_AbsDiff(S2LP_RFCalc_ScaledDataRate(fdig, (uint16_t) mantissa, exponent),
+				(uint64_t) datarate << 33);
+	}
+
+	if (error < best->error) {
+		best->mantissa = (uint16_t) mantissa;
+		best->exponent = exponent;
+		best->error = error;
+	}
+}
+
+static bool S2LP_RFCalc_FindDataRate(S2LP_RF_Context const* context, uint32_t datarate,
+		S2LP_RFCalc_Candidate* best) {
+	uint64_t const fdig = context->fdig;
+	if (fdig == 0 || datarate > fdig) {
+		return false;
+	}
+
+	best->mantissa = 0;
+	best->exponent = S2LP_DATARATE_EXPONENT_MIN;
+	best->error = UINT64_MAX;
+
+	// datarate * 2^33 / fdig = 2 * mantissa for minimal exponent, (65536 + mantissa) * 2^exponent for others
+	uint64_t const position = ((uint64_t) datarate << 33) / fdig;
+	int const octave = S2LP_RFCalc_ClampOctave(S2LP_RFCalc_BitLength(position) - 17, S2LP_DATARATE_EXPONENT_MIN,
+	S2LP_DATARATE_EXPONENT_MAX - 1);
+	for (int exponent = octave - 1; exponent <= octave + 1; exponent++) {
+		if (exponent < S2LP_DATARATE_EXPONENT_MIN || exponent >= S2LP_DATARATE_EXPONENT_MAX) {
+			continue;
+		}
+
+		int64_t mantissa = 0;
+		if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+			mantissa = (int64_t) (position >> 1);
+		} else {
+			mantissa = (int64_t) (position >> exponent) - 65536;
+		}
+
+		S2LP_RFCalc_TryDataRate(best, fdig, datarate, mantissa, (uint8_t) exponent);
+		S2LP_RFCalc_TryDataRate(best, fdig, datarate, mantissa + 1, (uint8_t) exponent);
+	}
+
+	// Maximal exponent has it's own formula, with better resolution than the linear one on the
+	// lowest datarates (and exact values for datarates dividing fdig / 8)
+	if (datarate > 0) {
+		int64_t const mantissa = (int64_t) (fdig / (8ull * datarate));
+		S2LP_RFCalc_TryDataRate(best, fdig, datarate, mantissa, S2LP_DATARATE_EXPONENT_MAX);
+		S2LP_RFCalc_TryDataRate(best, fdig, datarate, mantissa + 1, S2LP_DATARATE_EXPONENT_MAX);
+	}
+
+	return true;
+}
+
+void S2LP_RFCalc_DataRateCoeffs(S2LP_RF_Context const* context, uint32_t datarate, uint16_t* mantissa,
+		uint8_t* exponent) {
+	S2LP_RFCalc_Candidate best;
+	if (!S2LP_RFCalc_FindDataRate(context, datarate, &best)) {
+		*mantissa = 0;
+		*exponent = S2LP_DATARATE_EXPONENT_INVALID;
+		return;
+	}
+
+	*mantissa = best.mantissa;
+	*exponent = best.exponent;
+}
+
+bool S2LP_RFCalc_SolveDataRate(S2LP_RF_Context const* context, uint32_t datarate, S2LP_RFCalc_Solution* solution) {
+	S2LP_RFCalc_Candidate best;
+	if (!S2LP_RFCalc_FindDataRate(context, datarate, &best)) {
+		return false;
+	}
+
+	double achieved = 0;
+	if (best.exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		achieved = (double) context->fdig / (8.0 * (double) best.mantissa);
+	} else {
+		achieved = (double) S2LP_RFCalc_ScaledDataRate(context->fdig, best.mantissa, best.exponent)
+				/ (double) (1ull << 33);
+	}
+
+	solution->mantissa = best.mantissa;
+	solution->exponent = best.exponent;
+	solution->value = S2LP_RFCalc_DataRateValue(context, best.mantissa, best.exponent);
+	solution->error_ppm = (datarate == 0 ? 0. : (achieved - datarate) / datarate * 1e6);
+	return true;
+}
+
+static uint64_t S2LP_RFCalc_BaseFrequencyInteger(S2LP_RF_Context const* context, uint32_t synth_value) {
+	uint64_t const fxo = context->fxo;
+	uint64_t const divider = (S2LP_RFCalc_PLLDivider(context) / 2) * S2LP_RFCalc_RefDivider(context);
+	return S2LP_RFCalc_DivRound(fxo * synth_value, divider << 20);
+}
+
+double S2LP_RFCalc_BaseFrequency(S2LP_RF_Context const* context, uint32_t synth_value) {
+#ifdef S2LP_FIXED_POINT_MATH
+	return (double) S2LP_RFCalc_BaseFrequencyInteger(context, synth_value);
+#else
+	double const pll_div = (context->band == S2LP_SYNTH_BAND_HIGH ? 4.0 : 8.0);
+	double const ref_div = (context->ref_div ? 2.0 : 1.0);
+	double const fxo = context->fxo;
+
+	double const synth_divided = synth_value / ((double) (1ull << 20ull));
+	double const fxo_denominator = (pll_div / 2.0) * ref_div;
+	return round((fxo / fxo_denominator) * synth_divided);
+#endif
+}
+
+double S2LP_RFCalc_CenterFrequency(S2LP_RF_Context const* context, double base_frequency, uint8_t channel_spacing,
+		uint8_t channel_number) {
+	double const fxo = context->fxo;
+	double const fxo_divided = fxo / (double) (1ull << 15ull);
+	return round(base_frequency + (fxo_divided * (double) channel_spacing) * (double) channel_number);
+}
+
+uint32_t S2LP_RFCalc_BaseFrequencyValue(S2LP_RF_Context const* context, uint32_t synth_value) {
+	return (uint32_t) S2LP_RFCalc_BaseFrequencyInteger(context, synth_value);
+}
+
+uint32_t S2LP_RFCalc_CenterFrequencyValue(S2LP_RF_Context const* context, uint32_t base_frequency,
+		uint8_t channel_spacing, uint8_t channel_number) {
+	// Channel spacing unit is fXO / 2^15
+	uint64_t const offset = (uint64_t) context->fxo * channel_spacing * channel_number;
+	return base_frequency + (uint32_t) S2LP_RFCalc_DivRound(offset, 1ull << 15);
+}
+
+double S2LP_RFCalc_FrequencyDeviation(S2LP_RF_Context const* context, uint8_t mantissa, uint8_t exponent) {
+#ifdef S2LP_FIXED_POINT_MATH
+	uint64_t denominator = 0;
+	uint64_t const nominator = S2LP_RFCalc_FrequencyDeviationFraction(context->fxo,
+			S2LP_RFCalc_PLLDivider(context), S2LP_RFCalc_RefDivider(context), mantissa, exponent, &denominator);
+	// Denominator is a power of 2, so the result is exact
+	return (double) nominator / (double) denominator;
+#else
+	double const fxo = context->fxo;
+	double const fxo_divided = fxo / (double) (1ull << 19ull);
+	double const pll_div = (context->band == S2LP_SYNTH_BAND_HIGH ? 4.0 : 8.0);
+	double const ref_div = (context->ref_div ? 2.0 : 1.0);
+	double const denominator = pll_div * ref_div;
+
+	if (exponent == 0) {
+		double const nominator = round(ref_div * (double) mantissa * (pll_div / 8.0));
+		return fxo_divided * (nominator / denominator);
+	} else {
+		double const d_fdev = ref_div * (256.0 + (double) mantissa);
+		double const exponent_pow = (1ull << (exponent - 1));
+		double const nominator = round(d_fdev * exponent_pow * (pll_div / 8.0));
+		return fxo_divided * (nominator / denominator);
+	}
+#endif
+}
+
+uint8_t S2LP_RFCalc_FreqDevExponent(S2LP_RF_Context const* context, uint32_t deviation) {
+#ifdef S2LP_FIXED_POINT_MATH
+	uint32_t const fxo = context->fxo;
+	uint32_t const pll_div = S2LP_RFCalc_PLLDivider(context);
+	uint32_t const ref_div = S2LP_RFCalc_RefDivider(context);
+
+	for (uint8_t exponent = S2LP_FDEV_EXPONENT_MIN; exponent <= S2LP_FDEV_EXPONENT_MAX; exponent++) {
+		uint64_t denominator = 0;
+		uint64_t const nominator = S2LP_RFCalc_FrequencyDeviationFraction(fxo, pll_div, ref_div,
+		S2LP_FDEV_MANTISSA_MAX, exponent, &denominator);
+		if (nominator > (uint64_t) deviation * denominator) {
+			return exponent;
+		}
+	}
+#else
+	for (uint8_t exponent = S2LP_FDEV_EXPONENT_MIN; exponent <= S2LP_FDEV_EXPONENT_MAX; exponent++) {
+		if (S2LP_RFCalc_FrequencyDeviation(context, S2LP_FDEV_MANTISSA_MAX, exponent) > deviation) {
+			return exponent;
+		}
+	}
+#endif
+
+	return S2LP_FDEV_EXPONENT_INVALID;
+}
+
+uint8_t S2LP_RFCalc_FreqDevMantissa(S2LP_RF_Context const* context, uint8_t exponent, uint32_t deviation) {
+#ifdef S2LP_FIXED_POINT_MATH
+	uint32_t const fxo = context->fxo;
+	uint32_t const pll_div = S2LP_RFCalc_PLLDivider(context);
+	uint32_t const ref_div = S2LP_RFCalc_RefDivider(context);
+	uint64_t denominator = 0;
+
+	// Denominator is read after the call setting it (operands of division are unsequenced)
+	uint64_t nominator = S2LP_RFCalc_FrequencyDeviationFraction(fxo, pll_div, ref_div, S2LP_FDEV_MANTISSA_MAX,
+			exponent, &denominator);
+	uint32_t const frequency_max = (uint32_t) (nominator / denominator);
+	uint32_t frequency_min = 0;
+	if (exponent > 0) {
+		nominator = S2LP_RFCalc_FrequencyDeviationFraction(fxo, pll_div, ref_div, S2LP_FDEV_MANTISSA_MAX,
+				exponent - 1, &denominator);
+		frequency_min = (uint32_t) (nominator / denominator);
+	}
+
+	uint32_t const frequency_range = frequency_max - frequency_min;
+	uint32_t const corrected_frequency_start = deviation - frequency_min;
+	if (frequency_range == 0) {
+		return S2LP_FDEV_MANTISSA_MIN;
+	}
+
+	// Linear interpolation between minimal and maximal mantissa
+	uint64_t const approx_mantissa = (uint64_t) S2LP_FDEV_MANTISSA_MIN * frequency_range
+			+ (uint64_t) (S2LP_FDEV_MANTISSA_MAX - S2LP_FDEV_MANTISSA_MIN) * corrected_frequency_start;
+	return (uint8_t) S2LP_RFCalc_DivRound(approx_mantissa, frequency_range);
+#else
+	uint32_t const frequency_max = S2LP_RFCalc_FrequencyDeviation(context,
+	S2LP_FDEV_MANTISSA_MAX, exponent);
+	uint32_t const frequency_min = (exponent > 0 ? S2LP_RFCalc_FrequencyDeviation(context,
+	S2LP_FDEV_MANTISSA_MAX, exponent - 1) :
+													0);
+
+	uint32_t const frequency_range = frequency_max - frequency_min;
+	uint32_t const corrected_frequency_start = deviation - frequency_min;
+	double const frequency_position = (double) (corrected_frequency_start) / (double) (frequency_range);
+	double approx_mantissa = (double) (S2LP_FDEV_MANTISSA_MIN) * (1.0 - frequency_position)
+			+ ((double) (S2LP_FDEV_MANTISSA_MAX) * frequency_position);
+
+	return (uint8_t) round(approx_mantissa);
+#endif
+}
+
+static void S2LP_RFCalc_TryFreqDev(S2LP_RFCalc_Candidate* best, S2LP_RF_Context const* context, uint32_t deviation,
+		int64_t mantissa, uint8_t exponent) {
+	if (mantissa < S2LP_FDEV_MANTISSA_MIN) {
+		mantissa = S2LP_FDEV_MANTISSA_MIN;
+	} else if (mantissa > S2LP_FDEV_MANTISSA_MAX) {
+		mantissa = S2LP_FDEV_MANTISSA_MAX;
+	}
+
+	// Error in 1/denominator Hz units (denominator is the same for all coefficients)
+	uint64_t denominator = 0;
+	uint64_t const nominator = S2LP_RFCalc_FrequencyDeviationFraction(context->fxo, S2LP_RFCalc_PLLDivider(context),
+			S2LP_RFCalc_RefDivider(context), (uint8_t) mantissa, exponent, &denominator);
+	uint64_t const error = S2LP_RFCalc_AbsDiff(nominator, (uint64_t) deviation * denominator);
+
+	if (error < best->error) {
+		best->mantissa = (uint16_t) mantissa;
+		best->exponent = exponent;
+		best->error = error;
+	}
+}
+
+static bool S2LP_RFCalc_FindFreqDev(S2LP_RF_Context const* context, uint32_t deviation,
+		S2LP_RFCalc_Candidate* best) {
+	if (context->fxo == 0) {
+		return false;
+	}
+
+	best->mantissa = 0;
+	best->exponent = S2LP_FDEV_EXPONENT_MIN;
+	best->error = UINT64_MAX;
+
+	// deviation * 2^22 / fxo = mantissa for exponent 0, (256 + mantissa) * 2^(exponent - 1) for others
+	uint64_t const position = ((uint64_t) deviation << 22) / context->fxo;
+	int const octave = S2LP_RFCalc_ClampOctave(S2LP_RFCalc_BitLength(position) - 8, S2LP_FDEV_EXPONENT_MIN,
+	S2LP_FDEV_EXPONENT_MAX);
+	for (int exponent = octave - 1; exponent <= octave + 1; exponent++) {
+		if (exponent < S2LP_FDEV_EXPONENT_MIN || exponent > S2LP_FDEV_EXPONENT_MAX) {
+			continue;
+		}
+
+		int64_t const mantissa = (exponent == 0 ? (int64_t) position : (int64_t) (position >> (exponent - 1)) - 256);
+		S2LP_RFCalc_TryFreqDev(best, context, deviation, mantissa, (uint8_t) exponent);
+		S2LP_RFCalc_TryFreqDev(best, context, deviation, mantissa + 1, (uint8_t) exponent);
+	}
+
+	return true;
+}
+
+void S2LP_RFCalc_FreqDevCoeffs(S2LP_RF_Context const* context, uint32_t deviation, uint8_t* mantissa,
+		uint8_t* exponent) {
+	S2LP_RFCalc_Candidate best;
+	if (!S2LP_RFCalc_FindFreqDev(context, deviation, &best)) {
+		*mantissa = 0;
+		*exponent = S2LP_FDEV_EXPONENT_INVALID;
+		return;
+	}
+
+	*mantissa = (uint8_t) best.mantissa;
+	*exponent = best.exponent;
+}
+
+bool S2LP_RFCalc_SolveFrequencyDeviation(S2LP_RF_Context const* context, uint32_t deviation,
+		S2LP_RFCalc_Solution* solution) {
+	S2LP_RFCalc_Candidate best;
+	if (!S2LP_RFCalc_FindFreqDev(context, deviation, &best)) {
+		return false;
+	}
+
+	uint64_t denominator = 0;
+	uint64_t const nominator = S2LP_RFCalc_FrequencyDeviationFraction(context->fxo, S2LP_RFCalc_PLLDivider(context),
+			S2LP_RFCalc_RefDivider(context), (uint8_t) best.mantissa, best.exponent, &denominator);
+	double const achieved = (double) nominator / (double) denominator;
+
+	solution->mantissa = best.mantissa;
+	solution->exponent = best.exponent;
+	solution->value = (uint32_t) S2LP_RFCalc_DivRound(nominator, denominator);
+	solution->error_ppm = (deviation == 0 ? 0. : (achieved - deviation) / deviation * 1e6);
+	return true;
+}
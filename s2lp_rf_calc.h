@@ -0,0 +1,93 @@
+/*
+ * s2lp_rf_calc.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_RF_CALC_H_
+#define S2LP_S2LP_RF_CALC_H_
+
+// RF calculations - pure functions converting between physical values (frequency,
+// datarate, deviation) and register coefficients. They never access S2-LP, everything
+// they depend on is passed in S2LP_RF_Context, which is captured once (with
+// S2LP_RF_GetContext from s2lp_rf.h, or S2LP_RFCalc_InitContext when the configuration
+// is known upfront) and reused for any amount of calculations.
+// Usage:
+//   S2LP_RF_Context context;
+//   S2LP_RF_GetContext(&handle, &context);
+//   uint8_t const exponent = S2LP_RFCalc_FreqDevExponent(&context, 20000);
+//   uint8_t const mantissa = S2LP_RFCalc_FreqDevMantissa(&context, exponent, 20000);
+
+#include "s2lp_constants.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct S2LP_RF_Context_t {
+	// Base (fXO) and digital domain clock frequency, in Hz
+	uint32_t fxo;
+	uint32_t fdig;
+	// Synthesizer band and reference divider state
+	S2LP_SynthesizerBand band;
+	bool ref_div;
+} S2LP_RF_Context;
+
+// Coefficients found by solver, with the value they produce
+typedef struct S2LP_RFCalc_Solution_t {
+	uint16_t mantissa;
+	uint8_t exponent;
+	// Achieved value (rounded to integer), and it's exact relative error to requested one,
+	// in parts per million (negative if achieved value is lower)
+	uint32_t value;
+	double error_ppm;
+} S2LP_RFCalc_Solution;
+
+// Get the frequency of S2-LP clock in Hz, 0 for invalid one
+uint32_t S2LP_RFCalc_ClockFrequency(S2LP_ClockFrequency frequency);
+// Check if digital clock is base clock / 2 (true for 48, 50 and 52MHz clocks)
+bool S2LP_RFCalc_IsDigitalClockDivided(S2LP_ClockFrequency frequency);
+
+// Init the context with known configuration
+void S2LP_RFCalc_InitContext(S2LP_RF_Context* context, S2LP_ClockFrequency frequency, S2LP_SynthesizerBand band,
+		bool ref_div);
+// Get the synthesizer band covering the frequency. Returns false if it's out of both bands.
+bool S2LP_RFCalc_SynthBandForFrequency(uint32_t frequency, S2LP_SynthesizerBand* band);
+
+// Synthesizer and base frequency
+uint32_t S2LP_RFCalc_SyncForBaseFrequency(S2LP_RF_Context const* context, uint32_t frequency);
+double S2LP_RFCalc_BaseFrequency(S2LP_RF_Context const* context, uint32_t synth_value);
+double S2LP_RFCalc_CenterFrequency(S2LP_RF_Context const* context, double base_frequency, uint8_t channel_spacing,
+		uint8_t channel_number);
+// Same as above, rounded to Hz with integer math only (also with S2LP_FLOATING_POINT_MATH).
+// Base frequency has to fit in 32 bits, which holds for synthesizer words of both bands.
+uint32_t S2LP_RFCalc_BaseFrequencyValue(S2LP_RF_Context const* context, uint32_t synth_value);
+uint32_t S2LP_RFCalc_CenterFrequencyValue(S2LP_RF_Context const* context, uint32_t base_frequency,
+		uint8_t channel_spacing, uint8_t channel_number);
+
+// Datarate (depends only on the clock)
+uint32_t S2LP_RFCalc_DataRateValue(S2LP_RF_Context const* context, uint16_t mantissa, uint8_t exponent);
+uint8_t S2LP_RFCalc_DataRateExponent(S2LP_RF_Context const* context, uint32_t datarate);
+uint16_t S2LP_RFCalc_DataRateMantissa(S2LP_RF_Context const* context, uint32_t datarate, uint8_t exponent);
+// Mantissa and exponent giving the datarate closest to requested one (see S2LP_RFCalc_SolveDataRate).
+// Exponent is S2LP_DATARATE_EXPONENT_INVALID for invalid clock or datarate higher than the digital clock.
+void S2LP_RFCalc_DataRateCoeffs(S2LP_RF_Context const* context, uint32_t datarate, uint16_t* mantissa,
+		uint8_t* exponent);
+// Find the coefficients minimising absolute datarate error, considering all exponents (including the
+// maximal one, with it's separate formula). Uses closed-form solution - only a few candidates around
+// it are evaluated. Returns false for invalid clock or datarate higher than the digital clock.
+bool S2LP_RFCalc_SolveDataRate(S2LP_RF_Context const* context, uint32_t datarate, S2LP_RFCalc_Solution* solution);
+
+// Frequency deviation
+double S2LP_RFCalc_FrequencyDeviation(S2LP_RF_Context const* context, uint8_t mantissa, uint8_t exponent);
+uint8_t S2LP_RFCalc_FreqDevExponent(S2LP_RF_Context const* context, uint32_t deviation);
+uint8_t S2LP_RFCalc_FreqDevMantissa(S2LP_RF_Context const* context, uint8_t exponent, uint32_t deviation);
+// Mantissa and exponent giving the deviation closest to requested one (see S2LP_RFCalc_SolveFrequencyDeviation).
+// Exponent is S2LP_FDEV_EXPONENT_INVALID for invalid clock.
+void S2LP_RFCalc_FreqDevCoeffs(S2LP_RF_Context const* context, uint32_t deviation, uint8_t* mantissa,
+		uint8_t* exponent);
+// Find the coefficients minimising absolute frequency deviation error, the same way as
+// S2LP_RFCalc_SolveDataRate does. Returns false for invalid clock.
+bool S2LP_RFCalc_SolveFrequencyDeviation(S2LP_RF_Context const* context, uint32_t deviation,
+		S2LP_RFCalc_Solution* solution);
+
+#endif /* S2LP_S2LP_RF_CALC_H_ */
@@ -0,0 +1,122 @@
+/*
+ * s2lp_ring.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_ring.h"
+#include "s2lp.h"
+
+#include <string.h>
+
+#define S2LP_RING_INDEX(index) ((index) & (S2LP_RING_MAX_FRAMES - 1))
+
+void S2LP_Ring_Init(S2LP_Ring* ring) {
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+	ring->stored = 0;
+	ring->dropped = 0;
+	ring->max_level = 0;
+}
+
+S2LP_Frame* S2LP_Ring_Reserve(S2LP_Ring* ring) {
+	size_t const head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	// Acquire pairs with the release in S2LP_Ring_Release, so the consumer is done with the frame
+	size_t const tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	if (head - tail == S2LP_RING_MAX_FRAMES) {
+		ring->dropped++;
+		return NULL;
+	}
+
+	return &ring->frames[S2LP_RING_INDEX(head)];
+}
+
+void S2LP_Ring_Commit(S2LP_Ring* ring) {
+	size_t const head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	size_t const level = head + 1 - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+	ring->stored++;
+	ring->max_level = (level > ring->max_level ? level : ring->max_level);
+	// Release publishes the frame content together with the index
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+bool S2LP_Ring_Push(S2LP_Ring* ring, uint8_t const* data, size_t length) {
+	if (length > S2LP_RING_FRAME_SIZE) {
+		ring->dropped++;
+		return false;
+	}
+
+	S2LP_Frame* const frame = S2LP_Ring_Reserve(ring);
+	if (frame == NULL) {
+		return false;
+	}
+
+	memcpy(frame->data, data, length);
+	frame->length = length;
+	frame->rssi = 0;
+	frame->timestamp = 0;
+	S2LP_Ring_Commit(ring);
+	return true;
+}
+
+bool S2LP_Ring_StoreReceived(S2LP_Ring* ring, S2LP_Handle* handle) {
+	size_t const length = S2LP_PCKT_GetRxPacketLength(handle);
+	S2LP_Frame* frame = NULL;
+
+	if (length > S2LP_RING_FRAME_SIZE) {
+		ring->dropped++;
+	} else {
+		frame = S2LP_Ring_Reserve(ring);
+	}
+
+	S2LP_PacketMetadata metadata;
+	if (!S2LP_ReadReceivedPacket(handle, length, (frame != NULL ? frame->data : NULL), &metadata)) {
+		return false;
+	}
+
+	frame->length = metadata.length;
+	frame->rssi = metadata.rssi;
+	frame->timestamp = metadata.timestamp;
+	S2LP_Ring_Commit(ring);
+	return true;
+}
+
+S2LP_Frame const* S2LP_Ring_Peek(S2LP_Ring* ring) {
+	size_t const tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	// Acquire pairs with the release in S2LP_Ring_Commit, so the frame content is visible
+	size_t const head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+	if (head == tail) {
+		return NULL;
+	}
+
+	return &ring->frames[S2LP_RING_INDEX(tail)];
+}
+
+void S2LP_Ring_Release(S2LP_Ring* ring) {
+	size_t const tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+bool S2LP_Ring_Pop(S2LP_Ring* ring, S2LP_Frame* frame) {
+	S2LP_Frame const* const oldest = S2LP_Ring_Peek(ring);
+	if (oldest == NULL) {
+		return false;
+	}
+
+	memcpy(frame->data, oldest->data, oldest->length);
+	frame->length = oldest->length;
+	frame->rssi = oldest->rssi;
+	frame->timestamp = oldest->timestamp;
+	S2LP_Ring_Release(ring);
+	return true;
+}
+
+size_t S2LP_Ring_GetCount(S2LP_Ring* ring) {
+	size_t const tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+	size_t const head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	return head - tail;
+}
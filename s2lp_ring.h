@@ -0,0 +1,95 @@
+/*
+ * s2lp_ring.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_RING_H_
+#define S2LP_S2LP_RING_H_
+
+// Lock-free single-producer/single-consumer ring of received frames.
+// Producer (nIRQ handler or driver thread) stores received packets, consumer (application)
+// takes them out - without locks or critical sections, the only shared data are two indices
+// with acquire/release ordering. Producer and consumer may run in parallel (threads, ISR and
+// main loop), but there can be only one of each.
+// Frames are reserved and released in place, so the packet goes from the FIFO straight into
+// the ring, and the application can read it without copying.
+// When the ring is full, new packets are dropped (and counted), frames already queued stay.
+// Usage:
+//   // nIRQ handler
+//   if (GETBIT(S2LP_GetInterrupts(&handle), S2LP_INT_RX_DATA_READY)) {
+//     S2LP_Ring_StoreReceived(&ring, &handle);
+//     S2LP_SendCommand(&handle, S2LP_CMD_RX);
+//   }
+//   // application
+//   S2LP_Frame const* frame = NULL;
+//   while ((frame = S2LP_Ring_Peek(&ring)) != NULL) {
+//     process(frame->data, frame->length);
+//     S2LP_Ring_Release(&ring);
+//   }
+
+#include "s2lp_mcu_interface.h"
+
+#include <stdatomic.h>
+
+// Amount of frames in the ring, has to be a power of 2
+#define S2LP_RING_MAX_FRAMES 16
+// Maximal frame length, packets read in one FIFO burst fit in it
+#define S2LP_RING_FRAME_SIZE S2LP_FIFO_SIZE
+
+#if (S2LP_RING_MAX_FRAMES & (S2LP_RING_MAX_FRAMES - 1)) != 0
+#error "S2LP_RING_MAX_FRAMES has to be a power of 2"
+#endif
+
+typedef struct S2LP_Frame_t {
+	uint8_t data[S2LP_RING_FRAME_SIZE];
+	size_t length;
+	// RSSI captured at the end of sync word (raw, see S2LP_Utils_RSSITodBm)
+	uint8_t rssi;
+	// S2LP_GetTime at the moment the frame was stored
+	uint32_t timestamp;
+} S2LP_Frame;
+
+typedef struct S2LP_Ring_t {
+	S2LP_Frame frames[S2LP_RING_MAX_FRAMES];
+	// Free-running indices - head is written only by the producer, tail only by the consumer
+	atomic_size_t head;
+	atomic_size_t tail;
+	// Producer-side counters
+	uint32_t stored;
+	uint32_t dropped;
+	size_t max_level;
+} S2LP_Ring;
+
+void S2LP_Ring_Init(S2LP_Ring* ring);
+
+// === Producer ===
+
+// Get the next free frame, or NULL if the ring is full (the drop is counted).
+// Fill it and publish with S2LP_Ring_Commit.
+S2LP_Frame* S2LP_Ring_Reserve(S2LP_Ring* ring);
+void S2LP_Ring_Commit(S2LP_Ring* ring);
+
+// Copy the data into the next frame. Returns false if the ring is full, or the data is too long.
+bool S2LP_Ring_Push(S2LP_Ring* ring, uint8_t const* data, size_t length);
+
+// Read the received packet from RX FIFO straight into the next frame, with RSSI and timestamp.
+// Call it after RX_DATA_READY. If the ring is full or the packet doesn't fit in a frame, the
+// packet is flushed from the FIFO and counted as dropped. Returns true if the packet was stored.
+bool S2LP_Ring_StoreReceived(S2LP_Ring* ring, S2LP_Handle* handle);
+
+// === Consumer ===
+
+// Get the oldest frame without taking it out, or NULL if the ring is empty.
+// The frame stays valid until S2LP_Ring_Release.
+S2LP_Frame const* S2LP_Ring_Peek(S2LP_Ring* ring);
+void S2LP_Ring_Release(S2LP_Ring* ring);
+
+// Copy the oldest frame out and release it. Returns false if the ring is empty.
+bool S2LP_Ring_Pop(S2LP_Ring* ring, S2LP_Frame* frame);
+
+// Amount of queued frames. Exact only on the producer or consumer side, approximate elsewhere.
+size_t S2LP_Ring_GetCount(S2LP_Ring* ring);
+
+#endif /* S2LP_S2LP_RING_H_ */
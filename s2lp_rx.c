@@ -9,27 +9,18 @@
 #include "s2lp_rx.h"
 #include "bit_helpers.h"
 
-// Channel filter words table
+// Channel filter words table (S2LP_CHANNEL_FILTER_WORDS_TABLE, see s2lp_constants.h)
 
-#define S2LP_CHANNEL_FILTER_WORDS_M 9
-#define S2LP_CHANNEL_FILTER_WORDS_E 10
 #define S2LP_CHANNEL_FILTER_WORDS_LENGTH (S2LP_CHANNEL_FILTER_WORDS_M * S2LP_CHANNEL_FILTER_WORDS_E)
-#define S2LP_CHANNEL_FILTER_WORDS_SIZE (sizeof(double) * S2LP_CHANNEL_FILTER_WORDS_LENGTH)
-// @formatter:off
-double const S2LP_CHANNEL_FILTER_WORDS[S2LP_CHANNEL_FILTER_WORDS_M][S2LP_CHANNEL_FILTER_WORDS_E] =
-        {
-        /* E =            0      1      2      3     4     5     6    7    8    9 */
-        /* M = 0 */ { 800.1, 450.9, 224.7, 112.3, 56.1, 28.0, 14.0, 7.0, 3.5, 1.8},
-        /* M = 1 */ { 795.1, 425.9, 212.4, 106.2, 53.0, 26.5, 13.3, 6.6, 3.3, 1.7},
-        /* M = 2 */ { 768.4, 403.2, 201.1, 100.5, 50.2, 25.1, 12.6, 6.3, 3.1, 1.6},
-        /* M = 3 */ { 736.8, 380.8, 190.0,  95.0, 47.4, 23.7, 11.9, 5.9, 3.0, 1.5},
-        /* M = 4 */ { 705.1, 362.1, 180.7,  90.3, 45.1, 22.6, 11.3, 5.6, 2.8, 1.4},
-        /* M = 5 */ { 670.9, 341.7, 170.6,  85.3, 42.6, 21.3, 10.6, 5.3, 2.7, 1.3},
-        /* M = 6 */ { 642.3, 325.4, 162.4,  81.2, 40.6, 20.3, 10.1, 5.1, 2.5, 1.3},
-        /* M = 7 */ { 586.7, 294.5, 147.1,  73.5, 36.7, 18.4,  9.2, 4.6, 2.3, 1.2},
-        /* M = 8 */ { 541.4, 270.3, 135.0,  67.5, 33.7, 16.9,  8.4, 4.2, 2.1, 1.1},
-        };
-// @formatter:on
+#define S2LP_CHANNEL_FILTER_WORDS_SIZE (sizeof(uint16_t) * S2LP_CHANNEL_FILTER_WORDS_LENGTH)
+uint16_t const S2LP_CHANNEL_FILTER_WORDS[S2LP_CHANNEL_FILTER_WORDS_M][S2LP_CHANNEL_FILTER_WORDS_E] =
+		S2LP_CHANNEL_FILTER_WORDS_TABLE;
+
+// Coefficients of n-th narrowest channel filter
+static void S2LP_RX_ChannelFilterCoeffsAt(size_t position, uint8_t* mantissa, uint8_t* exponent) {
+	*exponent = (uint8_t) (S2LP_CHANNEL_FILTER_WORDS_E - 1 - (position / S2LP_CHANNEL_FILTER_WORDS_M));
+	*mantissa = (uint8_t) (S2LP_CHANNEL_FILTER_WORDS_M - 1 - (position % S2LP_CHANNEL_FILTER_WORDS_M));
+}
 
 void S2LP_RX_SetRSSIThreshold(S2LP_Handle* handle, uint8_t rssi) {
 	S2LP_WriteRegister(handle, S2LP_REG_RSSI_TH, rssi);
@@ -177,6 +168,31 @@ void S2LP_RX_SetChannelFilterValueRaw(S2LP_Handle* handle, uint8_t mantissa, uin
 	S2LP_WriteRegister(handle, S2LP_REG_CHFLT, reg_val);
 }
 
+bool S2LP_RX_SetChannelFilterBandwidth(S2LP_Handle* handle, uint32_t bandwidth) {
+	uint8_t mantissa = 0;
+	uint8_t exponent = 0;
+	if (!S2LP_RX_CalculateChannelFilterCoeffs(handle, bandwidth, &mantissa, &exponent)) {
+		return false;
+	}
+
+	S2LP_RX_SetChannelFilterValueRaw(handle, mantissa, exponent);
+	return true;
+}
+
+void S2LP_RX_SetClockRecoveryAlgorithm(S2LP_Handle* handle, S2LP_ClockRecoveryAlgorithm algorithm) {
+	uint8_t reg_val = S2LP_ReadRegister(handle, S2LP_REG_CLOCKREC2);
+	switch (algorithm) {
+		case S2LP_CLOCK_RECOVERY_DLL:
+			CLEARBIT(reg_val, 4);
+			break;
+		case S2LP_CLOCK_RECOVERY_PLL:
+			SETBIT(reg_val, 4);
+			break;
+	}
+
+	S2LP_WriteRegister(handle, S2LP_REG_CLOCKREC2, reg_val);
+}
+
 void S2LP_RX_SetCarrierSenseMode(S2LP_Handle* handle, S2LP_CS_Mode mode) {
 	uint8_t reg_val = S2LP_ReadRegister(handle, S2LP_REG_RSSI_FLT);
 	CLEARBITS(reg_val, 0b11, 2);
@@ -213,8 +229,10 @@ bool cs_timeout, bool sqi_timeout, bool pqi_timeout) {
 		CLEARBIT(proto_reg_val, 5);
 	}
 
+	S2LP_BeginWriteBatch(handle);
 	S2LP_WriteRegister(handle, S2LP_REG_PROTOCOL2, proto_reg_val);
 	S2LP_WriteRegister(handle, S2LP_REG_PCKT_FLT_OPTIONS, rxt_reg_val);
+	S2LP_CommitWriteBatch(handle);
 }
 
 void S2LP_RX_SetCSBlankingState(S2LP_Handle* handle, bool enabled) {
@@ -257,10 +275,15 @@ void S2LP_RX_SetFIFOAlmostEmptyThreshold(S2LP_Handle* handle, uint8_t threshold)
 }
 
 double S2LP_RX_CalculateAGCMeasureTime(S2LP_Handle* handle, uint8_t time) {
+#ifdef S2LP_FIXED_POINT_MATH
+	// Single rounding, same result as multiplying 12/fdig by a power of 2
+	return (double) (12ull << time) / (double) S2LP_GetDigitalClockFrequency(handle);
+#else
 	double const fdig = S2LP_GetDigitalClockFrequency(handle);
 	double const fdig_divider = 12.0 / fdig;
 	double const meas_time_pow = (double) (1ull << time);
 	return fdig_divider * meas_time_pow;
+#endif
 }
 
 double S2LP_RX_CalculateAGCHoldTime(S2LP_Handle* handle, uint8_t time) {
@@ -271,7 +294,38 @@ double S2LP_RX_CalculateAGCHoldTime(S2LP_Handle* handle, uint8_t time) {
 
 double S2LP_RX_CalculateChannelFilterBandwidth(S2LP_Handle* handle, uint8_t mantissa, uint8_t exponent) {
 	double const fdig = S2LP_GetDigitalClockFrequency(handle);
-	return S2LP_CHANNEL_FILTER_WORDS[mantissa][exponent] * (fdig / 26000000.0);
+	return (S2LP_CHANNEL_FILTER_WORDS[mantissa][exponent] / 10.0) * (fdig / 26000000.0);
+}
+
+bool S2LP_RX_CalculateChannelFilterCoeffs(S2LP_Handle* handle, uint32_t bandwidth, uint8_t* mantissa,
+		uint8_t* exponent) {
+	uint64_t const fdig = S2LP_GetDigitalClockFrequency(handle);
+	if (fdig == 0) {
+		return false;
+	}
+
+	// Table value (at 26MHz) needed for requested bandwidth at fdig, rounded up
+	uint64_t const target = ((uint64_t) bandwidth * 260000ull + fdig - 1) / fdig;
+
+	// Lower bound search in the sorted order of the table
+	size_t low = 0;
+	size_t high = S2LP_CHANNEL_FILTER_WORDS_LENGTH;
+	while (low < high) {
+		size_t const middle = (low + high) / 2;
+		S2LP_RX_ChannelFilterCoeffsAt(middle, mantissa, exponent);
+		if (S2LP_CHANNEL_FILTER_WORDS[*mantissa][*exponent] < target) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	if (low == S2LP_CHANNEL_FILTER_WORDS_LENGTH) {
+		return false;
+	}
+
+	S2LP_RX_ChannelFilterCoeffsAt(low, mantissa, exponent);
+	return true;
 }
 
 uint8_t S2LP_RX_GetRSSIThreshold(S2LP_Handle* handle) {
@@ -368,6 +422,11 @@ double S2LP_RX_GetChannelFilterValue(S2LP_Handle* handle) {
 	return S2LP_RX_CalculateChannelFilterBandwidth(handle, mantissa, exponent);
 }
 
+S2LP_ClockRecoveryAlgorithm S2LP_RX_GetClockRecoveryAlgorithm(S2LP_Handle* handle) {
+	uint8_t const reg_val = S2LP_ReadRegister(handle, S2LP_REG_CLOCKREC2);
+	return (S2LP_ClockRecoveryAlgorithm) GETBIT(reg_val, 4);
+}
+
 S2LP_CS_Mode S2LP_RX_GetCarrierSenseMode(S2LP_Handle* handle) {
 	uint8_t const reg_val = S2LP_ReadRegister(handle, S2LP_REG_RSSI_FLT);
 	return (S2LP_CS_Mode) GETBITS(reg_val, 0b11, 2);
@@ -47,6 +47,13 @@ void S2LP_RX_SetAGCState(S2LP_Handle* handle, bool enabled);
 // Enable/disable AGC level freezing after sync word has been received
 void S2LP_RX_SetAGCFreezeOnSyncState(S2LP_Handle* handle, bool enabled);
 void S2LP_RX_SetChannelFilterValueRaw(S2LP_Handle* handle, uint8_t mantissa, uint8_t exponent);
+// Set the narrowest channel filter with bandwidth (in Hz) at least equal to requested one.
+// Returns false if it's wider than the widest filter.
+bool S2LP_RX_SetChannelFilterBandwidth(S2LP_Handle* handle, uint32_t bandwidth);
+
+// Set clock recovery algorithm. DLL locks faster, PLL keeps the symbol timing
+// through long runs of equal bits (not whitened or coded data).
+void S2LP_RX_SetClockRecoveryAlgorithm(S2LP_Handle* handle, S2LP_ClockRecoveryAlgorithm algorithm);
 
 // Set carrier sense mode (static or dynamic with threshold)
 void S2LP_RX_SetCarrierSenseMode(S2LP_Handle* handle, S2LP_CS_Mode mode);
@@ -75,9 +82,14 @@ double S2LP_RX_CalculateAGCMeasureTime(S2LP_Handle* handle, uint8_t time);
 // Should be ranging from 0.5us to about 32us
 double S2LP_RX_CalculateAGCHoldTime(S2LP_Handle* handle, uint8_t time);
 
-// Calculates real RX channel filter bandwidth
+// Calculates real RX channel filter bandwidth, in kHz
 double S2LP_RX_CalculateChannelFilterBandwidth(S2LP_Handle* handle, uint8_t mantissa, uint8_t exponent);
 
+// Find coefficients of the narrowest channel filter with bandwidth (in Hz) at least equal to requested one,
+// with binary search over the filter table. Returns false if there's no such filter.
+bool S2LP_RX_CalculateChannelFilterCoeffs(S2LP_Handle* handle, uint32_t bandwidth, uint8_t* mantissa,
+		uint8_t* exponent);
+
 // Getters
 uint8_t S2LP_RX_GetRSSIThreshold(S2LP_Handle* handle);
 uint8_t S2LP_RX_GetAFCFastLoopGain(S2LP_Handle* handle);
@@ -97,6 +109,7 @@ uint8_t S2LP_RX_GetChannelFilterExponent(S2LP_Handle* handle);
 void S2LP_RX_GetChannelFilterValueRaw(S2LP_Handle* handle, uint8_t* mantissa, uint8_t* exponent);
 double S2LP_RX_GetChannelFilterValue(S2LP_Handle* handle);
 S2LP_CS_Mode S2LP_RX_GetCarrierSenseMode(S2LP_Handle* handle);
+S2LP_ClockRecoveryAlgorithm S2LP_RX_GetClockRecoveryAlgorithm(S2LP_Handle* handle);
 void S2LP_RX_GetTimerStopConfig(S2LP_Handle* handle, bool* rx_timeout_and_or, bool* cs_timeout, bool* sqi_timeout,
 		bool* pqi_timeout);
 S2LP_RX_Source S2LP_RX_GetDataSource(S2LP_Handle* handle);
@@ -0,0 +1,64 @@
+/*
+ * s2lp_snapshot.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_snapshot.h"
+#include "bit_helpers.h"
+
+void S2LP_Snapshot_Capture(S2LP_Handle* handle, S2LP_Snapshot* snapshot) {
+	uint8_t image[S2LP_CONFIG_REGISTERS_END] = { 0 };
+	uint8_t unknown[(S2LP_CONFIG_REGISTERS_END + 7) / 8] = { 0 };
+
+	// Take everything that's known first
+	for (size_t i = 0; i < S2LP_CONFIG_REGISTER_COUNT; i++) {
+		uint8_t const address = S2LP_REGISTER_MAP[i].address;
+		if (!S2LP_PeekRegister(handle, (S2LP_Register) address, &image[address])) {
+			SETBIT(unknown[address / 8], address % 8);
+		}
+	}
+
+	// Read the rest in bursts, joining the runs separated by small gaps
+	size_t reg = 0;
+	while (reg < S2LP_CONFIG_REGISTERS_END) {
+		if (!GETBIT(unknown[reg / 8], reg % 8)) {
+			reg++;
+			continue;
+		}
+
+		size_t const start = reg;
+		size_t end = reg + 1;
+		for (size_t next = end; next < S2LP_CONFIG_REGISTERS_END && next - end < S2LP_SNAPSHOT_READ_MAX_GAP + 1;
+				next++) {
+			if (GETBIT(unknown[next / 8], next % 8)) {
+				end = next + 1;
+			}
+		}
+
+		S2LP_BatchReadRegisters(handle, (S2LP_Register) start, &image[start], end - start);
+		reg = end;
+	}
+
+	for (size_t i = 0; i < S2LP_CONFIG_REGISTER_COUNT; i++) {
+		snapshot->values[i] = image[S2LP_REGISTER_MAP[i].address];
+	}
+}
+
+void S2LP_Snapshot_Restore(S2LP_Handle* handle, S2LP_Snapshot const* snapshot) {
+	S2LP_BeginWriteBatch(handle);
+
+	for (size_t i = 0; i < S2LP_CONFIG_REGISTER_COUNT; i++) {
+		S2LP_Register const address = (S2LP_Register) S2LP_REGISTER_MAP[i].address;
+
+		uint8_t current = 0;
+		if (S2LP_PeekRegister(handle, address, &current) && current == snapshot->values[i]) {
+			continue;
+		}
+
+		S2LP_WriteRegister(handle, address, snapshot->values[i]);
+	}
+
+	S2LP_CommitWriteBatch(handle);
+}
@@ -0,0 +1,42 @@
+/*
+ * s2lp_snapshot.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_SNAPSHOT_H_
+#define S2LP_S2LP_SNAPSHOT_H_
+
+// Register snapshots - copy of all documented configuration registers, which can be
+// restored after the chip loses it's configuration (shutdown, reset), instead of
+// repeating the whole initialization sequence.
+// Usage:
+//   S2LP_Snapshot snapshot;
+//   S2LP_Snapshot_Capture(&handle, &snapshot);
+//   S2LP_Shutdown(&handle);
+//   ...
+//   S2LP_Wakeup(&handle);
+//   S2LP_Snapshot_Restore(&handle, &snapshot);
+
+#include "s2lp_mcu_interface.h"
+
+// Unknown registers separated by up to this amount of other registers are read in
+// a single burst. Reading a register costs 1 byte on the bus, while starting a new
+// burst costs 2 header bytes and chip select toggle.
+#define S2LP_SNAPSHOT_READ_MAX_GAP 4
+
+typedef struct S2LP_Snapshot_t {
+	// Values of documented configuration registers, in the address order
+	// (the same as in S2LP_REGISTER_MAP)
+	uint8_t values[S2LP_CONFIG_REGISTER_COUNT];
+} S2LP_Snapshot;
+
+// Save the configuration. Values known by the handle (register cache) are taken
+// without touching the chip, the rest is read in the minimal amount of bursts.
+void S2LP_Snapshot_Capture(S2LP_Handle* handle, S2LP_Snapshot* snapshot);
+// Restore the configuration. Registers which are known to already have the right
+// values are skipped, the rest goes out as a write batch (contiguous bursts).
+void S2LP_Snapshot_Restore(S2LP_Handle* handle, S2LP_Snapshot const* snapshot);
+
+#endif /* S2LP_S2LP_SNAPSHOT_H_ */
@@ -0,0 +1,285 @@
+/*
+ * s2lp_static_config.hpp
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_STATIC_CONFIG_HPP_
+#define S2LP_S2LP_STATIC_CONFIG_HPP_
+
+// Compile-time register values of static radio configurations (C++17).
+// S2LP_StaticConfig calculates SYNT3..SYNT0, MOD4..MOD0 and CHFLT bytes at compile time,
+// with the same integer math as the runtime functions (fixed-point RF calculations and
+// solvers from s2lp_rf_calc.c, channel filter search from s2lp_rx.c), so neither the
+// math nor the code doing it lands in the firmware. Invalid configurations (clock,
+// frequency out of synthesizer bands, datarate out of range, deviation or filter
+// bandwidth not achievable) don't compile.
+// Register bits not covered by the configuration (charge pump current, MOD1 interpolation
+// and mapping bits) get their reset values. Reference divider state is the one set by
+// S2LP_Initialize.
+// Usage:
+//   using Config = S2LP_StaticConfig<S2LP_CLOCK_FREQ_50MHZ, S2LP_MODULATION_2GFSK, 868000000, 38400, 20000, 100000>;
+//   S2LP_Initialize(&handle, S2LP_CLOCK_FREQ_50MHZ);
+//   Config::Apply(&handle);
+
+#include <stdint.h>
+
+extern "C" {
+#include "s2lp_constants.h"
+#include "s2lp_mcu_interface.h"
+}
+
+// Maximal relative error of datarate and deviation accepted at compile time, in ppm
+#define S2LP_STATIC_MAX_ERROR_PPM 10000
+
+// Same table as S2LP_CHANNEL_FILTER_WORDS in s2lp_rx.c
+constexpr uint16_t S2LP_STATIC_CHANNEL_FILTER_WORDS[S2LP_CHANNEL_FILTER_WORDS_M][S2LP_CHANNEL_FILTER_WORDS_E] =
+		S2LP_CHANNEL_FILTER_WORDS_TABLE;
+
+struct S2LP_Static_Coeffs {
+	uint16_t mantissa;
+	uint8_t exponent;
+	// Error of the coefficients, in units of the solver
+	uint64_t error;
+};
+
+// ===== Helpers, the same as in s2lp_rf_calc.c =====
+
+constexpr uint64_t S2LP_Static_DivRound(uint64_t numerator, uint64_t denominator) {
+	return (numerator + denominator / 2) / denominator;
+}
+
+constexpr uint64_t S2LP_Static_AbsDiff(uint64_t a, uint64_t b) {
+	return (a > b ? a - b : b - a);
+}
+
+constexpr int S2LP_Static_BitLength(uint64_t value) {
+	int length = 0;
+	while (value != 0) {
+		value >>= 1;
+		length++;
+	}
+	return length;
+}
+
+constexpr int S2LP_Static_Clamp(int value, int min, int max) {
+	return (value < min ? min : (value > max ? max : value));
+}
+
+constexpr uint32_t S2LP_Static_ClockFrequency(S2LP_ClockFrequency frequency) {
+	switch (frequency) {
+		case S2LP_CLOCK_FREQ_24MHZ:
+			return 24000000;
+		case S2LP_CLOCK_FREQ_25MHZ:
+			return 25000000;
+		case S2LP_CLOCK_FREQ_26MHZ:
+			return 26000000;
+		case S2LP_CLOCK_FREQ_48MHZ:
+			return 48000000;
+		case S2LP_CLOCK_FREQ_50MHZ:
+			return 50000000;
+		case S2LP_CLOCK_FREQ_52MHZ:
+			return 52000000;
+		default:
+			return 0;
+	}
+}
+
+// Reference divider is enabled by S2LP_Initialize exactly when digital clock is divided
+constexpr bool S2LP_Static_IsDivided(S2LP_ClockFrequency frequency) {
+	return (frequency == S2LP_CLOCK_FREQ_48MHZ || frequency == S2LP_CLOCK_FREQ_50MHZ
+			|| frequency == S2LP_CLOCK_FREQ_52MHZ);
+}
+
+constexpr uint32_t S2LP_Static_DigitalClock(S2LP_ClockFrequency frequency) {
+	return S2LP_Static_ClockFrequency(frequency) / (S2LP_Static_IsDivided(frequency) ? 2 : 1);
+}
+
+constexpr bool S2LP_Static_IsMidBand(uint32_t frequency) {
+	return frequency >= S2LP_SYNTH_MID_BAND_MIN && frequency <= S2LP_SYNTH_MID_BAND_MAX;
+}
+
+constexpr bool S2LP_Static_IsHighBand(uint32_t frequency) {
+	return frequency >= S2LP_SYNTH_HIGH_BAND_MIN && frequency <= S2LP_SYNTH_HIGH_BAND_MAX;
+}
+
+// ===== Synthesizer =====
+
+constexpr uint32_t S2LP_Static_SynthValue(S2LP_ClockFrequency clock, uint32_t frequency) {
+	uint64_t const pll_div = (S2LP_Static_IsMidBand(frequency) ? 8 : 4);
+	uint64_t const ref_div = (S2LP_Static_IsDivided(clock) ? 2 : 1);
+	return (uint32_t) ((((uint64_t) frequency * (pll_div / 2) * ref_div) << 20) / S2LP_Static_ClockFrequency(clock));
+}
+
+// ===== Datarate solver, see S2LP_RFCalc_SolveDataRate =====
+
+constexpr uint64_t S2LP_Static_ScaledDataRate(uint64_t fdig, uint16_t mantissa, uint8_t exponent) {
+	if (exponent == S2LP_DATARATE_EXPONENT_MIN) {
+		return (fdig * mantissa) << 1;
+	}
+
+	return (fdig * (65536ull + mantissa)) << exponent;
+}
+
+constexpr void S2LP_Static_TryDataRate(S2LP_Static_Coeffs& best, uint64_t fdig, uint32_t datarate, int64_t mantissa,
+		uint8_t exponent) {
+	int64_t const mantissa_min = (exponent == S2LP_DATARATE_EXPONENT_MAX ? 1 : S2LP_DATARATE_MANTISSA_MIN);
+	mantissa = (mantissa < mantissa_min ? mantissa_min :
+			(mantissa > S2LP_DATARATE_MANTISSA_MAX ? S2LP_DATARATE_MANTISSA_MAX : mantissa));
+
+	// Error in 1/2^33 bps units
+	uint64_t error = 0;
+	if (exponent == S2LP_DATARATE_EXPONENT_MAX) {
+		error = S2LP_Static_DivRound(S2LP_Static_AbsDiff(fdig, 8ull * (uint64_t) mantissa * datarate) << 30,
+				(uint64_t) mantissa);
+	} else {
+		error = S2LP_Static_AbsDiff(S2LP_Static_ScaledDataRate(fdig, (uint16_t) mantissa, exponent),
+				(uint64_t) datarate << 33);
+	}
+
+	if (error < best.error) {
+		best = { (uint16_t) mantissa, exponent, error };
+	}
+}
+
+constexpr S2LP_Static_Coeffs S2LP_Static_DataRateCoeffs(S2LP_ClockFrequency clock, uint32_t datarate) {
+	uint64_t const fdig = S2LP_Static_DigitalClock(clock);
+	S2LP_Static_Coeffs best = { 0, S2LP_DATARATE_EXPONENT_MIN, UINT64_MAX };
+
+	uint64_t const position = ((uint64_t) datarate << 33) / fdig;
+	int const octave = S2LP_Static_Clamp(S2LP_Static_BitLength(position) - 17, S2LP_DATARATE_EXPONENT_MIN,
+	S2LP_DATARATE_EXPONENT_MAX - 1);
+	for (int exponent = octave - 1; exponent <= octave + 1; exponent++) {
+		if (exponent < S2LP_DATARATE_EXPONENT_MIN || exponent >= S2LP_DATARATE_EXPONENT_MAX) {
+			continue;
+		}
+
+		int64_t const mantissa = (exponent == S2LP_DATARATE_EXPONENT_MIN ? (int64_t) (position >> 1) :
+				(int64_t) (position >> exponent) - 65536);
+		S2LP_Static_TryDataRate(best, fdig, datarate, mantissa, (uint8_t) exponent);
+		S2LP_Static_TryDataRate(best, fdig, datarate, mantissa + 1, (uint8_t) exponent);
+	}
+
+	if (datarate > 0) {
+		int64_t const mantissa = (int64_t) (fdig / (8ull * datarate));
+		S2LP_Static_TryDataRate(best, fdig, datarate, mantissa, S2LP_DATARATE_EXPONENT_MAX);
+		S2LP_Static_TryDataRate(best, fdig, datarate, mantissa + 1, S2LP_DATARATE_EXPONENT_MAX);
+	}
+
+	return best;
+}
+
+// ===== Frequency deviation solver, see S2LP_RFCalc_SolveFrequencyDeviation =====
+
+// Deviation is fxo * nominator / (2^19 * pll_div * ref_div), this is the fxo * nominator part
+constexpr uint64_t S2LP_Static_FreqDevNominator(uint32_t fxo, uint32_t pll_div, uint32_t ref_div, uint8_t mantissa,
+		uint8_t exponent) {
+	uint64_t const nominator = (exponent == 0 ? S2LP_Static_DivRound((uint64_t) ref_div * mantissa * pll_div, 8) :
+			S2LP_Static_DivRound((((uint64_t) ref_div * (256 + mantissa)) << (exponent - 1)) * pll_div, 8));
+	return (uint64_t) fxo * nominator;
+}
+
+constexpr S2LP_Static_Coeffs S2LP_Static_FreqDevCoeffs(S2LP_ClockFrequency clock, uint32_t frequency,
+		uint32_t deviation) {
+	uint32_t const fxo = S2LP_Static_ClockFrequency(clock);
+	uint32_t const pll_div = (S2LP_Static_IsMidBand(frequency) ? 8 : 4);
+	uint32_t const ref_div = (S2LP_Static_IsDivided(clock) ? 2 : 1);
+	uint64_t const denominator = ((uint64_t) pll_div * ref_div) << 19;
+	S2LP_Static_Coeffs best = { 0, S2LP_FDEV_EXPONENT_MIN, UINT64_MAX };
+
+	uint64_t const position = ((uint64_t) deviation << 22) / fxo;
+	int const octave = S2LP_Static_Clamp(S2LP_Static_BitLength(position) - 8, S2LP_FDEV_EXPONENT_MIN,
+	S2LP_FDEV_EXPONENT_MAX);
+	for (int exponent = octave - 1; exponent <= octave + 1; exponent++) {
+		if (exponent < S2LP_FDEV_EXPONENT_MIN || exponent > S2LP_FDEV_EXPONENT_MAX) {
+			continue;
+		}
+
+		int64_t const estimate = (exponent == 0 ? (int64_t) position : (int64_t) (position >> (exponent - 1)) - 256);
+		for (int64_t mantissa = estimate; mantissa <= estimate + 1; mantissa++) {
+			int64_t const clamped = (mantissa < S2LP_FDEV_MANTISSA_MIN ? S2LP_FDEV_MANTISSA_MIN :
+					(mantissa > S2LP_FDEV_MANTISSA_MAX ? S2LP_FDEV_MANTISSA_MAX : mantissa));
+			uint64_t const error = S2LP_Static_AbsDiff(S2LP_Static_FreqDevNominator(fxo, pll_div, ref_div,
+					(uint8_t) clamped, (uint8_t) exponent), (uint64_t) deviation * denominator);
+			if (error < best.error) {
+				best = { (uint16_t) clamped, (uint8_t) exponent, error };
+			}
+		}
+	}
+
+	// Error in ppm of requested deviation
+	best.error = (deviation == 0 ? 0 : (best.error * 1000000ull) / ((uint64_t) deviation * denominator));
+	return best;
+}
+
+// ===== Channel filter, see S2LP_RX_CalculateChannelFilterCoeffs =====
+
+// Narrowest filter with bandwidth at least equal to requested one. Exponent is 0xFF if there's none.
+constexpr S2LP_Static_Coeffs S2LP_Static_ChannelFilterCoeffs(S2LP_ClockFrequency clock, uint32_t bandwidth) {
+	uint64_t const fdig = S2LP_Static_DigitalClock(clock);
+	uint64_t const target = ((uint64_t) bandwidth * 260000ull + fdig - 1) / fdig;
+
+	// Table is sorted from E = 9, M = 8 to E = 0, M = 0
+	for (int exponent = S2LP_CHANNEL_FILTER_WORDS_E - 1; exponent >= 0; exponent--) {
+		for (int mantissa = S2LP_CHANNEL_FILTER_WORDS_M - 1; mantissa >= 0; mantissa--) {
+			if (S2LP_STATIC_CHANNEL_FILTER_WORDS[mantissa][exponent] >= target) {
+				return { (uint16_t) mantissa, (uint8_t) exponent, 0 };
+			}
+		}
+	}
+
+	return { 0, 0xFF, 0 };
+}
+
+// ===== Configuration =====
+
+template<S2LP_ClockFrequency Clock, S2LP_Modulation Modulation, uint32_t BaseFrequency, uint32_t DataRate,
+		uint32_t FrequencyDeviation, uint32_t FilterBandwidth>
+struct S2LP_StaticConfig {
+	static_assert(S2LP_Static_ClockFrequency(Clock) != 0, "Invalid clock frequency");
+	static_assert(S2LP_Static_IsHighBand(BaseFrequency) || S2LP_Static_IsMidBand(BaseFrequency),
+			"Base frequency is out of synthesizer bands");
+	static_assert(DataRate >= S2LP_DATARATE_MIN && DataRate <= S2LP_DATARATE_MAX, "Datarate is out of range");
+
+	static constexpr uint32_t synth = S2LP_Static_SynthValue(Clock, BaseFrequency);
+	static constexpr S2LP_Static_Coeffs datarate = S2LP_Static_DataRateCoeffs(Clock, DataRate);
+	static constexpr S2LP_Static_Coeffs deviation = S2LP_Static_FreqDevCoeffs(Clock, BaseFrequency,
+			FrequencyDeviation);
+	static constexpr S2LP_Static_Coeffs filter = S2LP_Static_ChannelFilterCoeffs(Clock, FilterBandwidth);
+
+	// Datarate error is in 1/2^33 bps units
+	static_assert(datarate.error / DataRate <= (S2LP_STATIC_MAX_ERROR_PPM * (1ull << 33)) / 1000000ull,
+			"Datarate can't be achieved with this clock");
+	static_assert(deviation.error <= S2LP_STATIC_MAX_ERROR_PPM, "Frequency deviation can't be achieved");
+	static_assert(filter.exponent != 0xFF, "Channel filter bandwidth is too wide");
+
+	// SYNT3, SYNT2, SYNT1, SYNT0 (charge pump current bits at reset value)
+	static constexpr uint8_t synt[4] = {
+		(uint8_t) ((S2LP_REG_DEFAULT_SYNT3 & 0b11100000) | (S2LP_Static_IsMidBand(BaseFrequency) ? 0b10000 : 0)
+				| ((synth >> 24) & 0b1111)),
+		(uint8_t) (synth >> 16),
+		(uint8_t) (synth >> 8),
+		(uint8_t) synth,
+	};
+
+	// MOD4, MOD3, MOD2, MOD1, MOD0, CHFLT
+	static constexpr uint8_t modem[6] = {
+		(uint8_t) (datarate.mantissa >> 8),
+		(uint8_t) datarate.mantissa,
+		(uint8_t) ((Modulation << 4) | datarate.exponent),
+		(uint8_t) ((S2LP_REG_DEFAULT_MOD1 & 0b11110000) | deviation.exponent),
+		(uint8_t) deviation.mantissa,
+		(uint8_t) ((filter.mantissa << 4) | filter.exponent),
+	};
+
+	// Write the configuration - two burst writes (one with write batch started by caller)
+	static void Apply(S2LP_Handle* handle) {
+		uint8_t synt_values[4] = { synt[0], synt[1], synt[2], synt[3] };
+		uint8_t modem_values[6] = { modem[0], modem[1], modem[2], modem[3], modem[4], modem[5] };
+		S2LP_BatchWriteRegisters(handle, S2LP_REG_SYNT3, synt_values, sizeof(synt_values));
+		S2LP_BatchWriteRegisters(handle, S2LP_REG_MOD4, modem_values, sizeof(modem_values));
+	}
+};
+
+#endif /* S2LP_S2LP_STATIC_CONFIG_HPP_ */
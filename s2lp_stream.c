@@ -0,0 +1,157 @@
+/*
+ * s2lp_stream.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_stream.h"
+
+#include <string.h>
+
+// Write as much of the remaining data as fits in the FIFO
+static void S2LP_Stream_Refill(S2LP_StreamTX* stream) {
+	uint8_t const level = S2LP_TX_GetFIFOCount(stream->handle);
+	size_t const space = (level < S2LP_FIFO_SIZE ? S2LP_FIFO_SIZE - level : 0);
+	size_t const remaining = stream->length - stream->position;
+	size_t const amount = (remaining < space ? remaining : space);
+
+	stream->statistics.min_fifo_level = (level < stream->statistics.min_fifo_level ? level :
+			stream->statistics.min_fifo_level);
+	if (amount == 0) {
+		return;
+	}
+
+	stream->position += S2LP_WriteFIFO(stream->handle, amount, stream->data + stream->position);
+	stream->statistics.refills++;
+	stream->statistics.refill_bytes += amount;
+}
+
+// Read everything the FIFO has, bytes over the buffer capacity are flushed
+static void S2LP_Stream_Drain(S2LP_StreamRX* stream) {
+	uint8_t const level = S2LP_RX_GetFIFOCount(stream->handle);
+	size_t const space = stream->capacity - stream->length;
+	size_t const amount = (level < space ? level : space);
+
+	stream->statistics.max_fifo_level = (level > stream->statistics.max_fifo_level ? level :
+			stream->statistics.max_fifo_level);
+	if (amount > 0) {
+		stream->length += S2LP_ReadFIFO(stream->handle, amount, stream->buffer + stream->length);
+		stream->statistics.drains++;
+		stream->statistics.drain_bytes += amount;
+	}
+
+	if (amount < level) {
+		// Dropped bytes are counted from the packet length at the end
+		S2LP_SendCommand(stream->handle, S2LP_CMD_FLUSHRXFIFO);
+	}
+}
+
+bool S2LP_Stream_StartTX(S2LP_StreamTX* stream, S2LP_Handle* handle, uint8_t* data, size_t length,
+		uint8_t threshold) {
+	if (length == 0 || length > 65535 || threshold >= S2LP_FIFO_SIZE) {
+		return false;
+	}
+
+	memset(stream, 0, sizeof(S2LP_StreamTX));
+	stream->handle = handle;
+	stream->data = data;
+	stream->length = length;
+	stream->statistics.min_fifo_level = S2LP_FIFO_SIZE;
+
+	S2LP_BeginWriteBatch(handle);
+	S2LP_PCKT_SetPacketLength(handle, length);
+	S2LP_TX_SetFIFOAlmostEmptyThreshold(handle, threshold);
+	S2LP_SetFIFOInterruptSource(handle, S2LP_FIFO_TX);
+	S2LP_CommitWriteBatch(handle);
+
+	// Flags left from previous transmissions would trigger refill or finish too early
+	S2LP_GetInterrupts(handle);
+	S2LP_SendCommand(handle, S2LP_CMD_FLUSHTXFIFO);
+
+	stream->position = S2LP_WriteFIFO(handle, length, data);
+	stream->state = S2LP_STREAM_RUNNING;
+	S2LP_SendCommand(handle, S2LP_CMD_TX);
+	return true;
+}
+
+S2LP_StreamState S2LP_Stream_ProcessTX(S2LP_StreamTX* stream, uint32_t interrupts) {
+	if (stream->state != S2LP_STREAM_RUNNING) {
+		return stream->state;
+	}
+
+	if (GETBIT(interrupts, S2LP_INT_TX_FIFO_ERROR)) {
+		// Packet is cut, the rest of it would be sent as a new one
+		stream->statistics.underflows++;
+		S2LP_SendCommand(stream->handle, S2LP_CMD_SABORT);
+		S2LP_SendCommand(stream->handle, S2LP_CMD_FLUSHTXFIFO);
+		stream->state = S2LP_STREAM_ERROR;
+		return stream->state;
+	}
+
+	if (GETBIT(interrupts, S2LP_INT_TX_FIFO_ALMOST_EMPTY) && stream->position < stream->length) {
+		S2LP_Stream_Refill(stream);
+	}
+
+	if (GETBIT(interrupts, S2LP_INT_TX_DATA_SENT)) {
+		stream->state = S2LP_STREAM_DONE;
+	}
+
+	return stream->state;
+}
+
+bool S2LP_Stream_StartRX(S2LP_StreamRX* stream, S2LP_Handle* handle, uint8_t* buffer, size_t capacity,
+		uint8_t threshold) {
+	if (capacity == 0 || threshold == 0 || threshold >= S2LP_FIFO_SIZE) {
+		return false;
+	}
+
+	memset(stream, 0, sizeof(S2LP_StreamRX));
+	stream->handle = handle;
+	stream->buffer = buffer;
+	stream->capacity = capacity;
+
+	S2LP_BeginWriteBatch(handle);
+	S2LP_RX_SetFIFOAlmostFullThreshold(handle, threshold);
+	S2LP_SetFIFOInterruptSource(handle, S2LP_FIFO_RX);
+	S2LP_CommitWriteBatch(handle);
+
+	S2LP_GetInterrupts(handle);
+	S2LP_SendCommand(handle, S2LP_CMD_FLUSHRXFIFO);
+
+	stream->state = S2LP_STREAM_RUNNING;
+	S2LP_SendCommand(handle, S2LP_CMD_RX);
+	return true;
+}
+
+S2LP_StreamState S2LP_Stream_ProcessRX(S2LP_StreamRX* stream, uint32_t interrupts) {
+	if (stream->state != S2LP_STREAM_RUNNING) {
+		return stream->state;
+	}
+
+	if (GETBIT(interrupts, S2LP_INT_RX_FIFO_ERROR)) {
+		stream->statistics.fifo_overflows++;
+		S2LP_SendCommand(stream->handle, S2LP_CMD_SABORT);
+		S2LP_SendCommand(stream->handle, S2LP_CMD_FLUSHRXFIFO);
+		stream->state = S2LP_STREAM_ERROR;
+		return stream->state;
+	}
+
+	bool const done = GETBIT(interrupts, S2LP_INT_RX_DATA_READY);
+	if (done || GETBIT(interrupts, S2LP_INT_RX_FIFO_ALMOST_FULL)) {
+		// After data ready the FIFO holds the whole tail, so single drain is enough
+		S2LP_Stream_Drain(stream);
+	}
+
+	if (done) {
+		stream->packet_length = S2LP_PCKT_GetRxPacketLength(stream->handle);
+		if (stream->packet_length > stream->length) {
+			stream->statistics.dropped_bytes += (uint32_t) (stream->packet_length - stream->length);
+			stream->state = S2LP_STREAM_ERROR;
+		} else {
+			stream->state = S2LP_STREAM_DONE;
+		}
+	}
+
+	return stream->state;
+}
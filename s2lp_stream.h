@@ -0,0 +1,109 @@
+/*
+ * s2lp_stream.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_STREAM_H_
+#define S2LP_S2LP_STREAM_H_
+
+// Streaming of packets longer than the FIFO (up to 65535 bytes, the packet length limit).
+// TX: the FIFO is preloaded with the beginning of the packet, and refilled every time it drains
+// down to almost empty threshold, until the whole packet is written. Refill is sized by the
+// FIFO count, so it's always a single burst filling the FIFO up.
+// RX: the FIFO is drained every time it fills up to almost full threshold, and the tail of the
+// packet is read after RX_DATA_READY. Every drain is a single burst sized by the FIFO count.
+// The engines are driven by interrupt flags read by the caller (nIRQ handler or polling loop),
+// so they can share them with other code. Unmask S2LP_STREAM_TX_INTERRUPTS or
+// S2LP_STREAM_RX_INTERRUPTS to get nIRQ for them.
+// Thresholds have to cover the time from crossing them to the end of the transfer (interrupt
+// latency and the transfer itself), at 500kbps every byte of the margin gives 16us. For RX,
+// the margin is the space left above the threshold.
+// Packets longer than 255 bytes need 2-byte length field, or fixed length mode.
+// Usage:
+//   S2LP_StreamTX stream;
+//   S2LP_Stream_StartTX(&stream, &handle, image, image_length, 48);
+//   while (S2LP_Stream_ProcessTX(&stream, S2LP_GetInterrupts(&handle)) == S2LP_STREAM_RUNNING) {
+//     ...
+//   }
+
+#include "s2lp.h"
+
+// Interrupts used by the TX engine
+#define S2LP_STREAM_TX_INTERRUPTS ((1ul << S2LP_INT_TX_DATA_SENT) | (1ul << S2LP_INT_TX_FIFO_ERROR) \
+		| (1ul << S2LP_INT_TX_FIFO_ALMOST_EMPTY))
+// Interrupts used by the RX engine
+#define S2LP_STREAM_RX_INTERRUPTS ((1ul << S2LP_INT_RX_DATA_READY) | (1ul << S2LP_INT_RX_FIFO_ERROR) \
+		| (1ul << S2LP_INT_RX_FIFO_ALMOST_FULL))
+
+typedef enum S2LP_StreamState_t {
+	S2LP_STREAM_IDLE, S2LP_STREAM_RUNNING, S2LP_STREAM_DONE, S2LP_STREAM_ERROR
+} S2LP_StreamState;
+
+typedef struct S2LP_StreamTX_Statistics_t {
+	// FIFO writes after the preload, and the bytes written by them
+	uint32_t refills;
+	uint32_t refill_bytes;
+	// The lowest FIFO level seen at refill - margin left from the threshold (FIFO size without refills)
+	uint8_t min_fifo_level;
+	uint32_t underflows;
+} S2LP_StreamTX_Statistics;
+
+typedef struct S2LP_StreamTX_t {
+	S2LP_Handle* handle;
+	uint8_t* data;
+	size_t length;
+	// Bytes already written to the FIFO
+	size_t position;
+	S2LP_StreamState state;
+	S2LP_StreamTX_Statistics statistics;
+} S2LP_StreamTX;
+
+typedef struct S2LP_StreamRX_Statistics_t {
+	// FIFO reads, including the tail, and the bytes read by them
+	uint32_t drains;
+	uint32_t drain_bytes;
+	// The highest FIFO level seen at drain - margin left is FIFO size minus it
+	uint8_t max_fifo_level;
+	// RX FIFO overflows - the packet is lost
+	uint32_t fifo_overflows;
+	// Bytes of the packet that didn't fit in the buffer
+	uint32_t dropped_bytes;
+} S2LP_StreamRX_Statistics;
+
+typedef struct S2LP_StreamRX_t {
+	S2LP_Handle* handle;
+	uint8_t* buffer;
+	size_t capacity;
+	// Bytes stored in the buffer
+	size_t length;
+	// Length of the received packet, known when it's done
+	size_t packet_length;
+	S2LP_StreamState state;
+	S2LP_StreamRX_Statistics statistics;
+} S2LP_StreamRX;
+
+// Set the packet length and FIFO threshold, preload the FIFO and start the transmission.
+// Radio has to be in READY state. Pending interrupt flags are cleared.
+// Data is not copied - keep it alive until the stream is done.
+// Returns false if the length is 0 or over 65535, or threshold doesn't fit in the FIFO.
+bool S2LP_Stream_StartTX(S2LP_StreamTX* stream, S2LP_Handle* handle, uint8_t* data, size_t length,
+		uint8_t threshold);
+
+// Handle the interrupt flags (S2LP_GetInterrupts result) - refill the FIFO, finish on data sent,
+// or abort the transmission on FIFO underflow. Returns the stream state.
+S2LP_StreamState S2LP_Stream_ProcessTX(S2LP_StreamTX* stream, uint32_t interrupts);
+
+// Set FIFO threshold, flush the FIFO and start the reception. Radio has to be in READY state.
+// Pending interrupt flags are cleared.
+// Returns false if capacity is 0, or threshold is 0 or doesn't fit in the FIFO.
+bool S2LP_Stream_StartRX(S2LP_StreamRX* stream, S2LP_Handle* handle, uint8_t* buffer, size_t capacity,
+		uint8_t threshold);
+
+// Handle the interrupt flags (S2LP_GetInterrupts result) - drain the FIFO, read the tail of the packet
+// on data ready, or abort the reception on FIFO overflow. Packet longer than the buffer is received
+// until the end, but the stream ends with error (see dropped_bytes). Returns the stream state.
+S2LP_StreamState S2LP_Stream_ProcessRX(S2LP_StreamRX* stream, uint32_t interrupts);
+
+#endif /* S2LP_S2LP_STREAM_H_ */
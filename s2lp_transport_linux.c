@@ -0,0 +1,254 @@
+/*
+ * s2lp_transport_linux.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifdef __linux__
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "s2lp_transport_linux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+#define S2LP_LINUX_CONSUMER "s2lp"
+
+static int S2LP_Linux_RequestLine(int gpiochip_fd, int line, bool output, bool initial_state) {
+	struct gpio_v2_line_request request;
+	memset(&request, 0, sizeof(request));
+
+	request.offsets[0] = (uint32_t) line;
+	request.num_lines = 1;
+	strncpy(request.consumer, S2LP_LINUX_CONSUMER, sizeof(request.consumer) - 1);
+
+	if (output) {
+		request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+		request.config.num_attrs = 1;
+		request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		request.config.attrs[0].attr.values = initial_state ? 1 : 0;
+		request.config.attrs[0].mask = 1;
+	} else {
+		request.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+	}
+
+	if (ioctl(gpiochip_fd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+		return -1;
+	}
+
+	return request.fd;
+}
+
+bool S2LP_Linux_Open(S2LP_Linux_Context* context, char const* spi_device, uint32_t speed_hz,
+		char const* gpiochip_device, int csn_line) {
+	for (size_t i = 0; i < sizeof(context->line_fd) / sizeof(context->line_fd[0]); i++) {
+		context->line_fd[i] = -1;
+	}
+
+	context->spi_speed_hz = speed_hz;
+	context->spi_fd = open(spi_device, O_RDWR | O_CLOEXEC);
+	context->gpiochip_fd = open(gpiochip_device, O_RDWR | O_CLOEXEC);
+
+	if (context->spi_fd < 0 || context->gpiochip_fd < 0) {
+		S2LP_Linux_Close(context);
+		return false;
+	}
+
+	// S2-LP works in SPI mode 0, MSB first. CS is driven by us, not by the SPI controller.
+	uint32_t mode = SPI_MODE_0 | SPI_NO_CS;
+	uint8_t bits = 8;
+	if (ioctl(context->spi_fd, SPI_IOC_WR_MODE32, &mode) < 0
+			|| ioctl(context->spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0
+			|| ioctl(context->spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz) < 0) {
+		S2LP_Linux_Close(context);
+		return false;
+	}
+
+	context->line_fd[S2LP_PIN_CSN] = S2LP_Linux_RequestLine(context->gpiochip_fd, csn_line, true, true);
+	if (context->line_fd[S2LP_PIN_CSN] < 0) {
+		S2LP_Linux_Close(context);
+		return false;
+	}
+
+	return true;
+}
+
+bool S2LP_Linux_RequestPin(S2LP_Linux_Context* context, S2LP_Pin pin, int line) {
+	if (pin == S2LP_PIN_CSN || line == S2LP_LINUX_PIN_NC) {
+		return false;
+	}
+
+	if (context->line_fd[pin] >= 0) {
+		close(context->line_fd[pin]);
+	}
+
+	context->line_fd[pin] = S2LP_Linux_RequestLine(context->gpiochip_fd, line, pin == S2LP_PIN_SDN, false);
+	return context->line_fd[pin] >= 0;
+}
+
+void S2LP_Linux_Close(S2LP_Linux_Context* context) {
+	for (size_t i = 0; i < sizeof(context->line_fd) / sizeof(context->line_fd[0]); i++) {
+		if (context->line_fd[i] >= 0) {
+			close(context->line_fd[i]);
+			context->line_fd[i] = -1;
+		}
+	}
+
+	if (context->gpiochip_fd >= 0) {
+		close(context->gpiochip_fd);
+		context->gpiochip_fd = -1;
+	}
+
+	if (context->spi_fd >= 0) {
+		close(context->spi_fd);
+		context->spi_fd = -1;
+	}
+}
+
+static void S2LP_Linux_Transfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_Linux_Context* const linux_ctx = (S2LP_Linux_Context*) context;
+	struct spi_ioc_transfer transfer;
+	memset(&transfer, 0, sizeof(transfer));
+
+	transfer.tx_buf = (uintptr_t) tx_data;
+	transfer.rx_buf = (uintptr_t) rx_data;
+	transfer.len = (uint32_t) length;
+	transfer.speed_hz = linux_ctx->spi_speed_hz;
+	transfer.bits_per_word = 8;
+
+	ioctl(linux_ctx->spi_fd, SPI_IOC_MESSAGE(1), &transfer);
+}
+
+static void S2LP_Linux_WritePin(void* context, S2LP_Pin pin, bool state) {
+	S2LP_Linux_Context* const linux_ctx = (S2LP_Linux_Context*) context;
+	if (linux_ctx->line_fd[pin] < 0) {
+		return;
+	}
+
+	struct gpio_v2_line_values values;
+	values.bits = state ? 1 : 0;
+	values.mask = 1;
+	ioctl(linux_ctx->line_fd[pin], GPIO_V2_LINE_SET_VALUES_IOCTL, &values);
+}
+
+static bool S2LP_Linux_ReadPin(void* context, S2LP_Pin pin) {
+	S2LP_Linux_Context* const linux_ctx = (S2LP_Linux_Context*) context;
+	if (linux_ctx->line_fd[pin] < 0) {
+		return false;
+	}
+
+	struct gpio_v2_line_values values;
+	values.bits = 0;
+	values.mask = 1;
+	if (ioctl(linux_ctx->line_fd[pin], GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+		return false;
+	}
+
+	return (values.bits & 1) != 0;
+}
+
+static void S2LP_Linux_Delay(void* context, uint32_t milliseconds) {
+	(void) context;
+	struct timespec duration;
+	duration.tv_sec = milliseconds / 1000u;
+	duration.tv_nsec = (long) (milliseconds % 1000u) * 1000000l;
+
+	while (nanosleep(&duration, &duration) != 0 && errno == EINTR) {
+	}
+}
+
+static uint32_t S2LP_Linux_GetTime(void* context) {
+	(void) context;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t) ((uint64_t) now.tv_sec * 1000000ull + (uint64_t) now.tv_nsec / 1000ull);
+}
+
+S2LP_Transport const S2LP_Linux_Transport = {
+	.transfer = S2LP_Linux_Transfer,
+	.write_pin = S2LP_Linux_WritePin,
+	.read_pin = S2LP_Linux_ReadPin,
+	.delay = S2LP_Linux_Delay,
+	.get_time_us = S2LP_Linux_GetTime,
+};
+
+// ===== Locks =====
+
+bool S2LP_Linux_InitMutex(S2LP_Linux_Mutex* mutex) {
+	pthread_mutexattr_t attributes;
+	if (pthread_mutexattr_init(&attributes) != 0) {
+		return false;
+	}
+
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+	int const result = pthread_mutex_init(&mutex->mutex, &attributes);
+	pthread_mutexattr_destroy(&attributes);
+	return result == 0;
+}
+
+void S2LP_Linux_DestroyMutex(S2LP_Linux_Mutex* mutex) {
+	pthread_mutex_destroy(&mutex->mutex);
+}
+
+static void S2LP_Linux_MutexAcquire(void* context) {
+	pthread_mutex_lock(&((S2LP_Linux_Mutex*) context)->mutex);
+}
+
+static void S2LP_Linux_MutexRelease(void* context) {
+	pthread_mutex_unlock(&((S2LP_Linux_Mutex*) context)->mutex);
+}
+
+S2LP_Lock const S2LP_Linux_MutexLock = {
+	.lock = S2LP_Linux_MutexAcquire,
+	.unlock = S2LP_Linux_MutexRelease,
+};
+
+// Unique per-thread address, used as spinlock owner ID
+static _Thread_local char S2LP_Linux_ThreadTag;
+
+void S2LP_Linux_InitSpinlock(S2LP_Linux_Spinlock* spinlock) {
+	atomic_init(&spinlock->owner, 0);
+	spinlock->depth = 0;
+}
+
+static void S2LP_Linux_SpinlockAcquire(void* context) {
+	S2LP_Linux_Spinlock* const spinlock = (S2LP_Linux_Spinlock*) context;
+	uintptr_t const self = (uintptr_t) &S2LP_Linux_ThreadTag;
+
+	// Only the owner can see it's own tag there, so relaxed load is enough
+	if (atomic_load_explicit(&spinlock->owner, memory_order_relaxed) == self) {
+		spinlock->depth++;
+		return;
+	}
+
+	uintptr_t expected = 0;
+	while (!atomic_compare_exchange_weak_explicit(&spinlock->owner, &expected, self, memory_order_acquire,
+			memory_order_relaxed)) {
+		expected = 0;
+	}
+
+	spinlock->depth = 1;
+}
+
+static void S2LP_Linux_SpinlockRelease(void* context) {
+	S2LP_Linux_Spinlock* const spinlock = (S2LP_Linux_Spinlock*) context;
+
+	if (--spinlock->depth == 0) {
+		atomic_store_explicit(&spinlock->owner, 0, memory_order_release);
+	}
+}
+
+S2LP_Lock const S2LP_Linux_SpinlockLock = {
+	.lock = S2LP_Linux_SpinlockAcquire,
+	.unlock = S2LP_Linux_SpinlockRelease,
+};
+
+#endif /* __linux__ */
@@ -0,0 +1,76 @@
+/*
+ * s2lp_transport_linux.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_TRANSPORT_LINUX_H_
+#define S2LP_S2LP_TRANSPORT_LINUX_H_
+
+// Linux host transport backend. SPI goes through spidev (/dev/spidevX.Y),
+// chip select and other pins go through GPIO character device (/dev/gpiochipN),
+// so the library can keep CS low for the whole transaction.
+// Usage:
+//   S2LP_Linux_Context ctx;
+//   S2LP_Linux_Open(&ctx, "/dev/spidev0.0", 5000000, "/dev/gpiochip0", 8);
+//   handle.transport = &S2LP_Linux_Transport;
+//   handle.transport_context = &ctx;
+
+#include "s2lp_mcu_interface.h"
+
+#ifdef __linux__
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Use this as line offset for the pins that are not connected
+#define S2LP_LINUX_PIN_NC (-1)
+
+typedef struct S2LP_Linux_Context_t {
+	int spi_fd;
+	uint32_t spi_speed_hz;
+
+	int gpiochip_fd;
+	// Line request file descriptors, indexed by S2LP_Pin. -1 if not connected.
+	int line_fd[S2LP_PIN_CSN + 1];
+} S2LP_Linux_Context;
+
+// Open SPI device and request chip select line (as output, deselected).
+// Returns false on failure, errno is left intact for diagnostics.
+bool S2LP_Linux_Open(S2LP_Linux_Context* context, char const* spi_device, uint32_t speed_hz,
+		char const* gpiochip_device, int csn_line);
+// Request additional pin - GPIOs are requested as inputs, SDN as output.
+bool S2LP_Linux_RequestPin(S2LP_Linux_Context* context, S2LP_Pin pin, int line);
+void S2LP_Linux_Close(S2LP_Linux_Context* context);
+
+extern S2LP_Transport const S2LP_Linux_Transport;
+
+// Locks for handles shared between threads, see S2LP_SetLock.
+// Mutex puts waiting threads to sleep, spinlock busy-waits - it's better
+// for short transactions on fast SPI, when threads run on separate cores.
+// Usage:
+//   S2LP_Linux_Mutex mutex;
+//   S2LP_Linux_InitMutex(&mutex);
+//   S2LP_SetLock(&handle, &S2LP_Linux_MutexLock, &mutex);
+typedef struct S2LP_Linux_Mutex_t {
+	pthread_mutex_t mutex;
+} S2LP_Linux_Mutex;
+
+typedef struct S2LP_Linux_Spinlock_t {
+	// Address of thread-local tag of the owning thread, 0 if free
+	atomic_uintptr_t owner;
+	// Recursion depth, modified only by the owner
+	unsigned depth;
+} S2LP_Linux_Spinlock;
+
+bool S2LP_Linux_InitMutex(S2LP_Linux_Mutex* mutex);
+void S2LP_Linux_DestroyMutex(S2LP_Linux_Mutex* mutex);
+void S2LP_Linux_InitSpinlock(S2LP_Linux_Spinlock* spinlock);
+
+extern S2LP_Lock const S2LP_Linux_MutexLock;
+extern S2LP_Lock const S2LP_Linux_SpinlockLock;
+
+#endif /* __linux__ */
+
+#endif /* S2LP_S2LP_TRANSPORT_LINUX_H_ */
@@ -0,0 +1,161 @@
+/*
+ * s2lp_transport_stm32.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#include "s2lp_transport_stm32.h"
+
+#ifdef USE_HAL_DRIVER
+
+#include "main.h"
+
+static void S2LP_STM32_GetPin(S2LP_STM32_Context* context, S2LP_Pin pin, GPIO_TypeDef** port_out,
+		uint16_t* pin_out) {
+	switch (pin) {
+		case S2LP_PIN_CSN:
+			*port_out = context->gpio_csn_port;
+			*pin_out = context->gpio_csn_pin;
+			break;
+#ifndef S2LP_SOFTWARE_RESET
+		case S2LP_PIN_SDN:
+			*port_out = context->gpio_sdn_port;
+			*pin_out = context->gpio_sdn_pin;
+			break;
+#endif
+		case S2LP_PIN_GPIO_0:
+			*port_out = context->gpio_port[0];
+			*pin_out = context->gpio_pin[0];
+			break;
+		case S2LP_PIN_GPIO_1:
+			*port_out = context->gpio_port[1];
+			*pin_out = context->gpio_pin[1];
+			break;
+		case S2LP_PIN_GPIO_2:
+			*port_out = context->gpio_port[2];
+			*pin_out = context->gpio_pin[2];
+			break;
+		case S2LP_PIN_GPIO_3:
+			*port_out = context->gpio_port[3];
+			*pin_out = context->gpio_pin[3];
+			break;
+		default:
+			break;
+	}
+}
+
+static void S2LP_STM32_Transfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_STM32_Context* const stm32 = (S2LP_STM32_Context*) context;
+
+	if (tx_data == NULL) {
+		HAL_SPI_Receive(stm32->spi, rx_data, (uint16_t) length, HAL_MAX_DELAY);
+	} else if (rx_data == NULL) {
+		HAL_SPI_Transmit(stm32->spi, (uint8_t*) tx_data, (uint16_t) length, HAL_MAX_DELAY);
+	} else {
+		HAL_SPI_TransmitReceive(stm32->spi, (uint8_t*) tx_data, rx_data, (uint16_t) length, HAL_MAX_DELAY);
+	}
+}
+
+static void S2LP_STM32_TransferStart(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	S2LP_STM32_Context* const stm32 = (S2LP_STM32_Context*) context;
+
+	if (tx_data == NULL) {
+		HAL_SPI_Receive_DMA(stm32->spi, rx_data, (uint16_t) length);
+	} else if (rx_data == NULL) {
+		HAL_SPI_Transmit_DMA(stm32->spi, (uint8_t*) tx_data, (uint16_t) length);
+	} else {
+		HAL_SPI_TransmitReceive_DMA(stm32->spi, (uint8_t*) tx_data, rx_data, (uint16_t) length);
+	}
+}
+
+static bool S2LP_STM32_TransferPoll(void* context) {
+	S2LP_STM32_Context* const stm32 = (S2LP_STM32_Context*) context;
+	return (HAL_SPI_GetState(stm32->spi) == HAL_SPI_STATE_READY);
+}
+
+static void S2LP_STM32_WritePin(void* context, S2LP_Pin pin, bool state) {
+	GPIO_TypeDef* gpio_port = NULL;
+	uint16_t gpio_pin = 0;
+
+	S2LP_STM32_GetPin((S2LP_STM32_Context*) context, pin, &gpio_port, &gpio_pin);
+
+	if (gpio_port != NULL) {
+		HAL_GPIO_WritePin(gpio_port, gpio_pin, state ? GPIO_PIN_SET : GPIO_PIN_RESET);
+	}
+}
+
+static bool S2LP_STM32_ReadPin(void* context, S2LP_Pin pin) {
+	GPIO_TypeDef* gpio_port = NULL;
+	uint16_t gpio_pin = 0;
+
+	S2LP_STM32_GetPin((S2LP_STM32_Context*) context, pin, &gpio_port, &gpio_pin);
+
+	if (gpio_port != NULL) {
+		return (HAL_GPIO_ReadPin(gpio_port, gpio_pin) == GPIO_PIN_SET);
+	}
+
+	return (false);
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+static void S2LP_STM32_Delay(void* context, uint32_t milliseconds) {
+	// Use HAL_Delay here if you're not using RTOS
+	osDelay(milliseconds);
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+static uint32_t S2LP_STM32_GetTime(void* context) {
+	// HAL tick has millisecond resolution, replace it with DWT/timer
+	// based implementation if you need better one.
+	return HAL_GetTick() * 1000u;
+}
+
+S2LP_Transport const S2LP_STM32_Transport = {
+	.transfer = S2LP_STM32_Transfer,
+	.write_pin = S2LP_STM32_WritePin,
+	.read_pin = S2LP_STM32_ReadPin,
+	.delay = S2LP_STM32_Delay,
+	.get_time_us = S2LP_STM32_GetTime,
+};
+
+S2LP_Transport const S2LP_STM32_DMATransport = {
+	.transfer = S2LP_STM32_Transfer,
+	.write_pin = S2LP_STM32_WritePin,
+	.read_pin = S2LP_STM32_ReadPin,
+	.delay = S2LP_STM32_Delay,
+	.get_time_us = S2LP_STM32_GetTime,
+	.transfer_start = S2LP_STM32_TransferStart,
+	.transfer_poll = S2LP_STM32_TransferPoll,
+};
+
+// ===== Lock =====
+
+bool S2LP_STM32_InitLock(S2LP_STM32_LockContext* context) {
+	osMutexAttr_t const attributes = {
+		.name = "s2lp",
+		.attr_bits = osMutexRecursive | osMutexPrioInherit,
+	};
+
+	context->mutex = osMutexNew(&attributes);
+	return (context->mutex != NULL);
+}
+
+static void S2LP_STM32_LockAcquire(void* context) {
+	osMutexAcquire(((S2LP_STM32_LockContext*) context)->mutex, osWaitForever);
+}
+
+static void S2LP_STM32_LockRelease(void* context) {
+	osMutexRelease(((S2LP_STM32_LockContext*) context)->mutex);
+}
+
+S2LP_Lock const S2LP_STM32_Lock = {
+	.lock = S2LP_STM32_LockAcquire,
+	.unlock = S2LP_STM32_LockRelease,
+};
+
+#endif /* USE_HAL_DRIVER */
@@ -0,0 +1,67 @@
+/*
+ * s2lp_transport_stm32.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_S2LP_TRANSPORT_STM32_H_
+#define S2LP_S2LP_TRANSPORT_STM32_H_
+
+// STM32 HAL transport backend. Compiled only in HAL-based projects (USE_HAL_DRIVER).
+// Usage:
+//   S2LP_STM32_Context ctx = { .spi = &hspi1, .gpio_csn_port = ..., ... };
+//   handle.transport = &S2LP_STM32_Transport;
+//   handle.transport_context = &ctx;
+//   S2LP_Initialize(&handle, S2LP_CLOCK_FREQ_50MHZ);
+
+#include "s2lp_mcu_interface.h"
+
+#ifdef USE_HAL_DRIVER
+
+#include <stm32l4xx.h>
+#include "cmsis_os.h"
+
+typedef struct S2LP_STM32_Context_t {
+	// SPI for communication
+	SPI_HandleTypeDef* spi;
+
+	// Chip select pin
+	GPIO_TypeDef* gpio_csn_port;
+	uint16_t gpio_csn_pin;
+
+	// Shutdown pin
+#ifndef S2LP_SOFTWARE_RESET
+	GPIO_TypeDef* gpio_sdn_port;
+	uint16_t gpio_sdn_pin;
+#endif
+
+	// GPIO
+	GPIO_TypeDef* gpio_port[4];
+	uint16_t gpio_pin[4];
+} S2LP_STM32_Context;
+
+// Blocking transport
+extern S2LP_Transport const S2LP_STM32_Transport;
+// DMA transport - SPI transfers of asynchronous transactions are done with
+// HAL_SPI_TransmitReceive_DMA, and their completion is polled with HAL_SPI_GetState.
+// SPI DMA channels and their interrupts have to be configured in the project.
+extern S2LP_Transport const S2LP_STM32_DMATransport;
+
+// Lock based on recursive RTOS mutex (with priority inheritance), see S2LP_SetLock.
+// Usage:
+//   static S2LP_STM32_LockContext lock_ctx;
+//   S2LP_STM32_InitLock(&lock_ctx);
+//   S2LP_SetLock(&handle, &S2LP_STM32_Lock, &lock_ctx);
+typedef struct S2LP_STM32_LockContext_t {
+	osMutexId_t mutex;
+} S2LP_STM32_LockContext;
+
+// Returns false if mutex could not be created
+bool S2LP_STM32_InitLock(S2LP_STM32_LockContext* context);
+
+extern S2LP_Lock const S2LP_STM32_Lock;
+
+#endif /* USE_HAL_DRIVER */
+
+#endif /* S2LP_S2LP_TRANSPORT_STM32_H_ */
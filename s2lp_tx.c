@@ -9,6 +9,8 @@
 #include "s2lp_tx.h"
 
 void S2LP_TX_SetStaticPowerLevel(S2LP_Handle* handle, uint8_t power_level) {
+    // PA_POWER8..PA_POWER0 are contiguous, so this goes out as a single burst
+    S2LP_BeginWriteBatch(handle);
     S2LP_WriteRegister(handle, S2LP_REG_PA_POWER8, power_level);
     S2LP_WriteRegister(handle, S2LP_REG_PA_POWER7, power_level);
     S2LP_WriteRegister(handle, S2LP_REG_PA_POWER6, power_level);
@@ -19,6 +21,7 @@ void S2LP_TX_SetStaticPowerLevel(S2LP_Handle* handle, uint8_t power_level) {
     S2LP_WriteRegister(handle, S2LP_REG_PA_POWER1, power_level);
     S2LP_TX_SetPowerRampStepMax(handle, 7);
     S2LP_TX_SetRampingState(handle, false);
+    S2LP_CommitWriteBatch(handle);
 }
 
 void S2LP_TX_SetPowerRampSteps(S2LP_Handle* handle, uint8_t steps[8]) {
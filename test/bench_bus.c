@@ -0,0 +1,171 @@
+/*
+ * bench_bus.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Aggregate RX throughput of 1, 2, 4 and 8 emulated radios sharing one SPI bus (S2LP_Emulator_Bus behind
+// S2LP_Bus, with DMA-like transfers). Every radio receives back-to-back packets. The gateway loop polls
+// nIRQ of every radio and queues everything asynchronously - interrupt status and RX FIFO reads with high
+// priority, RX restart command, and a low priority configuration write after every packet - so the arbiter
+// has to order the traffic of all radios.
+// Received data, bus statistics and the shared timeline are verified.
+
+#include "test_utils.h"
+#include "s2lp_bus.h"
+#include "s2lp_gpio.h"
+#include "s2lp_packet.h"
+#include "s2lp_rf.h"
+
+#include <string.h>
+
+#define BENCH_BUS_PACKET_LENGTH 32
+#define BENCH_BUS_PACKETS_PER_RADIO 200
+#define BENCH_BUS_SPI_CLOCK_HZ 8000000
+#define BENCH_BUS_DATARATE 250000
+
+typedef struct BenchRadio_t {
+	S2LP_Emulator emulator;
+	S2LP_Handle handle;
+	S2LP_BusDevice device;
+
+	S2LP_Transaction irq_read;
+	S2LP_Transaction fifo_read;
+	S2LP_Transaction rx_command;
+	S2LP_Transaction config_write;
+	uint8_t irq_status[4];
+	uint8_t config_value;
+	uint8_t buffer[BENCH_BUS_PACKET_LENGTH];
+
+	volatile bool draining;
+	volatile bool drained;
+	size_t received;
+	size_t corrupted;
+} BenchRadio;
+
+static BenchRadio radios[S2LP_EMULATOR_BUS_MAX_CHIPS];
+static uint8_t const* packet_data;
+
+static void OnFIFORead(S2LP_Handle* handle, S2LP_Transaction* transaction) {
+	(void) handle;
+	BenchRadio* const radio = (BenchRadio*) transaction->user_data;
+	radio->draining = false;
+	radio->drained = true;
+}
+
+// Queue the next packet and restart RX, without waiting for the bus
+static void StartReception(BenchRadio* radio) {
+	S2LP_Emulator_InjectPacket(&radio->emulator, packet_data, BENCH_BUS_PACKET_LENGTH);
+	S2LP_InitTransaction(&radio->rx_command, S2LP_TRANSACTION_COMMAND, S2LP_CMD_RX, NULL, 0, NULL, NULL);
+	S2LP_SubmitTransaction(&radio->handle, &radio->rx_command);
+}
+
+static void Run(size_t radio_count) {
+	S2LP_Emulator_Bus emulator_bus;
+	S2LP_Bus bus;
+	S2LP_Emulator_InitBus(&emulator_bus);
+	S2LP_Bus_Init(&bus, &S2LP_Emulator_BusTransport, &emulator_bus);
+
+	for (size_t i = 0; i < radio_count; i++) {
+		BenchRadio* const radio = &radios[i];
+		memset(radio, 0, sizeof(BenchRadio));
+		S2LP_Emulator_Init(&radio->emulator, S2LP_CLOCK_FREQ_50MHZ, BENCH_BUS_SPI_CLOCK_HZ);
+		S2LP_Emulator_AttachToBus(&emulator_bus, &radio->emulator);
+		S2LP_Bus_Attach(&bus, &radio->device, &radio->handle, &S2LP_Emulator_Transport, &radio->emulator);
+		S2LP_Initialize(&radio->handle, S2LP_CLOCK_FREQ_50MHZ);
+
+		S2LP_RF_SetDataRate(&radio->handle, BENCH_BUS_DATARATE);
+		S2LP_PCKT_SetPacketLength(&radio->handle, BENCH_BUS_PACKET_LENGTH);
+		S2LP_GPIO_SetPinOutput(&radio->handle, S2LP_PIN_GPIO_0, S2LP_GPIO_OUT_NIRQ);
+		S2LP_SetInterruptMasks(&radio->handle, 1u << S2LP_INT_RX_DATA_READY);
+		StartReception(radio);
+	}
+
+	S2LP_Bus_ResetStatistics(&bus);
+	for (size_t i = 0; i < radio_count; i++) {
+		S2LP_Emulator_ResetStatistics(&radios[i].emulator);
+	}
+	uint64_t const start = radios[0].emulator.time_ns;
+	size_t const target = radio_count * BENCH_BUS_PACKETS_PER_RADIO;
+	size_t total = 0;
+
+	while (total < target) {
+		for (size_t i = 0; i < radio_count; i++) {
+			BenchRadio* const radio = &radios[i];
+
+			// nIRQ is active low. Interrupt flags are read (and cleared) together with the FIFO drain,
+			// both with high priority.
+			if (!radio->draining && !radio->drained && !S2LP_ReadPin(&radio->handle, S2LP_PIN_GPIO_0)) {
+				radio->draining = true;
+				S2LP_InitTransaction(&radio->irq_read, S2LP_TRANSACTION_READ, S2LP_REG_IRQ_STATUS3,
+						radio->irq_status, sizeof(radio->irq_status), NULL, NULL);
+				radio->irq_read.priority = S2LP_PRIORITY_HIGH;
+				S2LP_SubmitTransaction(&radio->handle, &radio->irq_read);
+				S2LP_ReadFIFOAsync(&radio->handle, &radio->fifo_read, BENCH_BUS_PACKET_LENGTH, radio->buffer,
+						OnFIFORead, radio);
+			}
+
+			if (radio->drained) {
+				radio->drained = false;
+				radio->received++;
+				total++;
+				if (memcmp(radio->buffer, packet_data, BENCH_BUS_PACKET_LENGTH) != 0) {
+					radio->corrupted++;
+				}
+				StartReception(radio);
+
+				// Configuration traffic waits in the queue, while the other radios drain their FIFOs
+				if (radio->received == 1 || radio->config_write.done) {
+					radio->config_value++;
+					S2LP_InitTransaction(&radio->config_write, S2LP_TRANSACTION_WRITE, S2LP_REG_RSSI_TH,
+							&radio->config_value, 1, NULL, NULL);
+					S2LP_SubmitTransaction(&radio->handle, &radio->config_write);
+				}
+			}
+		}
+
+		// Idle bus - let the radios receive
+		if (S2LP_Bus_Poll(&bus)) {
+			S2LP_Emulator_AdvanceTime(&radios[0].emulator, 1000);
+		}
+	}
+	S2LP_Bus_WaitAllTransactions(&bus);
+
+	uint64_t const elapsed = radios[0].emulator.time_ns - start;
+	uint64_t bus_time = 0;
+	for (size_t i = 0; i < radio_count; i++) {
+		bus_time += radios[i].emulator.statistics.bus_time_ns;
+	}
+	printf("%zu radios: %5zu packets in %7.2f ms, %6.0f packets/s, %4.1f%% bus time, "
+			"%u transactions, %u preemptions, %u deferrals\n", radio_count, total, elapsed / 1e6,
+			total / (elapsed / 1e9), 100.0 * bus_time / elapsed, bus.statistics.transactions,
+			bus.statistics.preemptions, bus.statistics.deferrals);
+
+	for (size_t i = 0; i < radio_count; i++) {
+		BenchRadio* const radio = &radios[i];
+		TEST_CHECK(radio->corrupted == 0);
+		TEST_CHECK(radio->received >= BENCH_BUS_PACKETS_PER_RADIO - 1);
+		TEST_CHECK(radio->emulator.time_ns == radios[0].emulator.time_ns);
+		TEST_CHECK(radio->device.statistics.transactions > 0);
+		TEST_CHECK(S2LP_ReadRegister(&radio->handle, S2LP_REG_RSSI_TH) == radio->config_value);
+	}
+	if (radio_count > 1) {
+		TEST_CHECK(bus.statistics.preemptions > 0);
+		TEST_CHECK(bus.statistics.deferrals > 0);
+	}
+}
+
+int main(void) {
+	static uint8_t packet[BENCH_BUS_PACKET_LENGTH];
+	for (size_t i = 0; i < BENCH_BUS_PACKET_LENGTH; i++) {
+		packet[i] = (uint8_t) (i * 7 + 1);
+	}
+	packet_data = packet;
+
+	for (size_t radio_count = 1; radio_count <= S2LP_EMULATOR_BUS_MAX_CHIPS; radio_count *= 2) {
+		Run(radio_count);
+	}
+
+	return TEST_RESULT();
+}
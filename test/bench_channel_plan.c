@@ -0,0 +1,102 @@
+/*
+ * bench_channel_plan.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Channel switching latency - channel plan against S2LP_RF_SetBaseFrequency and S2LP_RF_SetChannelNumber,
+// with register cache enabled and disabled. SPI frames, bytes and time per switch are measured on the
+// emulator (8MHz SPI), CPU time on the host. Plans are checked for single-write switching, and the
+// carrier frequency set in the chip has to match the real center frequency reported by the plan.
+
+#include "test_utils.h"
+#include "s2lp_channel_plan.h"
+#include "s2lp_rf.h"
+
+#include <stdlib.h>
+
+#define BENCH_CHANNEL_PLAN_SWITCHES 1000
+#define BENCH_CHANNEL_PLAN_CHANNELS 10
+#define BENCH_CHANNEL_PLAN_BASE_FREQUENCY 868000000u
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+static S2LP_ChannelPlan plan;
+
+typedef void (*SwitchFunction)(size_t index);
+
+static void SwitchBaseFrequency(size_t index) {
+	S2LP_RF_SetBaseFrequency(&handle, BENCH_CHANNEL_PLAN_BASE_FREQUENCY + (index % 10) * 100000u);
+}
+
+static void SwitchChannelNumber(size_t index) {
+	S2LP_RF_SetChannelNumber(&handle, (uint8_t) (index % 10));
+}
+
+static void SwitchPlanChannel(size_t index) {
+	S2LP_ChannelPlan_SelectChannel(&handle, &plan, index % plan.channel_count);
+}
+
+// Returns SPI frames per switch
+static double Measure(char const* name, bool cache, SwitchFunction function) {
+	S2LP_SetRegisterCacheState(&handle, cache);
+	S2LP_Emulator_ResetStatistics(&emulator);
+	uint64_t const start_ns = emulator.time_ns;
+	uint64_t const start = Test_Now();
+
+	for (size_t i = 0; i < BENCH_CHANNEL_PLAN_SWITCHES; i++) {
+		function(i);
+	}
+
+	// Host time includes the emulator, so it's only an upper bound of CPU time
+	double const host_time = (double) (Test_Now() - start) / BENCH_CHANNEL_PLAN_SWITCHES;
+	double const frames = (double) emulator.statistics.transactions / BENCH_CHANNEL_PLAN_SWITCHES;
+	printf("  %-24s cache %-3s: %5.2f frames, %5.2f bytes, %6.2f us SPI, %6.1f ns host per switch\n", name,
+			cache ? "on" : "off", frames, (double) emulator.statistics.spi_bytes / BENCH_CHANNEL_PLAN_SWITCHES,
+			(double) (emulator.time_ns - start_ns) / BENCH_CHANNEL_PLAN_SWITCHES / 1000.0, host_time);
+	return frames;
+}
+
+static void RunPlan(uint32_t spacing) {
+	S2LP_SetRegisterCacheState(&handle, true);
+	TEST_CHECK(S2LP_ChannelPlan_Build(&handle, &plan, BENCH_CHANNEL_PLAN_BASE_FREQUENCY, spacing,
+			BENCH_CHANNEL_PLAN_CHANNELS));
+	printf("plan with %u Hz spacing (%s):\n", spacing,
+			plan.channel_spacing != 0 ? "switched by CHNUM" : "switched by synthesizer word");
+
+	TEST_CHECK(S2LP_ChannelPlan_Apply(&handle, &plan, 0));
+	for (size_t channel = 0; channel < plan.channel_count; channel++) {
+		TEST_CHECK(S2LP_ChannelPlan_SelectChannel(&handle, &plan, channel));
+		uint32_t const frequency = S2LP_ChannelPlan_GetFrequency(&plan, channel);
+		uint32_t const carrier = S2LP_Emulator_GetCarrierFrequency(&emulator);
+		int64_t const target = BENCH_CHANNEL_PLAN_BASE_FREQUENCY + (int64_t) channel * spacing;
+		TEST_CHECK(llabs((int64_t) carrier - (int64_t) frequency) <= 1);
+		// Synthesizer resolution is below 50Hz
+		TEST_CHECK(llabs((int64_t) frequency - target) < 50);
+	}
+
+	for (int cache = 1; cache >= 0; cache--) {
+		TEST_CHECK(Measure("ChannelPlan_SelectChannel", cache, SwitchPlanChannel) == 1.0);
+	}
+}
+
+int main(void) {
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 8000000);
+
+	// Spacing which isn't a multiple of CHSPACE resolution (~1526Hz at 50MHz), and one which is
+	RunPlan(100000);
+	RunPlan(12207);
+
+	printf("without channel plan:\n");
+	for (int cache = 1; cache >= 0; cache--) {
+		TEST_CHECK(Measure("RF_SetBaseFrequency", cache, SwitchBaseFrequency) >= 1.0);
+	}
+	S2LP_RF_SetBaseFrequency(&handle, BENCH_CHANNEL_PLAN_BASE_FREQUENCY);
+	S2LP_RF_SetChannelSpacing(&handle, plan.channel_spacing);
+	for (int cache = 1; cache >= 0; cache--) {
+		TEST_CHECK(Measure("RF_SetChannelNumber", cache, SwitchChannelNumber) >= 1.0);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+/*
+ * bench_codec.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Throughput of software data coding and whitening (s2lp_codec.h) over a 4000-byte buffer,
+// best of 5 runs. Whitening and FEC encoding are compared with the bitwise references
+// (codec_reference.h). Every coding is decoded back, and has to give the input.
+
+#include "test_utils.h"
+#include "codec_reference.h"
+#include "s2lp_codec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_CODEC_LENGTH 4000
+#define BENCH_CODEC_RUNS 5
+
+static uint8_t input[BENCH_CODEC_LENGTH];
+static uint8_t encoded[S2LP_CODEC_FEC_ENCODED_LENGTH(BENCH_CODEC_LENGTH)];
+static uint8_t output[S2LP_CODEC_FEC_ENCODED_LENGTH(BENCH_CODEC_LENGTH)];
+static size_t encoded_length;
+static volatile uint32_t sink;
+
+typedef void (*CodecFunction)(void);
+
+static void Whiten(void) {
+	S2LP_Codec_Whiten(output, BENCH_CODEC_LENGTH, 0);
+}
+
+static void ReferenceWhiten(void) {
+	Reference_Whiten(output, BENCH_CODEC_LENGTH);
+}
+
+static void FECEncode(void) {
+	sink += (uint32_t) S2LP_Codec_FECEncode(input, BENCH_CODEC_LENGTH, output);
+}
+
+static void ReferenceFECEncode(void) {
+	sink += (uint32_t) Reference_FECEncode(input, BENCH_CODEC_LENGTH, output);
+}
+
+static void FECDecode(void) {
+	sink += (uint32_t) S2LP_Codec_FECDecode(encoded, encoded_length, output);
+}
+
+static void ManchesterEncode(void) {
+	sink += (uint32_t) S2LP_Codec_ManchesterEncode(input, BENCH_CODEC_LENGTH, output);
+}
+
+static void ManchesterDecode(void) {
+	sink += S2LP_Codec_ManchesterDecode(encoded, encoded_length, output);
+}
+
+static void Encode3of6(void) {
+	sink += (uint32_t) S2LP_Codec_3of6Encode(input, BENCH_CODEC_LENGTH, output);
+}
+
+static void Decode3of6(void) {
+	sink += S2LP_Codec_3of6Decode(encoded, encoded_length, output);
+}
+
+// Returns MB/s of input (uncoded) data
+static double Measure(CodecFunction function, int repetitions) {
+	double best = 0;
+	for (int run = 0; run < BENCH_CODEC_RUNS; run++) {
+		uint64_t const start = Test_Now();
+		for (int i = 0; i < repetitions; i++) {
+			function();
+		}
+		double const time = (double) (Test_Now() - start) / repetitions;
+		if (run == 0 || time < best) {
+			best = time;
+		}
+	}
+	return BENCH_CODEC_LENGTH / best * 1e3;
+}
+
+static void Report(char const* name, double speed, double reference_speed) {
+	printf("%-22s %7.1f MB/s", name, speed);
+	if (reference_speed > 0) {
+		printf(", bitwise %5.1f MB/s (x%.1f)", reference_speed, speed / reference_speed);
+		TEST_CHECK(speed > reference_speed);
+	}
+	printf("\n");
+}
+
+int main(void) {
+	srand(7);
+	for (size_t i = 0; i < sizeof(input); i++) {
+		input[i] = (uint8_t) rand();
+	}
+
+	Report("whitening", Measure(Whiten, 2000), Measure(ReferenceWhiten, 100));
+	memcpy(output, input, BENCH_CODEC_LENGTH);
+	Whiten();
+	Whiten();
+	TEST_CHECK(memcmp(output, input, BENCH_CODEC_LENGTH) == 0);
+
+	Report("FEC encode", Measure(FECEncode, 500), Measure(ReferenceFECEncode, 50));
+	encoded_length = S2LP_Codec_FECEncode(input, BENCH_CODEC_LENGTH, encoded);
+	Report("FEC decode (Viterbi)", Measure(FECDecode, 20), 0);
+	TEST_CHECK(memcmp(output, input, BENCH_CODEC_LENGTH) == 0);
+
+	Report("Manchester encode", Measure(ManchesterEncode, 2000), 0);
+	encoded_length = S2LP_Codec_ManchesterEncode(input, BENCH_CODEC_LENGTH, encoded);
+	Report("Manchester decode", Measure(ManchesterDecode, 2000), 0);
+	TEST_CHECK(memcmp(output, input, BENCH_CODEC_LENGTH) == 0);
+
+	Report("3-of-6 encode", Measure(Encode3of6, 2000), 0);
+	encoded_length = S2LP_Codec_3of6Encode(input, BENCH_CODEC_LENGTH, encoded);
+	Report("3-of-6 decode", Measure(Decode3of6, 2000), 0);
+	TEST_CHECK(memcmp(output, input, BENCH_CODEC_LENGTH) == 0);
+
+	return TEST_RESULT();
+}
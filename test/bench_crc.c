@@ -0,0 +1,142 @@
+/*
+ * bench_crc.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Throughput of the software CRC engine against a bitwise reference (the definition - MSB first,
+// all-ones initial value, no final XOR), for every polynomial: MB/s over a 64kB buffer (best of 5 runs)
+// and time per 20-byte frame. Table size depends on S2LP_CRC_SLICE_BY_1 (see s2lp_crc.h),
+// bench_crc_slice1 is built with it.
+// Results have to be equal to the reference for random buffers and alignments, also when computed
+// in two parts with S2LP_CRC_Update. Write/Check round trip has to pass, and single bit errors
+// have to be detected.
+
+#include "test_utils.h"
+#include "s2lp_crc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_CRC_BUFFER_SIZE 65536
+#define BENCH_CRC_RANDOM_BUFFERS 2000
+#define BENCH_CRC_RUNS 5
+#define BENCH_CRC_FRAMES 200000
+
+static uint8_t buffer[BENCH_CRC_BUFFER_SIZE];
+static volatile uint32_t sink;
+
+static uint32_t const polynomials[] = { 0, 0x07, 0x8005, 0x1021, 0x864CFB, 0x4C011BB7 };
+static char const* const names[] = { "none", "0x07", "0x8005", "0x1021", "0x864CFB", "0x04C011BB7" };
+
+static uint32_t ReferenceCRC(S2LP_CRC_Mode mode, uint8_t const* data, size_t length) {
+	uint32_t const width = 8u * S2LP_CRC_GetLength(mode);
+	uint32_t const top = 1ul << (width - 1);
+	uint32_t const mask = width == 32 ? 0xFFFFFFFFu : (1ul << width) - 1;
+	uint32_t crc = mask;
+
+	for (size_t i = 0; i < length; i++) {
+		crc ^= (uint32_t) data[i] << (width - 8);
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & top) != 0 ? ((crc << 1) ^ polynomials[mode]) & mask : (crc << 1) & mask;
+		}
+	}
+	return crc;
+}
+
+static void CheckEquality(S2LP_CRC_Mode mode) {
+	uint32_t mismatches = 0;
+	uint32_t undetected = 0;
+
+	for (int i = 0; i < BENCH_CRC_RANDOM_BUFFERS; i++) {
+		size_t const offset = (size_t) rand() % 64;
+		size_t const length = (size_t) rand() % 300;
+		uint8_t const* data = buffer + offset;
+		uint32_t const crc = S2LP_CRC_Compute(mode, data, length);
+
+		size_t const split = length > 0 ? (size_t) rand() % length : 0;
+		uint32_t const split_crc = S2LP_CRC_Update(mode,
+				S2LP_CRC_Update(mode, S2LP_CRC_GetInitialValue(mode), data, split), data + split, length - split);
+		if (crc != ReferenceCRC(mode, data, length) || crc != split_crc) {
+			mismatches++;
+		}
+
+		uint8_t frame[300 + S2LP_CRC_MAX_LENGTH];
+		memcpy(frame, data, length);
+		size_t const frame_length = length + S2LP_CRC_Write(mode, crc, frame + length);
+		if (!S2LP_CRC_Check(mode, frame, frame_length)) {
+			mismatches++;
+		}
+		frame[(size_t) rand() % frame_length] ^= (uint8_t) (1u << (rand() % 8));
+		if (S2LP_CRC_Check(mode, frame, frame_length)) {
+			undetected++;
+		}
+	}
+
+	TEST_CHECK(mismatches == 0);
+	TEST_CHECK(undetected == 0);
+}
+
+static void Measure(S2LP_CRC_Mode mode) {
+	double table_time = 0;
+	double reference_time = 0;
+	for (int run = 0; run < BENCH_CRC_RUNS; run++) {
+		uint64_t start = Test_Now();
+		for (int i = 0; i < 64; i++) {
+			sink ^= S2LP_CRC_Compute(mode, buffer, sizeof(buffer));
+		}
+		double const table = (double) (Test_Now() - start) / 64;
+
+		start = Test_Now();
+		for (int i = 0; i < 4; i++) {
+			sink ^= ReferenceCRC(mode, buffer, sizeof(buffer));
+		}
+		double const reference = (double) (Test_Now() - start) / 4;
+
+		if (run == 0 || table < table_time) {
+			table_time = table;
+		}
+		if (run == 0 || reference < reference_time) {
+			reference_time = reference;
+		}
+	}
+	TEST_CHECK(S2LP_CRC_Compute(mode, buffer, sizeof(buffer)) == ReferenceCRC(mode, buffer, sizeof(buffer)));
+
+	uint64_t const start = Test_Now();
+	for (int i = 0; i < BENCH_CRC_FRAMES; i++) {
+		sink ^= S2LP_CRC_Compute(mode, buffer + (i & 63), 20);
+	}
+	double const frame_time = (double) (Test_Now() - start) / BENCH_CRC_FRAMES;
+
+	double const table_speed = sizeof(buffer) / table_time * 1e3;
+	double const reference_speed = sizeof(buffer) / reference_time * 1e3;
+	printf("%-12s tables %7.1f MB/s, bitwise %5.1f MB/s (x%4.1f), 20 B frame %5.1f ns\n", names[mode], table_speed,
+			reference_speed, table_speed / reference_speed, frame_time);
+	TEST_CHECK(table_speed > reference_speed);
+}
+
+int main(void) {
+#ifdef S2LP_CRC_SLICE_BY_4
+	printf("slice-by-4 tables:\n");
+#else
+	printf("single tables:\n");
+#endif
+
+	srand(1);
+	for (size_t i = 0; i < sizeof(buffer); i++) {
+		buffer[i] = (uint8_t) rand();
+	}
+
+	TEST_CHECK(S2LP_CRC_GetLength(S2LP_CRC_NO_CRC) == 0);
+	// Catalogue check values (CRC-16/CMS and CRC-16/IBM-3740)
+	TEST_CHECK(S2LP_CRC_Compute(S2LP_CRC_POLY_8005, (uint8_t const*) "123456789", 9) == 0xAEE7);
+	TEST_CHECK(S2LP_CRC_Compute(S2LP_CRC_POLY_1021, (uint8_t const*) "123456789", 9) == 0x29B1);
+
+	for (int mode = S2LP_CRC_POLY_07; mode <= S2LP_CRC_POLY_04C011BB7; mode++) {
+		CheckEquality((S2LP_CRC_Mode) mode);
+		Measure((S2LP_CRC_Mode) mode);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,108 @@
+/*
+ * bench_lock.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Stress benchmark of the handle lock - several threads hammer a single handle (with register cache
+// disabled, so every access is an SPI transaction on the emulator). Every thread writes and reads back
+// it's own register, reads the device info and increments a shared register with read-modify-write
+// inside a write batch. Lost updates, torn transfers or unexpected transaction counts fail the benchmark.
+
+#include "test_utils.h"
+#include "s2lp_registers.h"
+#include "s2lp_transport_linux.h"
+
+#include <pthread.h>
+
+#define BENCH_LOCK_MAX_THREADS 4
+#define BENCH_LOCK_ITERATIONS 20000
+// Write, read back, device info read, and read + write of the shared register
+#define BENCH_LOCK_TRANSACTIONS_PER_ITERATION 5
+
+static S2LP_Handle handle;
+static S2LP_Emulator emulator;
+
+static S2LP_Register const thread_registers[BENCH_LOCK_MAX_THREADS] = { S2LP_REG_CHNUM, S2LP_REG_CHSPACE,
+		S2LP_REG_PCKT_FLT_GOALS0, S2LP_REG_PCKT_FLT_GOALS3 };
+static S2LP_Register const shared_register = S2LP_REG_PCKT_FLT_GOALS1;
+
+static void* Worker(void* argument) {
+	size_t const id = (size_t) argument;
+	size_t errors = 0;
+
+	for (size_t i = 0; i < BENCH_LOCK_ITERATIONS; i++) {
+		uint8_t const value = (uint8_t) (i * 7 + id);
+		S2LP_WriteRegister(&handle, thread_registers[id], value);
+		if (S2LP_ReadRegister(&handle, thread_registers[id]) != value) {
+			errors++;
+		}
+
+		uint8_t device_info[2] = { 0 };
+		S2LP_BatchReadRegisters(&handle, S2LP_REG_DEVICE_INFO1, device_info, 2);
+		if (device_info[0] != S2LP_Registers_GetDefaultValue(S2LP_REG_DEVICE_INFO1)) {
+			errors++;
+		}
+
+		S2LP_BeginWriteBatch(&handle);
+		uint8_t const counter = S2LP_ReadRegister(&handle, shared_register);
+		S2LP_WriteRegister(&handle, shared_register, (uint8_t) (counter + 1));
+		S2LP_CommitWriteBatch(&handle);
+	}
+
+	return (void*) errors;
+}
+
+static void Run(char const* name, S2LP_Lock const* lock, void* lock_context, size_t threads) {
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 10000000);
+	S2LP_SetRegisterCacheState(&handle, false);
+	S2LP_SetLock(&handle, lock, lock_context);
+	S2LP_WriteRegister(&handle, shared_register, 0);
+	S2LP_Emulator_ResetStatistics(&emulator);
+
+	pthread_t workers[BENCH_LOCK_MAX_THREADS];
+	uint64_t const start = Test_Now();
+	for (size_t i = 0; i < threads; i++) {
+		pthread_create(&workers[i], NULL, Worker, (void*) i);
+	}
+
+	size_t errors = 0;
+	for (size_t i = 0; i < threads; i++) {
+		void* result = NULL;
+		pthread_join(workers[i], &result);
+		errors += (size_t) result;
+	}
+	uint64_t const elapsed = Test_Now() - start;
+	uint32_t const transactions = emulator.statistics.transactions;
+
+	uint32_t const expected_transactions = (uint32_t) (threads * BENCH_LOCK_ITERATIONS
+			* BENCH_LOCK_TRANSACTIONS_PER_ITERATION);
+	uint8_t const counter = S2LP_ReadRegister(&handle, shared_register);
+
+	printf("%-9s %zu threads: %8.0f transactions/s, %zu errors, %u transactions (expected %u), counter %u (expected %u)\n",
+			name, threads, transactions / (elapsed / 1e9), errors, transactions, expected_transactions, counter,
+			(uint8_t) (threads * BENCH_LOCK_ITERATIONS));
+
+	TEST_CHECK(errors == 0);
+	TEST_CHECK(transactions == expected_transactions);
+	TEST_CHECK(counter == (uint8_t) (threads * BENCH_LOCK_ITERATIONS));
+}
+
+int main(void) {
+	S2LP_Linux_Mutex mutex;
+	S2LP_Linux_Spinlock spinlock;
+	S2LP_Linux_InitMutex(&mutex);
+	S2LP_Linux_InitSpinlock(&spinlock);
+
+	Run("no lock", NULL, NULL, 1);
+	for (size_t threads = 1; threads <= BENCH_LOCK_MAX_THREADS; threads *= 2) {
+		Run("mutex", &S2LP_Linux_MutexLock, &mutex, threads);
+	}
+	for (size_t threads = 1; threads <= BENCH_LOCK_MAX_THREADS; threads *= 2) {
+		Run("spinlock", &S2LP_Linux_SpinlockLock, &spinlock, threads);
+	}
+
+	S2LP_Linux_DestroyMutex(&mutex);
+	return TEST_RESULT();
+}
@@ -0,0 +1,220 @@
+/*
+ * bench_packet.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// SPI transactions, bytes and time per packet of S2LP_SendPacket/S2LP_ReceivePacket against the
+// hand-written sequence (FIFO flush, length write, FIFO access, command, polling with zero-write),
+// on the emulator with 10MHz SPI and 250kbps. Done with interrupt flag polling, with nIRQ on GPIO0,
+// and with the non-blocking API driven from nIRQ. Polling cost depends on the air time, so with
+// nIRQ the transactions are exactly the minimal sequence: TX 3 (FIFO write, TX, interrupt read),
+// RX 4 (RX, interrupt read, length read, FIFO read).
+// Also measures completion latency (from the flag being raised to the return), and checks the
+// timeout and packet too long for the buffer.
+
+#include "test_utils.h"
+#include "s2lp_gpio.h"
+#include "s2lp_packet.h"
+#include "s2lp_rf.h"
+
+#include <string.h>
+
+#define BENCH_PACKET_COUNT 200
+
+typedef enum Mode_t {
+	MODE_HAND_WRITTEN, MODE_BLOCKING_POLL, MODE_BLOCKING_NIRQ, MODE_CALLBACK_NIRQ, MODE_COUNT
+} Mode;
+
+static char const* const mode_names[MODE_COUNT] = {
+	"hand-written poll", "blocking poll", "blocking nIRQ", "callback nIRQ"
+};
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+static uint8_t transmitted[BENCH_PACKET_COUNT * S2LP_FIFO_SIZE];
+static int callbacks;
+
+static void Setup(bool nirq) {
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 10000000);
+	S2LP_RF_SetDataRate(&handle, 250000);
+	S2LP_PCKT_SetVariablePacketLengthState(&handle, true);
+	if (nirq) {
+		S2LP_GPIO_SetPinOutput(&handle, S2LP_PIN_GPIO_0, S2LP_GPIO_OUT_NIRQ);
+	}
+	S2LP_Emulator_SetTxSink(&emulator, transmitted, sizeof(transmitted));
+	S2LP_GetInterrupts(&handle);
+}
+
+static void HandWrittenSend(uint8_t* data, size_t length) {
+	S2LP_SendCommand(&handle, S2LP_CMD_FLUSHTXFIFO);
+	S2LP_PCKT_SetPacketLength(&handle, length);
+	S2LP_WriteFIFO(&handle, length, data);
+	S2LP_SendCommand(&handle, S2LP_CMD_TX);
+	while (!GETBIT(S2LP_GetInterruptsEx(&handle, true), S2LP_INT_TX_DATA_SENT)) {
+	}
+}
+
+static size_t HandWrittenReceive(uint8_t* buffer) {
+	S2LP_SendCommand(&handle, S2LP_CMD_FLUSHRXFIFO);
+	S2LP_SendCommand(&handle, S2LP_CMD_RX);
+	while (!GETBIT(S2LP_GetInterruptsEx(&handle, true), S2LP_INT_RX_DATA_READY)) {
+	}
+	size_t const length = S2LP_PCKT_GetRxPacketLength(&handle);
+	S2LP_ReadFIFO(&handle, length, buffer);
+	return length;
+}
+
+static void OnPacket(S2LP_Handle* operation_handle, S2LP_PacketOperation* operation) {
+	(void) operation_handle;
+	(void) operation;
+	callbacks++;
+}
+
+// nIRQ handler, called from the main loop when the line is asserted (active low)
+static void RunOperation(S2LP_PacketOperation* operation) {
+	while (callbacks == 0) {
+		if (!S2LP_ReadPin(&handle, S2LP_PIN_GPIO_0)) {
+			S2LP_ProcessPacket(operation, S2LP_GetInterrupts(&handle));
+		}
+	}
+}
+
+static bool Send(Mode mode, uint8_t* data, size_t length) {
+	if (mode == MODE_HAND_WRITTEN) {
+		HandWrittenSend(data, length);
+		return true;
+	} else if (mode == MODE_CALLBACK_NIRQ) {
+		S2LP_PacketOperation operation;
+		callbacks = 0;
+		S2LP_StartSendPacket(&operation, &handle, data, length, OnPacket, NULL);
+		RunOperation(&operation);
+		return operation.result == S2LP_PACKET_DONE;
+	}
+	return S2LP_SendPacket(&handle, data, length, 100) == S2LP_PACKET_DONE;
+}
+
+static bool Receive(Mode mode, uint8_t* buffer, size_t capacity, size_t* length) {
+	if (mode == MODE_HAND_WRITTEN) {
+		*length = HandWrittenReceive(buffer);
+		return true;
+	} else if (mode == MODE_CALLBACK_NIRQ) {
+		S2LP_PacketOperation operation;
+		callbacks = 0;
+		S2LP_StartReceivePacket(&operation, &handle, buffer, capacity, OnPacket, NULL);
+		RunOperation(&operation);
+		*length = operation.length;
+		return operation.result == S2LP_PACKET_DONE;
+	}
+	return S2LP_ReceivePacket(&handle, buffer, capacity, length, 100) == S2LP_PACKET_DONE;
+}
+
+static void Run(Mode mode, size_t length) {
+	uint8_t data[S2LP_FIFO_SIZE];
+	uint8_t buffer[S2LP_FIFO_SIZE];
+	for (size_t i = 0; i < length; i++) {
+		data[i] = (uint8_t) (i * 7 + length);
+	}
+
+	Setup(mode == MODE_BLOCKING_NIRQ || mode == MODE_CALLBACK_NIRQ);
+	// Warm-up writes the packet length and interrupt masks once
+	size_t received = 0;
+	TEST_CHECK(Send(mode, data, length));
+	S2LP_Emulator_InjectPacket(&emulator, data, length);
+	TEST_CHECK(Receive(mode, buffer, sizeof(buffer), &received));
+
+	S2LP_Emulator_ResetStatistics(&emulator);
+	emulator.tx_sink_length = 0;
+	uint64_t start_ns = emulator.time_ns;
+	for (int i = 0; i < BENCH_PACKET_COUNT; i++) {
+		TEST_CHECK(Send(mode, data, length));
+	}
+	double const tx_transactions = (double) emulator.statistics.transactions / BENCH_PACKET_COUNT;
+	double const tx_bytes = (double) emulator.statistics.spi_bytes / BENCH_PACKET_COUNT;
+	double const tx_time = (emulator.time_ns - start_ns) / 1e3 / BENCH_PACKET_COUNT;
+	TEST_CHECK(emulator.tx_sink_length == BENCH_PACKET_COUNT * length);
+	TEST_CHECK(memcmp(transmitted + (BENCH_PACKET_COUNT - 1) * length, data, length) == 0);
+
+	S2LP_Emulator_ResetStatistics(&emulator);
+	start_ns = emulator.time_ns;
+	for (int i = 0; i < BENCH_PACKET_COUNT; i++) {
+		S2LP_Emulator_InjectPacket(&emulator, data, length);
+		TEST_CHECK(Receive(mode, buffer, sizeof(buffer), &received));
+		TEST_CHECK(received == length && memcmp(buffer, data, length) == 0);
+	}
+	double const rx_transactions = (double) emulator.statistics.transactions / BENCH_PACKET_COUNT;
+	double const rx_bytes = (double) emulator.statistics.spi_bytes / BENCH_PACKET_COUNT;
+	double const rx_time = (emulator.time_ns - start_ns) / 1e3 / BENCH_PACKET_COUNT;
+
+	printf("%3zu B %-18s TX %6.2f frames %7.1f bytes %7.1f us | RX %6.2f frames %7.1f bytes %7.1f us\n", length,
+			mode_names[mode], tx_transactions, tx_bytes, tx_time, rx_transactions, rx_bytes, rx_time);
+	if (mode == MODE_BLOCKING_NIRQ || mode == MODE_CALLBACK_NIRQ) {
+		TEST_CHECK(tx_transactions == 3.0);
+		TEST_CHECK(rx_transactions == 4.0);
+	}
+}
+
+// Time from TX_DATA_SENT being raised to S2LP_WaitPacket return
+static void MeasureLatency(bool nirq) {
+	uint8_t data[16] = { 0 };
+	double total = 0;
+	double worst = 0;
+
+	Setup(nirq);
+	S2LP_SendPacket(&handle, data, sizeof(data), 0);
+	for (int i = 0; i < BENCH_PACKET_COUNT; i++) {
+		S2LP_PacketOperation operation;
+		S2LP_StartSendPacket(&operation, &handle, data, sizeof(data), NULL, NULL);
+		while (S2LP_Emulator_GetPendingInterrupts(&emulator) == 0) {
+			S2LP_Emulator_AdvanceTime(&emulator, 10);
+		}
+		uint64_t const raised_ns = emulator.time_ns;
+		TEST_CHECK(S2LP_WaitPacket(&operation, 0) == S2LP_PACKET_DONE);
+		double const latency = (emulator.time_ns - raised_ns) / 1e3;
+		total += latency;
+		if (latency > worst) {
+			worst = latency;
+		}
+	}
+	printf("TX completion latency (%s): avg %.2f us, worst %.2f us\n", nirq ? "nIRQ" : "polling",
+			total / BENCH_PACKET_COUNT, worst);
+}
+
+static void TestErrors(void) {
+	uint8_t data[64] = { 0 };
+	uint8_t buffer[32];
+	size_t length = 0;
+
+	Setup(true);
+	S2LP_PacketOperation operation;
+	S2LP_StartReceivePacket(&operation, &handle, buffer, sizeof(buffer), NULL, NULL);
+	uint64_t const start_ns = emulator.time_ns;
+	TEST_CHECK(S2LP_WaitPacket(&operation, 5) == S2LP_PACKET_TIMEOUT);
+	double const timeout = (emulator.time_ns - start_ns) / 1e6;
+	printf("RX timeout after %.2f ms\n", timeout);
+	TEST_CHECK(timeout >= 5.0 && timeout < 5.1);
+
+	// Packet is reported with it's real length, and the next one is received normally
+	S2LP_Emulator_InjectPacket(&emulator, data, sizeof(data));
+	TEST_CHECK(S2LP_ReceivePacket(&handle, buffer, sizeof(buffer), &length, 100) == S2LP_PACKET_ERROR);
+	TEST_CHECK(length == sizeof(data));
+	S2LP_Emulator_InjectPacket(&emulator, data, 20);
+	TEST_CHECK(S2LP_ReceivePacket(&handle, buffer, sizeof(buffer), &length, 100) == S2LP_PACKET_DONE);
+	TEST_CHECK(length == 20);
+}
+
+int main(void) {
+	size_t const lengths[] = { 16, 64, 128 };
+	for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+		for (int mode = 0; mode < MODE_COUNT; mode++) {
+			Run((Mode) mode, lengths[i]);
+		}
+	}
+
+	MeasureLatency(true);
+	MeasureLatency(false);
+	TestErrors();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,265 @@
+/*
+ * bench_pool.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// CPU cost of handing received packets from the driver to the application:
+// * copy path - FIFO read into a stack buffer, copied into S2LP_Ring (Push) and out of it (Pop)
+// * pool path - FIFO read straight into a pool buffer, pointer handed over with S2LP_BufferQueue
+// against the driver I/O alone (packet length and FIFO read, RSSI and timestamp). Packets are handed
+// over in bursts of 8. SPI goes through a transport answering instantly, so only CPU time is measured
+// (best of 7 runs). The application has to get every packet intact.
+// Pool exhaustion, headroom and a TX/RX round trip of pool buffers on the emulator are checked too.
+
+#include "test_utils.h"
+#include "s2lp_packet.h"
+#include "s2lp_pool.h"
+#include "s2lp_ring.h"
+#include "s2lp_rx.h"
+
+#include <string.h>
+
+#define BENCH_POOL_PACKETS 200000
+#define BENCH_POOL_BURST 8
+#define BENCH_POOL_RUNS 7
+
+// Transport without the chip - RX_PCKT_LEN registers return the packet length, FIFO returns the fill byte
+typedef struct NullChip_t {
+	uint8_t address;
+	size_t packet_length;
+	uint8_t fill;
+} NullChip;
+
+static void NullTransfer(void* context, uint8_t const* tx_data, uint8_t* rx_data, size_t length) {
+	NullChip* chip = (NullChip*) context;
+	if (length == 2 && tx_data != NULL) {
+		// Header
+		chip->address = tx_data[1];
+		if (rx_data != NULL) {
+			memset(rx_data, 0, length);
+		}
+		return;
+	}
+	if (rx_data == NULL) {
+		return;
+	}
+
+	if (chip->address == S2LP_REG_RX_PCKT_LEN1) {
+		rx_data[0] = (uint8_t) (chip->packet_length >> 8);
+		if (length > 1) {
+			rx_data[1] = (uint8_t) chip->packet_length;
+		}
+	} else if (chip->address == S2LP_ADDR_FIFO) {
+		memset(rx_data, chip->fill, length);
+	} else {
+		memset(rx_data, 0, length);
+	}
+}
+
+static void NullWritePin(void* context, S2LP_Pin pin, bool state) {
+	(void) context;
+	(void) pin;
+	(void) state;
+}
+
+static bool NullReadPin(void* context, S2LP_Pin pin) {
+	(void) context;
+	(void) pin;
+	return true;
+}
+
+static void NullDelay(void* context, uint32_t milliseconds) {
+	(void) context;
+	(void) milliseconds;
+}
+
+static uint32_t NullGetTime(void* context) {
+	(void) context;
+	return 0;
+}
+
+static S2LP_Transport const NullTransport = {
+	.transfer = NullTransfer,
+	.write_pin = NullWritePin,
+	.read_pin = NullReadPin,
+	.delay = NullDelay,
+	.get_time_us = NullGetTime,
+};
+
+static NullChip chip;
+static S2LP_Handle handle;
+static S2LP_Pool pool;
+static S2LP_BufferQueue queue;
+static S2LP_Ring ring;
+static uint32_t errors;
+static volatile uint32_t sink;
+
+// Application touching the packet
+static void Process(uint8_t const* data, size_t length) {
+	if (length != chip.packet_length || data[0] != chip.fill || data[length - 1] != chip.fill) {
+		errors++;
+	}
+	uint32_t sum = 0;
+	for (size_t i = 0; i < length; i += 16) {
+		sum += data[i];
+	}
+	sink += sum;
+}
+
+static void ReadPacket(uint8_t* buffer, size_t* length) {
+	*length = S2LP_PCKT_GetRxPacketLength(&handle);
+	S2LP_ReadFIFO(&handle, *length, buffer);
+	sink += S2LP_RX_GetCapturedRSSI(&handle) + S2LP_GetTime(&handle);
+}
+
+static void RunDriverOnly(void) {
+	for (int i = 0; i < BENCH_POOL_PACKETS; i++) {
+		uint8_t buffer[S2LP_FIFO_SIZE];
+		size_t length = 0;
+		ReadPacket(buffer, &length);
+		Process(buffer, length);
+	}
+}
+
+static void RunCopyPath(void) {
+	S2LP_Ring_Init(&ring);
+	for (int i = 0; i < BENCH_POOL_PACKETS / BENCH_POOL_BURST; i++) {
+		for (int packet = 0; packet < BENCH_POOL_BURST; packet++) {
+			uint8_t buffer[S2LP_FIFO_SIZE];
+			size_t length = 0;
+			ReadPacket(buffer, &length);
+			S2LP_Ring_Push(&ring, buffer, length);
+		}
+
+		S2LP_Frame frame;
+		while (S2LP_Ring_Pop(&ring, &frame)) {
+			Process(frame.data, frame.length);
+		}
+	}
+}
+
+static void RunPoolPath(void) {
+	S2LP_Pool_Init(&pool);
+	S2LP_BufferQueue_Init(&queue);
+	for (int i = 0; i < BENCH_POOL_PACKETS / BENCH_POOL_BURST; i++) {
+		for (int packet = 0; packet < BENCH_POOL_BURST; packet++) {
+			S2LP_Buffer* buffer = S2LP_Pool_ReceivePacket(&pool, &handle);
+			if (buffer != NULL) {
+				S2LP_Pool_Enqueue(&pool, &queue, buffer);
+			}
+		}
+
+		S2LP_Buffer* buffer = NULL;
+		while ((buffer = S2LP_Pool_Dequeue(&pool, &queue)) != NULL) {
+			Process(buffer->data, buffer->length);
+			S2LP_Pool_Free(&pool, buffer);
+		}
+	}
+}
+
+// Best of the runs, in ns per packet
+static double Measure(void (*function)(void)) {
+	double best = 0;
+	for (int run = 0; run < BENCH_POOL_RUNS; run++) {
+		errors = 0;
+		uint64_t const start = Test_Now();
+		function();
+		double const time = (double) (Test_Now() - start) / BENCH_POOL_PACKETS;
+		if (run == 0 || time < best) {
+			best = time;
+		}
+		TEST_CHECK(errors == 0);
+	}
+	return best;
+}
+
+static void TestExhaustion(void) {
+	chip.packet_length = 64;
+	S2LP_Pool_Init(&pool);
+	S2LP_BufferQueue_Init(&queue);
+
+	// Application holding more buffers than the pool has
+	for (int i = 0; i < S2LP_POOL_MAX_BUFFERS + 4; i++) {
+		S2LP_Buffer* buffer = S2LP_Pool_ReceivePacket(&pool, &handle);
+		if (buffer != NULL) {
+			S2LP_Pool_Enqueue(&pool, &queue, buffer);
+		}
+	}
+	printf("holding %d buffers: %zu queued, %u exhaustions\n", S2LP_POOL_MAX_BUFFERS + 4, queue.count,
+			pool.statistics.exhaustions);
+	TEST_CHECK(queue.count == S2LP_POOL_MAX_BUFFERS);
+	TEST_CHECK(pool.statistics.exhaustions == 4);
+	TEST_CHECK(S2LP_Pool_GetFreeCount(&pool) == 0);
+
+	// Headers fit in the headroom only
+	S2LP_Buffer* buffer = S2LP_Pool_Dequeue(&pool, &queue);
+	uint8_t* const header = S2LP_Buffer_Prepend(buffer, 4);
+	TEST_CHECK(header != NULL && buffer->data == header && buffer->length == 68);
+	TEST_CHECK(buffer->data[4] == chip.fill);
+	TEST_CHECK(S2LP_Buffer_Prepend(buffer, S2LP_POOL_HEADROOM - 3) == NULL);
+	S2LP_Pool_Free(&pool, buffer);
+	TEST_CHECK(S2LP_Pool_GetFreeCount(&pool) == 1);
+}
+
+static void TestEmulatorRoundTrip(void) {
+	static S2LP_Emulator emulator;
+	static S2LP_Handle emulated_handle;
+	uint8_t transmitted[256];
+
+	Test_InitEmulatedHandle(&emulated_handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 8000000);
+	S2LP_Emulator_SetTxSink(&emulator, transmitted, sizeof(transmitted));
+	S2LP_Pool_Init(&pool);
+
+	S2LP_Buffer* sent = S2LP_Pool_Alloc(&pool);
+	for (size_t i = 0; i < 50; i++) {
+		sent->data[i] = (uint8_t) (i * 7);
+	}
+	sent->length = 50;
+	memcpy(S2LP_Buffer_Prepend(sent, 2), "\xAB\xCD", 2);
+
+	TEST_CHECK(S2LP_Pool_WritePacket(&emulated_handle, sent));
+	S2LP_SendCommand(&emulated_handle, S2LP_CMD_TX);
+	while (!GETBIT(S2LP_GetInterrupts(&emulated_handle), S2LP_INT_TX_DATA_SENT)) {
+		S2LP_Emulator_AdvanceTime(&emulator, 10000);
+	}
+
+	S2LP_Emulator_InjectPacket(&emulator, transmitted, emulator.tx_sink_length);
+	S2LP_SendCommand(&emulated_handle, S2LP_CMD_RX);
+	while (!GETBIT(S2LP_GetInterrupts(&emulated_handle), S2LP_INT_RX_DATA_READY)) {
+		S2LP_Emulator_AdvanceTime(&emulator, 10000);
+	}
+	S2LP_Buffer* received = S2LP_Pool_ReceivePacket(&pool, &emulated_handle);
+
+	printf("emulator round trip: %zu bytes sent, %zu received\n", emulator.tx_sink_length,
+			received != NULL ? received->length : 0);
+	TEST_CHECK(emulator.tx_sink_length == 52);
+	TEST_CHECK(received != NULL && received->length == 52);
+	TEST_CHECK(received != NULL && memcmp(received->data, sent->data, 52) == 0);
+}
+
+int main(void) {
+	handle.transport = &NullTransport;
+	handle.transport_context = &chip;
+	S2LP_InitHandle(&handle);
+
+	for (size_t length = 16; length <= S2LP_FIFO_SIZE; length *= 2) {
+		chip.packet_length = length;
+		chip.fill = (uint8_t) length;
+		double const driver = Measure(RunDriverOnly);
+		double const copy = Measure(RunCopyPath);
+		double const pooled = Measure(RunPoolPath);
+		printf("%3zu B: driver I/O only %6.1f ns, copy path %6.1f ns (%+5.1f, %3zu B copied), "
+				"pool path %6.1f ns (%+5.1f, 0 B copied) per packet\n", length, driver, copy, copy - driver,
+				2 * length, pooled, pooled - driver);
+		TEST_CHECK(pool.statistics.exhaustions == 0);
+		TEST_CHECK(pool.statistics.allocations == pool.statistics.frees);
+		TEST_CHECK(pool.statistics.min_free == S2LP_POOL_MAX_BUFFERS - BENCH_POOL_BURST);
+	}
+
+	TestExhaustion();
+	TestEmulatorRoundTrip();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+/*
+ * bench_rf_calc.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Speed of RF calculations, built twice (with and without S2LP_FIXED_POINT_MATH, see the Makefile).
+// Keep in mind that the host has an FPU - the gain of fixed-point math is much bigger on MCUs
+// without one, where every double operation is a software library call.
+
+#include "test_utils.h"
+#include "s2lp_rf_calc.h"
+#include "s2lp_rx.h"
+
+#define BENCH_RF_CALC_CALLS 2000000u
+
+static volatile uint64_t sink;
+
+typedef uint64_t (*BenchFunction)(S2LP_RF_Context const* context, uint32_t index);
+
+static uint64_t DataRateValue(S2LP_RF_Context const* context, uint32_t index) {
+	return S2LP_RFCalc_DataRateValue(context, (uint16_t) (index * 40503u), (uint8_t) (index % 15));
+}
+
+static uint64_t DataRateExponentMantissa(S2LP_RF_Context const* context, uint32_t index) {
+	uint32_t const datarate = S2LP_DATARATE_MIN + index % (S2LP_DATARATE_MAX - S2LP_DATARATE_MIN);
+	uint8_t const exponent = S2LP_RFCalc_DataRateExponent(context, datarate);
+	return exponent + S2LP_RFCalc_DataRateMantissa(context, datarate, exponent);
+}
+
+static uint64_t SolveDataRate(S2LP_RF_Context const* context, uint32_t index) {
+	S2LP_RFCalc_Solution solution;
+	S2LP_RFCalc_SolveDataRate(context, S2LP_DATARATE_MIN + index % (S2LP_DATARATE_MAX - S2LP_DATARATE_MIN),
+			&solution);
+	return solution.mantissa + solution.exponent;
+}
+
+static uint64_t FrequencyDeviation(S2LP_RF_Context const* context, uint32_t index) {
+	return (uint64_t) S2LP_RFCalc_FrequencyDeviation(context, (uint8_t) index, (uint8_t) (index % 15));
+}
+
+static uint64_t FreqDevExponentMantissa(S2LP_RF_Context const* context, uint32_t index) {
+	uint32_t const deviation = 1000 + index % 500000;
+	uint8_t const exponent = S2LP_RFCalc_FreqDevExponent(context, deviation);
+	return exponent + S2LP_RFCalc_FreqDevMantissa(context, exponent, deviation);
+}
+
+static uint64_t SyncForBaseFrequency(S2LP_RF_Context const* context, uint32_t index) {
+	return S2LP_RFCalc_SyncForBaseFrequency(context, 860000000u + index);
+}
+
+static uint64_t BaseFrequency(S2LP_RF_Context const* context, uint32_t index) {
+	return (uint64_t) S2LP_RFCalc_BaseFrequency(context, 0x4000000u + index);
+}
+
+static void Measure(char const* name, S2LP_RF_Context const* context, BenchFunction function) {
+	uint64_t result = 0;
+	uint64_t const start = Test_Now();
+	for (uint32_t i = 0; i < BENCH_RF_CALC_CALLS; i++) {
+		result += function(context, i);
+	}
+	uint64_t const elapsed = Test_Now() - start;
+	sink = result;
+	printf("  %-26s %6.1f ns/call\n", name, (double) elapsed / BENCH_RF_CALC_CALLS);
+	TEST_CHECK(result != 0);
+}
+
+int main(void) {
+#ifdef S2LP_FIXED_POINT_MATH
+	printf("fixed-point RF calculations:\n");
+#else
+	printf("floating point RF calculations:\n");
+#endif
+
+	S2LP_RF_Context context;
+	S2LP_RFCalc_InitContext(&context, S2LP_CLOCK_FREQ_50MHZ, S2LP_SYNTH_BAND_HIGH, true);
+
+	Measure("DataRateValue", &context, DataRateValue);
+	Measure("DataRateExponent+Mantissa", &context, DataRateExponentMantissa);
+	Measure("SolveDataRate", &context, SolveDataRate);
+	Measure("FrequencyDeviation", &context, FrequencyDeviation);
+	Measure("FreqDevExponent+Mantissa", &context, FreqDevExponentMantissa);
+	Measure("SyncForBaseFrequency", &context, SyncForBaseFrequency);
+	Measure("BaseFrequency", &context, BaseFrequency);
+
+	return TEST_RESULT();
+}
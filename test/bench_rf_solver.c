@@ -0,0 +1,208 @@
+/*
+ * bench_rf_solver.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Speed and accuracy of datarate and frequency deviation solvers, against the exponent scan and
+// mantissa interpolation they replaced (S2LP_RFCalc_DataRateExponent/Mantissa and
+// S2LP_RFCalc_FreqDevExponent/Mantissa), for every datarate from S2LP_DATARATE_MIN to S2LP_DATARATE_MAX
+// and every clock frequency. Solutions are compared with brute force search over all mantissa/exponent
+// pairs - for a sample of datarates, and deviations up to 1MHz - and have to be optimal.
+
+#include "test_utils.h"
+#include "s2lp_rf_calc.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define BENCH_RF_SOLVER_DATARATE_SAMPLES 40
+#define BENCH_RF_SOLVER_DEVIATION_STEP 997
+
+static volatile uint32_t sink;
+
+// Exact datarate from the datasheet formula, without rounding
+static double ExactDataRate(S2LP_RF_Context const* context, uint32_t mantissa, uint32_t exponent) {
+	if (exponent == 0) {
+		return (double) context->fdig * mantissa / 4294967296.0;
+	} else if (exponent == 15) {
+		return mantissa == 0 ? INFINITY : (double) context->fdig / (8.0 * mantissa);
+	}
+	return (double) context->fdig * (65536.0 + mantissa) * (double) (1u << exponent) / 8589934592.0;
+}
+
+static double BruteForceDataRateError(S2LP_RF_Context const* context, uint32_t datarate) {
+	double best = INFINITY;
+	for (uint32_t exponent = 0; exponent <= 15; exponent++) {
+		for (uint32_t mantissa = 0; mantissa <= S2LP_DATARATE_MANTISSA_MAX; mantissa++) {
+			double const error = fabs(ExactDataRate(context, mantissa, exponent) - datarate);
+			if (error < best) {
+				best = error;
+			}
+		}
+	}
+	return best;
+}
+
+static double BruteForceDeviationError(S2LP_RF_Context const* context, uint32_t deviation) {
+	double best = INFINITY;
+	for (uint32_t exponent = 0; exponent <= 15; exponent++) {
+		for (uint32_t mantissa = 0; mantissa <= 255; mantissa++) {
+			double const error = fabs(
+					S2LP_RFCalc_FrequencyDeviation(context, (uint8_t) mantissa, (uint8_t) exponent) - deviation);
+			if (error < best) {
+				best = error;
+			}
+		}
+	}
+	return best;
+}
+
+static void CheckOptimality(S2LP_ClockFrequency frequency) {
+	S2LP_RF_Context context;
+	size_t failures = 0;
+
+	S2LP_RFCalc_InitContext(&context, frequency, S2LP_SYNTH_BAND_HIGH, false);
+	srand((unsigned) frequency);
+	for (size_t i = 0; i < BENCH_RF_SOLVER_DATARATE_SAMPLES; i++) {
+		uint32_t datarate = S2LP_DATARATE_MIN
+				+ (uint32_t) (((uint64_t) rand() * (uint64_t) rand()) % (S2LP_DATARATE_MAX - S2LP_DATARATE_MIN + 1));
+		if (i == 0) {
+			datarate = S2LP_DATARATE_MIN;
+		} else if (i == 1) {
+			datarate = S2LP_DATARATE_MAX;
+		}
+
+		S2LP_RFCalc_Solution solution;
+		TEST_CHECK(S2LP_RFCalc_SolveDataRate(&context, datarate, &solution));
+		double const error = fabs(ExactDataRate(&context, solution.mantissa, solution.exponent) - datarate);
+		if (error > BruteForceDataRateError(&context, datarate) * (1 + 1e-9) + 1e-12) {
+			failures++;
+		}
+	}
+
+	for (int band = S2LP_SYNTH_BAND_HIGH; band <= S2LP_SYNTH_BAND_MID; band++) {
+		for (int ref_div = 0; ref_div <= 1; ref_div++) {
+			S2LP_RFCalc_InitContext(&context, frequency, (S2LP_SynthesizerBand) band, ref_div);
+			for (uint32_t deviation = 0; deviation <= 1000000; deviation += BENCH_RF_SOLVER_DEVIATION_STEP) {
+				S2LP_RFCalc_Solution solution;
+				TEST_CHECK(S2LP_RFCalc_SolveFrequencyDeviation(&context, deviation, &solution));
+				double const error = fabs(
+						S2LP_RFCalc_FrequencyDeviation(&context, (uint8_t) solution.mantissa, solution.exponent)
+								- deviation);
+				if (error > BruteForceDeviationError(&context, deviation) * (1 + 1e-12) + 1e-9) {
+					failures++;
+				}
+			}
+		}
+	}
+
+	printf("  optimality against brute force: %zu failures\n", failures);
+	TEST_CHECK(failures == 0);
+}
+
+static void MeasureDataRate(S2LP_ClockFrequency frequency) {
+	S2LP_RF_Context context;
+	S2LP_RFCalc_InitContext(&context, frequency, S2LP_SYNTH_BAND_HIGH, false);
+	uint32_t const count = S2LP_DATARATE_MAX - S2LP_DATARATE_MIN + 1;
+
+	uint64_t start = Test_Now();
+	for (uint32_t datarate = S2LP_DATARATE_MIN; datarate <= S2LP_DATARATE_MAX; datarate++) {
+		uint8_t const exponent = S2LP_RFCalc_DataRateExponent(&context, datarate);
+		sink = exponent + S2LP_RFCalc_DataRateMantissa(&context, datarate, exponent);
+	}
+	double const scan_time = (double) (Test_Now() - start) / count;
+
+	start = Test_Now();
+	for (uint32_t datarate = S2LP_DATARATE_MIN; datarate <= S2LP_DATARATE_MAX; datarate++) {
+		S2LP_RFCalc_Solution solution;
+		S2LP_RFCalc_SolveDataRate(&context, datarate, &solution);
+		sink = solution.mantissa + solution.exponent;
+	}
+	double const solver_time = (double) (Test_Now() - start) / count;
+
+	double scan_max = 0;
+	double scan_sum = 0;
+	double solver_max = 0;
+	double solver_sum = 0;
+	for (uint32_t datarate = S2LP_DATARATE_MIN; datarate <= S2LP_DATARATE_MAX; datarate++) {
+		uint8_t const exponent = S2LP_RFCalc_DataRateExponent(&context, datarate);
+		uint16_t const mantissa = S2LP_RFCalc_DataRateMantissa(&context, datarate, exponent);
+		double const scan_error = fabs(ExactDataRate(&context, mantissa, exponent) - datarate) / datarate * 1e6;
+		scan_sum += scan_error;
+		scan_max = fmax(scan_max, scan_error);
+
+		S2LP_RFCalc_Solution solution;
+		S2LP_RFCalc_SolveDataRate(&context, datarate, &solution);
+		solver_sum += fabs(solution.error_ppm);
+		solver_max = fmax(solver_max, fabs(solution.error_ppm));
+	}
+
+	printf("  datarate   scan:   %6.1f ns, error max %10.1f ppm, mean %6.2f ppm\n", scan_time, scan_max,
+			scan_sum / count);
+	printf("  datarate   solver: %6.1f ns, error max %10.1f ppm, mean %6.2f ppm\n", solver_time, solver_max,
+			solver_sum / count);
+	TEST_CHECK(solver_max <= scan_max);
+	TEST_CHECK(solver_sum <= scan_sum);
+}
+
+static void MeasureDeviation(S2LP_ClockFrequency frequency) {
+	S2LP_RF_Context context;
+	S2LP_RFCalc_InitContext(&context, frequency, S2LP_SYNTH_BAND_HIGH, false);
+	// Deviations from 1kHz, relative error of lower ones is dominated by the resolution
+	uint32_t const first = 1000;
+	uint32_t const last = 500000;
+	uint32_t const count = last - first + 1;
+
+	uint64_t start = Test_Now();
+	for (uint32_t deviation = first; deviation <= last; deviation++) {
+		uint8_t const exponent = S2LP_RFCalc_FreqDevExponent(&context, deviation);
+		sink = exponent + S2LP_RFCalc_FreqDevMantissa(&context, exponent, deviation);
+	}
+	double const scan_time = (double) (Test_Now() - start) / count;
+
+	start = Test_Now();
+	for (uint32_t deviation = first; deviation <= last; deviation++) {
+		S2LP_RFCalc_Solution solution;
+		S2LP_RFCalc_SolveFrequencyDeviation(&context, deviation, &solution);
+		sink = solution.mantissa + solution.exponent;
+	}
+	double const solver_time = (double) (Test_Now() - start) / count;
+
+	double scan_max = 0;
+	double scan_sum = 0;
+	double solver_max = 0;
+	double solver_sum = 0;
+	for (uint32_t deviation = first; deviation <= last; deviation++) {
+		uint8_t const exponent = S2LP_RFCalc_FreqDevExponent(&context, deviation);
+		uint8_t const mantissa = S2LP_RFCalc_FreqDevMantissa(&context, exponent, deviation);
+		double const scan_error = fabs(S2LP_RFCalc_FrequencyDeviation(&context, mantissa, exponent) - deviation)
+				/ deviation * 1e6;
+		scan_sum += scan_error;
+		scan_max = fmax(scan_max, scan_error);
+
+		S2LP_RFCalc_Solution solution;
+		S2LP_RFCalc_SolveFrequencyDeviation(&context, deviation, &solution);
+		solver_sum += fabs(solution.error_ppm);
+		solver_max = fmax(solver_max, fabs(solution.error_ppm));
+	}
+
+	printf("  deviation  scan:   %6.1f ns, error max %10.1f ppm, mean %6.2f ppm\n", scan_time, scan_max,
+			scan_sum / count);
+	printf("  deviation  solver: %6.1f ns, error max %10.1f ppm, mean %6.2f ppm\n", solver_time, solver_max,
+			solver_sum / count);
+	TEST_CHECK(solver_max <= scan_max);
+	TEST_CHECK(solver_sum <= scan_sum);
+}
+
+int main(void) {
+	for (int frequency = S2LP_CLOCK_FREQ_24MHZ; frequency <= S2LP_CLOCK_FREQ_52MHZ; frequency++) {
+		printf("clock %u Hz:\n", S2LP_RFCalc_ClockFrequency((S2LP_ClockFrequency) frequency));
+		MeasureDataRate((S2LP_ClockFrequency) frequency);
+		MeasureDeviation((S2LP_ClockFrequency) frequency);
+		CheckOptimality((S2LP_ClockFrequency) frequency);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,265 @@
+/*
+ * bench_ring.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Throughput and latency of S2LP_Ring with producer and consumer threads:
+// * raw 32-byte frames, lock-free against the same ring guarded with a mutex
+// * producer thread running the emulated radio (500kbps, 64-byte packets) in real time and storing
+//   received packets, consumer thread stalled periodically - the ring absorbs short stalls, and drops
+//   (counted) new packets when the stall is longer than it's capacity
+// Frames have to come out in order and intact. Latency is measured from commit to consumption.
+
+#include "test_utils.h"
+#include "s2lp_rf.h"
+#include "s2lp_ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#define BENCH_RING_RAW_FRAMES 1000000u
+#define BENCH_RING_RAW_FRAME_LENGTH 32
+#define BENCH_RING_PACKETS 1500u
+#define BENCH_RING_PACKET_LENGTH 64
+#define BENCH_RING_STALL_PERIOD 100
+
+static S2LP_Ring ring;
+// Commit time of every frame, published together with the frame
+static uint64_t commit_times[S2LP_RING_MAX_FRAMES];
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool use_mutex;
+static atomic_bool producer_done;
+static uint32_t stall_us;
+
+// Consumer-side results
+static uint32_t consumed;
+static uint32_t errors;
+static uint64_t latency_total_ns;
+static uint64_t latency_max_ns;
+// Power of 2 histogram
+static uint64_t latency_histogram[64];
+
+static void ResetResults(void) {
+	S2LP_Ring_Init(&ring);
+	atomic_store(&producer_done, false);
+	consumed = 0;
+	errors = 0;
+	latency_total_ns = 0;
+	latency_max_ns = 0;
+	memset(latency_histogram, 0, sizeof(latency_histogram));
+}
+
+static size_t HeadIndex(void) {
+	return atomic_load_explicit(&ring.head, memory_order_relaxed) & (S2LP_RING_MAX_FRAMES - 1);
+}
+
+static size_t TailIndex(void) {
+	return atomic_load_explicit(&ring.tail, memory_order_relaxed) & (S2LP_RING_MAX_FRAMES - 1);
+}
+
+static void RecordLatency(void) {
+	uint64_t const latency = Test_Now() - commit_times[TailIndex()];
+	size_t bucket = 0;
+	while ((1ull << bucket) < latency && bucket < 63) {
+		bucket++;
+	}
+	latency_histogram[bucket]++;
+	latency_total_ns += latency;
+	if (latency > latency_max_ns) {
+		latency_max_ns = latency;
+	}
+	consumed++;
+}
+
+// Upper bound of the latency percentile
+static uint64_t LatencyPercentile(double percentile) {
+	uint64_t count = 0;
+	for (size_t bucket = 0; bucket < 64; bucket++) {
+		count += latency_histogram[bucket];
+		if (count >= percentile * consumed) {
+			return 1ull << bucket;
+		}
+	}
+	return 0;
+}
+
+static void* RawProducer(void* argument) {
+	(void) argument;
+	for (uint32_t i = 0; i < BENCH_RING_RAW_FRAMES;) {
+		if (use_mutex) {
+			pthread_mutex_lock(&mutex);
+		}
+		// Full ring is retried, so the drop counter counts only the retries here
+		S2LP_Frame* frame = S2LP_Ring_Reserve(&ring);
+		if (frame != NULL) {
+			memset(frame->data, (uint8_t) i, BENCH_RING_RAW_FRAME_LENGTH);
+			memcpy(frame->data, &i, sizeof(i));
+			frame->length = BENCH_RING_RAW_FRAME_LENGTH;
+			commit_times[HeadIndex()] = Test_Now();
+			S2LP_Ring_Commit(&ring);
+			i++;
+		}
+		if (use_mutex) {
+			pthread_mutex_unlock(&mutex);
+		}
+		if (frame == NULL) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void* RawConsumer(void* argument) {
+	(void) argument;
+	for (uint32_t i = 0; i < BENCH_RING_RAW_FRAMES;) {
+		if (use_mutex) {
+			pthread_mutex_lock(&mutex);
+		}
+		S2LP_Frame const* frame = S2LP_Ring_Peek(&ring);
+		if (frame != NULL) {
+			uint32_t value = 0;
+			memcpy(&value, frame->data, sizeof(value));
+			if (value != i || frame->length != BENCH_RING_RAW_FRAME_LENGTH
+					|| frame->data[BENCH_RING_RAW_FRAME_LENGTH - 1] != (uint8_t) i) {
+				errors++;
+			}
+			RecordLatency();
+			S2LP_Ring_Release(&ring);
+			i++;
+		}
+		if (use_mutex) {
+			pthread_mutex_unlock(&mutex);
+		}
+		if (frame == NULL) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void RunRaw(bool mutex_guarded) {
+	ResetResults();
+	use_mutex = mutex_guarded;
+
+	pthread_t producer;
+	pthread_t consumer;
+	uint64_t const start = Test_Now();
+	pthread_create(&consumer, NULL, RawConsumer, NULL);
+	pthread_create(&producer, NULL, RawProducer, NULL);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+	double const seconds = (double) (Test_Now() - start) / 1e9;
+
+	printf("raw %u B frames, %-9s: %.2f Mframes/s, latency avg %.0f ns, p50 <= %llu ns, p99 <= %llu ns, "
+			"max %.1f us, %u errors\n", BENCH_RING_RAW_FRAME_LENGTH, mutex_guarded ? "mutex" : "lock-free",
+			BENCH_RING_RAW_FRAMES / seconds / 1e6, (double) latency_total_ns / consumed,
+			(unsigned long long) LatencyPercentile(0.5), (unsigned long long) LatencyPercentile(0.99),
+			latency_max_ns / 1e3, errors);
+	TEST_CHECK(consumed == BENCH_RING_RAW_FRAMES);
+	TEST_CHECK(errors == 0);
+}
+
+// Receives the packets on the emulator, with the simulation paced to the real time
+static void* RadioProducer(void* argument) {
+	(void) argument;
+	static S2LP_Emulator emulator;
+	static S2LP_Handle handle;
+	static uint8_t packet[BENCH_RING_PACKET_LENGTH];
+
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 8000000);
+	S2LP_RF_SetDataRate(&handle, 500000);
+	uint64_t const start = Test_Now();
+	uint64_t const start_ns = emulator.time_ns;
+
+	for (uint32_t i = 0; i < BENCH_RING_PACKETS; i++) {
+		int64_t const ahead = (int64_t) (emulator.time_ns - start_ns) - (int64_t) (Test_Now() - start);
+		if (ahead > 0) {
+			struct timespec const time = { (time_t) (ahead / 1000000000), (long) (ahead % 1000000000) };
+			nanosleep(&time, NULL);
+		}
+
+		memset(packet, (uint8_t) i, sizeof(packet));
+		memcpy(packet, &i, sizeof(i));
+		S2LP_Emulator_InjectPacket(&emulator, packet, sizeof(packet));
+		S2LP_SendCommand(&handle, S2LP_CMD_RX);
+		while (!GETBIT(S2LP_GetInterrupts(&handle), S2LP_INT_RX_DATA_READY)) {
+			S2LP_Emulator_AdvanceTime(&emulator, 5000);
+		}
+		commit_times[HeadIndex()] = Test_Now();
+		S2LP_Ring_StoreReceived(&ring, &handle);
+	}
+
+	atomic_store(&producer_done, true);
+	return NULL;
+}
+
+static void* StalledConsumer(void* argument) {
+	(void) argument;
+	uint32_t last = 0;
+	for (;;) {
+		S2LP_Frame const* frame = S2LP_Ring_Peek(&ring);
+		if (frame == NULL) {
+			if (atomic_load(&producer_done) && S2LP_Ring_Peek(&ring) == NULL) {
+				break;
+			}
+			sched_yield();
+			continue;
+		}
+
+		// Dropped packets leave gaps, but the order has to be kept
+		uint32_t value = 0;
+		memcpy(&value, frame->data, sizeof(value));
+		if (frame->length != BENCH_RING_PACKET_LENGTH || (consumed > 0 && value <= last)
+				|| frame->data[BENCH_RING_PACKET_LENGTH - 1] != (uint8_t) value) {
+			errors++;
+		}
+		last = value;
+		RecordLatency();
+		S2LP_Ring_Release(&ring);
+
+		if (stall_us > 0 && consumed % BENCH_RING_STALL_PERIOD == 0) {
+			uint64_t const stall_start = Test_Now();
+			while (Test_Now() - stall_start < stall_us * 1000ull) {
+			}
+		}
+	}
+	return NULL;
+}
+
+static void RunRadio(uint32_t stall) {
+	ResetResults();
+	stall_us = stall;
+
+	pthread_t producer;
+	pthread_t consumer;
+	pthread_create(&consumer, NULL, StalledConsumer, NULL);
+	pthread_create(&producer, NULL, RadioProducer, NULL);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	printf("radio, consumer stalled %2u ms every %u frames: %u stored, %u dropped, max level %zu, "
+			"latency avg %.1f us, max %.1f us, %u errors\n", stall / 1000, BENCH_RING_STALL_PERIOD, ring.stored,
+			ring.dropped, ring.max_level, consumed ? latency_total_ns / 1e3 / consumed : 0.0, latency_max_ns / 1e3,
+			errors);
+	TEST_CHECK(ring.stored + ring.dropped == BENCH_RING_PACKETS);
+	TEST_CHECK(consumed == ring.stored);
+	TEST_CHECK(errors == 0);
+}
+
+int main(void) {
+	RunRaw(false);
+	RunRaw(true);
+
+	// Packet takes about 1.2ms, so the 16-frame ring covers stalls up to about 19ms
+	RunRadio(0);
+	TEST_CHECK(ring.dropped == 0);
+	RunRadio(10000);
+	TEST_CHECK(ring.dropped == 0);
+	RunRadio(50000);
+	TEST_CHECK(ring.dropped > 0);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,184 @@
+// Cost of bringing the configured chip back after reset - replaying the init sequence, applying a
+// configuration profile built from the same parameters, and restoring a register snapshot - and of
+// capturing the snapshot, with register cache enabled and disabled. Done for a high band (868MHz)
+// and mid band (433MHz) configuration.
+// SPI frames, bytes and time are measured on the emulator (8MHz SPI). The emulator doesn't model
+// the oscillator start-up, so only the SPI part of wake-to-ready latency is measured.
+// Register file after replay, profile and restore has to match the configured one, and the carrier
+// has to be on the configured frequency.
+
+#include "test_utils.h"
+#include "s2lp_packet.h"
+#include "s2lp_profile.h"
+#include "s2lp_rf.h"
+#include "s2lp_rx.h"
+#include "s2lp_snapshot.h"
+#include "s2lp_tx.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static S2LP_ProfileParameters const high_band_parameters = {
+	.base_frequency = 868000000,
+	.datarate = 38400,
+	.modulation = S2LP_MODULATION_2GFSK,
+	.frequency_deviation = 20000,
+	.channel_spacing = 10,
+	.channel_number = 3,
+	.channel_filter_mantissa = 8,
+	.channel_filter_exponent = 3,
+	.charge_pump_current = S2LP_CHARGE_PUMP_200UA,
+	.packet_format = S2LP_PACKET_BASIC,
+	.preamble_length = 64,
+	.sync_length = 32,
+	.packet_length = 20,
+	.variable_packet_length = true,
+	.crc_mode = S2LP_CRC_POLY_8005,
+	.data_coding = S2LP_CODING_NONE,
+	.data_whitening = true,
+	.power_level = 0x20,
+	.rssi_threshold = 0x30,
+};
+
+static S2LP_ProfileParameters const mid_band_parameters = {
+	.base_frequency = 433050000,
+	.datarate = 9600,
+	.modulation = S2LP_MODULATION_2FSK,
+	.frequency_deviation = 4800,
+	.channel_spacing = 4,
+	.channel_number = 7,
+	.channel_filter_mantissa = 3,
+	.channel_filter_exponent = 5,
+	.charge_pump_current = S2LP_CHARGE_PUMP_120UA,
+	.packet_format = S2LP_PACKET_BASIC,
+	.preamble_length = 32,
+	.sync_length = 16,
+	.packet_length = 12,
+	.variable_packet_length = false,
+	.crc_mode = S2LP_CRC_POLY_1021,
+	.data_coding = S2LP_CODING_NONE,
+	.data_whitening = false,
+	.power_level = 0x10,
+	.rssi_threshold = 0x20,
+};
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+
+// Typical init sequence, done with regular setters
+static void Configure(S2LP_ProfileParameters const* parameters) {
+	S2LP_SynthesizerBand band = S2LP_SYNTH_BAND_HIGH;
+	S2LP_RFCalc_SynthBandForFrequency(parameters->base_frequency, &band);
+	S2LP_RF_SetSynthBand(&handle, band);
+	S2LP_RF_SetBaseFrequency(&handle, parameters->base_frequency);
+	S2LP_RF_SetChargePumpCurrent(&handle, parameters->charge_pump_current);
+	S2LP_RF_SetChannelSpacing(&handle, parameters->channel_spacing);
+	S2LP_RF_SetChannelNumber(&handle, parameters->channel_number);
+	S2LP_RF_SetModulationType(&handle, parameters->modulation);
+	S2LP_RF_SetDataRate(&handle, parameters->datarate);
+	S2LP_RF_SetFrequencyDeviation(&handle, parameters->frequency_deviation);
+	S2LP_RX_SetChannelFilterValueRaw(&handle, parameters->channel_filter_mantissa,
+			parameters->channel_filter_exponent);
+	S2LP_PCKT_SetPacketFormat(&handle, parameters->packet_format);
+	S2LP_PCKT_SetPreambleLength(&handle, parameters->preamble_length);
+	S2LP_PCKT_SetSyncLength(&handle, parameters->sync_length);
+	S2LP_PCKT_SetPacketLength(&handle, parameters->packet_length);
+	S2LP_PCKT_SetVariablePacketLengthState(&handle, parameters->variable_packet_length);
+	S2LP_PCKT_SetCRCMode(&handle, parameters->crc_mode);
+	S2LP_PCKT_SetDataCoding(&handle, parameters->data_coding);
+	S2LP_PCKT_SetDataWhiteningState(&handle, parameters->data_whitening);
+	S2LP_TX_SetStaticPowerLevel(&handle, parameters->power_level);
+	S2LP_RX_SetRSSIThreshold(&handle, parameters->rssi_threshold);
+}
+
+typedef struct Measurement_t {
+	uint32_t transactions;
+	uint64_t bytes;
+	uint64_t time_ns;
+} Measurement;
+
+static void StartMeasurement(Measurement* measurement) {
+	S2LP_Emulator_ResetStatistics(&emulator);
+	measurement->time_ns = emulator.time_ns;
+}
+
+static void EndMeasurement(Measurement* measurement, char const* name) {
+	measurement->transactions = emulator.statistics.transactions;
+	measurement->bytes = emulator.statistics.spi_bytes;
+	measurement->time_ns = emulator.time_ns - measurement->time_ns;
+	printf("  %-20s %3u frames, %4llu bytes, %6.1f us\n", name, measurement->transactions,
+			(unsigned long long) measurement->bytes, measurement->time_ns / 1000.0);
+}
+
+// Carrier has to be within synthesizer resolution from base frequency + channel offset
+static void CheckCarrier(S2LP_ProfileParameters const* parameters) {
+	uint32_t const offset = (uint32_t) ((50000000ull * parameters->channel_spacing * parameters->channel_number) >> 15);
+	int64_t const error = (int64_t) S2LP_Emulator_GetCarrierFrequency(&emulator)
+			- (int64_t) (parameters->base_frequency + offset);
+	TEST_CHECK(llabs(error) < 50);
+}
+
+static void Run(S2LP_ProfileParameters const* parameters, bool cache) {
+	uint8_t configured[S2LP_CONFIG_REGISTERS_END];
+	S2LP_Snapshot snapshot;
+	S2LP_Profile profile;
+	Measurement capture;
+	Measurement replay;
+	Measurement apply;
+	Measurement restore;
+
+	printf("%u Hz, register cache %s:\n", parameters->base_frequency, cache ? "enabled" : "disabled");
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 8000000);
+	S2LP_SetRegisterCacheState(&handle, cache);
+	Configure(parameters);
+	memcpy(configured, emulator.registers, sizeof(configured));
+	CheckCarrier(parameters);
+
+	StartMeasurement(&capture);
+	S2LP_Snapshot_Capture(&handle, &snapshot);
+	EndMeasurement(&capture, "capture");
+
+	// Replay everything done after the reset, including S2LP_Initialize
+	S2LP_Reset(&handle);
+	StartMeasurement(&replay);
+	S2LP_SetRefDivState(&handle, S2LP_IsDigitalClockDivided(&handle));
+	Configure(parameters);
+	EndMeasurement(&replay, "replay init sequence");
+	TEST_CHECK(memcmp(configured, emulator.registers, sizeof(configured)) == 0);
+
+	// Profile covers reference divider too
+	TEST_CHECK(S2LP_Profile_Build(&profile, S2LP_CLOCK_FREQ_50MHZ, parameters));
+	S2LP_Reset(&handle);
+	StartMeasurement(&apply);
+	TEST_CHECK(S2LP_Profile_Apply(&handle, &profile));
+	EndMeasurement(&apply, "apply profile");
+	TEST_CHECK(memcmp(configured, emulator.registers, sizeof(configured)) == 0);
+	CheckCarrier(parameters);
+
+	S2LP_Reset(&handle);
+	StartMeasurement(&restore);
+	S2LP_Snapshot_Restore(&handle, &snapshot);
+	EndMeasurement(&restore, "restore snapshot");
+	TEST_CHECK(memcmp(configured, emulator.registers, sizeof(configured)) == 0);
+
+	TEST_CHECK(restore.transactions < replay.transactions);
+	TEST_CHECK(restore.time_ns < replay.time_ns);
+	TEST_CHECK(apply.transactions < replay.transactions);
+	TEST_CHECK(apply.time_ns < replay.time_ns);
+	if (cache) {
+		TEST_CHECK(capture.transactions == 0);
+	}
+}
+
+int main(void) {
+	S2LP_ProfileParameters out_of_band = high_band_parameters;
+	out_of_band.base_frequency = 600000000;
+	S2LP_Profile profile;
+	TEST_CHECK(!S2LP_Profile_Build(&profile, S2LP_CLOCK_FREQ_50MHZ, &out_of_band));
+
+	Run(&high_band_parameters, true);
+	Run(&high_band_parameters, false);
+	Run(&mid_band_parameters, true);
+	Run(&mid_band_parameters, false);
+	return TEST_RESULT();
+}
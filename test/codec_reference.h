@@ -0,0 +1,71 @@
+/*
+ * codec_reference.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_TEST_CODEC_REFERENCE_H_
+#define S2LP_TEST_CODEC_REFERENCE_H_
+
+// Bitwise reference implementations of whitening and FEC encoding, written straight from the
+// definitions (PN9 shift register, and the convolutional encoder with interleaver from TI DN504,
+// which S2LP_Codec_FECEncode follows). Used to check the table-driven codec, and as the baseline
+// of it's throughput.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Longest input of Reference_FECEncode
+#define REFERENCE_FEC_MAX_LENGTH 4096
+
+static inline void Reference_Whiten(uint8_t* data, size_t length) {
+	uint16_t state = 0x1FF;
+	for (size_t i = 0; i < length; i++) {
+		data[i] ^= (uint8_t) state;
+		for (int bit = 0; bit < 8; bit++) {
+			uint16_t const feedback = (state ^ (state >> 5)) & 1;
+			state = (uint16_t) ((state >> 1) | (feedback << 8));
+		}
+	}
+}
+
+static inline size_t Reference_FECEncode(uint8_t const* input, size_t length, uint8_t* output) {
+	static uint8_t const encoder_table[16] = { 0, 3, 1, 2, 3, 0, 2, 1, 3, 0, 2, 1, 0, 3, 1, 2 };
+	static uint8_t data[REFERENCE_FEC_MAX_LENGTH + 2];
+	static uint8_t coded[2 * (REFERENCE_FEC_MAX_LENGTH + 2)];
+
+	// Trellis terminator, so the coded length is a multiple of 4
+	memcpy(data, input, length);
+	size_t const terminated_length = length + ((length & 1) != 0 ? 1 : 2);
+	data[length] = 0x0B;
+	data[length + 1] = 0x0B;
+
+	uint16_t state = 0;
+	for (size_t i = 0; i < terminated_length; i++) {
+		state = (uint16_t) ((state & 0x700) | data[i]);
+		uint16_t symbols = 0;
+		for (int bit = 0; bit < 8; bit++) {
+			symbols = (uint16_t) ((symbols << 2) | encoder_table[state >> 7]);
+			state = (uint16_t) ((state << 1) & 0x7FF);
+		}
+		coded[2 * i] = (uint8_t) (symbols >> 8);
+		coded[2 * i + 1] = (uint8_t) symbols;
+	}
+
+	// 4x4 interleaving of 2-bit symbols in 4-byte blocks
+	for (size_t i = 0; i < 2 * terminated_length; i += 4) {
+		uint32_t block = 0;
+		for (int symbol = 0; symbol < 16; symbol++) {
+			block = (block << 2) | ((coded[i + (~symbol & 3)] >> (2 * ((symbol & 0x0C) >> 2))) & 3);
+		}
+		output[i] = (uint8_t) (block >> 24);
+		output[i + 1] = (uint8_t) (block >> 16);
+		output[i + 2] = (uint8_t) (block >> 8);
+		output[i + 3] = (uint8_t) block;
+	}
+	return 2 * terminated_length;
+}
+
+#endif /* S2LP_TEST_CODEC_REFERENCE_H_ */
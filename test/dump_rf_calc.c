@@ -0,0 +1,179 @@
+/*
+ * dump_rf_calc.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Equivalence test of fixed-point and floating point RF calculations. The program is built twice
+// (with and without S2LP_FIXED_POINT_MATH, see the Makefile) and the outputs are compared.
+// Every function with both implementations is evaluated for every clock frequency (and synthesizer
+// band and reference divider state, where they matter) over:
+// * every mantissa/exponent pair - datarate and frequency deviation
+// * every AGC measure time
+// * every datarate from S2LP_DATARATE_MIN to S2LP_DATARATE_MAX, and deviation from 0 to 1MHz - exponent
+//   and mantissa calculation, and the solvers
+// * synthesizer words and base frequencies over the whole band, with a small stride
+// Results (with doubles compared bit by bit) are hashed, one line per function and configuration.
+
+#include "test_utils.h"
+#include "s2lp_rf_calc.h"
+#include "s2lp_rx.h"
+
+#include <string.h>
+
+// FNV-1a
+static uint64_t hash;
+static unsigned long count;
+
+static void Begin(void) {
+	hash = 0xcbf29ce484222325ull;
+	count = 0;
+}
+
+static void Mix(uint64_t value) {
+	for (size_t i = 0; i < 8; i++) {
+		hash ^= (value >> (8 * i)) & 0xFF;
+		hash *= 0x100000001b3ull;
+	}
+	count++;
+}
+
+static void MixDouble(double value) {
+	uint64_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	Mix(bits);
+}
+
+static void End(char const* name, S2LP_ClockFrequency frequency, int band, int ref_div) {
+	printf("clock %d band %2d ref_div %2d %-28s %016llx (%lu values)\n", (int) frequency, band, ref_div, name,
+			(unsigned long long) hash, count);
+}
+
+static void DumpClock(S2LP_ClockFrequency frequency) {
+	S2LP_RF_Context context;
+	S2LP_RFCalc_InitContext(&context, frequency, S2LP_SYNTH_BAND_HIGH, false);
+
+	// Datarate depends only on the clock
+	Begin();
+	for (uint32_t exponent = 0; exponent <= 15; exponent++) {
+		for (uint32_t mantissa = S2LP_DATARATE_MANTISSA_MIN; mantissa <= S2LP_DATARATE_MANTISSA_MAX; mantissa++) {
+			Mix(S2LP_RFCalc_DataRateValue(&context, (uint16_t) mantissa, (uint8_t) exponent));
+		}
+	}
+	End("DataRateValue", frequency, -1, -1);
+	TEST_CHECK(count == 16ul * (S2LP_DATARATE_MANTISSA_MAX + 1));
+	// Zero mantissa with the max exponent (division by zero) is 0 bps, in both implementations
+	TEST_CHECK(S2LP_RFCalc_DataRateValue(&context, 0, S2LP_DATARATE_EXPONENT_MAX) == 0);
+	TEST_CHECK(S2LP_RFCalc_DataRateMantissa(&context, 0, S2LP_DATARATE_EXPONENT_MAX) == 0);
+
+	Begin();
+	for (uint32_t datarate = S2LP_DATARATE_MIN; datarate <= S2LP_DATARATE_MAX; datarate++) {
+		uint8_t const exponent = S2LP_RFCalc_DataRateExponent(&context, datarate);
+		Mix(exponent);
+		if (exponent != S2LP_DATARATE_EXPONENT_INVALID) {
+			Mix(S2LP_RFCalc_DataRateMantissa(&context, datarate, exponent));
+		}
+	}
+	End("DataRateExponent+Mantissa", frequency, -1, -1);
+
+	Begin();
+	for (uint32_t datarate = S2LP_DATARATE_MIN; datarate <= S2LP_DATARATE_MAX; datarate++) {
+		S2LP_RFCalc_Solution solution = { 0 };
+		Mix(S2LP_RFCalc_SolveDataRate(&context, datarate, &solution));
+		Mix(solution.mantissa);
+		Mix(solution.exponent);
+		Mix(solution.value);
+		MixDouble(solution.error_ppm);
+	}
+	End("SolveDataRate", frequency, -1, -1);
+
+	// AGC timing depends only on the clock too
+	static S2LP_Emulator emulator;
+	static S2LP_Handle handle;
+	Test_InitEmulatedHandle(&handle, &emulator, frequency, 10000000);
+	Begin();
+	for (uint8_t time = 0; time <= 15; time++) {
+		MixDouble(S2LP_RX_CalculateAGCMeasureTime(&handle, time));
+	}
+	End("AGCMeasureTime", frequency, -1, -1);
+
+	for (int band = S2LP_SYNTH_BAND_HIGH; band <= S2LP_SYNTH_BAND_MID; band++) {
+		for (int ref_div = 0; ref_div <= 1; ref_div++) {
+			S2LP_RFCalc_InitContext(&context, frequency, (S2LP_SynthesizerBand) band, ref_div);
+
+			Begin();
+			for (uint32_t exponent = 0; exponent <= 15; exponent++) {
+				for (uint32_t mantissa = 0; mantissa <= 255; mantissa++) {
+					MixDouble(S2LP_RFCalc_FrequencyDeviation(&context, (uint8_t) mantissa, (uint8_t) exponent));
+				}
+			}
+			End("FrequencyDeviation", frequency, band, ref_div);
+
+			Begin();
+			for (uint32_t deviation = 0; deviation <= 1000000; deviation++) {
+				uint8_t const exponent = S2LP_RFCalc_FreqDevExponent(&context, deviation);
+				Mix(exponent);
+				if (exponent != S2LP_FDEV_EXPONENT_INVALID) {
+					Mix(S2LP_RFCalc_FreqDevMantissa(&context, exponent, deviation));
+				}
+			}
+			End("FreqDevExponent+Mantissa", frequency, band, ref_div);
+
+			Begin();
+			for (uint32_t deviation = 0; deviation <= 1000000; deviation += 7) {
+				S2LP_RFCalc_Solution solution = { 0 };
+				Mix(S2LP_RFCalc_SolveFrequencyDeviation(&context, deviation, &solution));
+				Mix(solution.mantissa);
+				Mix(solution.exponent);
+				Mix(solution.value);
+				MixDouble(solution.error_ppm);
+			}
+			End("SolveFrequencyDeviation", frequency, band, ref_div);
+
+			// Synthesizer bands are 826-1055MHz (high) and 413-527MHz (middle)
+			uint32_t const band_start = band == S2LP_SYNTH_BAND_HIGH ? 826000000u : 413000000u;
+			uint32_t const band_end = band == S2LP_SYNTH_BAND_HIGH ? 1055000000u : 527000000u;
+			Begin();
+			for (uint32_t base_frequency = band_start; base_frequency <= band_end; base_frequency += 37) {
+				Mix(S2LP_RFCalc_SyncForBaseFrequency(&context, base_frequency));
+			}
+			End("SyncForBaseFrequency", frequency, band, ref_div);
+
+			Begin();
+			for (uint32_t synth_value = 0; synth_value < (1u << 28); synth_value += 61) {
+				MixDouble(S2LP_RFCalc_BaseFrequency(&context, synth_value));
+			}
+			End("BaseFrequency", frequency, band, ref_div);
+
+			// Integer versions give the same results, over both bands
+			for (uint32_t synth_value = 0; synth_value < (1u << 28); synth_value += 997) {
+				double const base_frequency = S2LP_RFCalc_BaseFrequency(&context, synth_value);
+				if (base_frequency <= UINT32_MAX) {
+					TEST_CHECK(S2LP_RFCalc_BaseFrequencyValue(&context, synth_value) == base_frequency);
+				}
+			}
+			for (uint32_t channel_spacing = 0; channel_spacing <= 0xFF; channel_spacing += 3) {
+				for (uint32_t channel_number = 0; channel_number <= 0xFF; channel_number += 5) {
+					TEST_CHECK(S2LP_RFCalc_CenterFrequencyValue(&context, band_start, (uint8_t) channel_spacing,
+							(uint8_t) channel_number) == S2LP_RFCalc_CenterFrequency(&context, band_start,
+							(uint8_t) channel_spacing, (uint8_t) channel_number));
+				}
+			}
+		}
+	}
+}
+
+int main(void) {
+#ifdef S2LP_FIXED_POINT_MATH
+	fprintf(stderr, "fixed-point RF calculations\n");
+#else
+	fprintf(stderr, "floating point RF calculations\n");
+#endif
+
+	for (int frequency = S2LP_CLOCK_FREQ_24MHZ; frequency <= S2LP_CLOCK_FREQ_52MHZ; frequency++) {
+		DumpClock((S2LP_ClockFrequency) frequency);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,120 @@
+/*
+ * test_channel_filter.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Channel filter coefficients search (S2LP_RX_CalculateChannelFilterCoeffs) against a linear scan
+// of the whole table, for every clock: at both sides of every entry's bandwidth, for 0Hz, for the
+// widest bandwidth and 1Hz over it (which has no filter), and for a sweep of the whole range.
+// The scan picks the narrowest entry covering the bandwidth, and the higher mantissa of equal ones
+// (E = 9, M = 5 and 6 are both 1.3kHz in the table).
+
+#include "test_utils.h"
+#include "s2lp_rx.h"
+
+#include <math.h>
+
+#define TEST_FILTER_M 9
+#define TEST_FILTER_E 10
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+
+// Table words (100Hz units at 26MHz), recovered from the bandwidth at current clock
+static uint32_t words[TEST_FILTER_M][TEST_FILTER_E];
+static uint64_t fdig;
+
+static void LoadWords(void) {
+	fdig = S2LP_GetDigitalClockFrequency(&handle);
+	for (uint8_t mantissa = 0; mantissa < TEST_FILTER_M; mantissa++) {
+		for (uint8_t exponent = 0; exponent < TEST_FILTER_E; exponent++) {
+			double const bandwidth = S2LP_RX_CalculateChannelFilterBandwidth(&handle, mantissa, exponent);
+			words[mantissa][exponent] = (uint32_t) lround(bandwidth * 10.0 * 26000000.0 / (double) fdig);
+		}
+	}
+}
+
+// Widest bandwidth (in Hz) the entry covers
+static uint32_t Coverage(uint8_t mantissa, uint8_t exponent) {
+	return (uint32_t) (words[mantissa][exponent] * fdig / 260000ull);
+}
+
+static bool Reference(uint32_t bandwidth, uint8_t* mantissa, uint8_t* exponent) {
+	bool found = false;
+	for (uint8_t m = 0; m < TEST_FILTER_M; m++) {
+		for (uint8_t e = 0; e < TEST_FILTER_E; e++) {
+			if (words[m][e] * fdig < (uint64_t) bandwidth * 260000ull) {
+				continue;
+			}
+			uint32_t const best = found ? words[*mantissa][*exponent] : UINT32_MAX;
+			if (words[m][e] < best || (words[m][e] == best && m > *mantissa)) {
+				*mantissa = m;
+				*exponent = e;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+static void Check(uint32_t bandwidth) {
+	uint8_t mantissa = 0xFF;
+	uint8_t exponent = 0xFF;
+	uint8_t reference_mantissa = 0xFF;
+	uint8_t reference_exponent = 0xFF;
+	bool const found = S2LP_RX_CalculateChannelFilterCoeffs(&handle, bandwidth, &mantissa, &exponent);
+	bool const reference_found = Reference(bandwidth, &reference_mantissa, &reference_exponent);
+
+	TEST_CHECK(found == reference_found);
+	if (found && reference_found && (mantissa != reference_mantissa || exponent != reference_exponent)) {
+		printf("%u Hz at %u Hz clock: M = %u, E = %u, reference M = %u, E = %u\n", bandwidth, (unsigned) fdig,
+				mantissa, exponent, reference_mantissa, reference_exponent);
+		TEST_CHECK(mantissa == reference_mantissa && exponent == reference_exponent);
+	}
+}
+
+static void TestClock(S2LP_ClockFrequency frequency) {
+	Test_InitEmulatedHandle(&handle, &emulator, frequency, 8000000);
+	LoadWords();
+
+	for (uint8_t mantissa = 0; mantissa < TEST_FILTER_M; mantissa++) {
+		for (uint8_t exponent = 0; exponent < TEST_FILTER_E; exponent++) {
+			uint32_t const coverage = Coverage(mantissa, exponent);
+			Check(coverage - 1);
+			Check(coverage);
+			Check(coverage + 1);
+		}
+	}
+
+	uint32_t const widest = Coverage(0, 0);
+	for (uint32_t bandwidth = 0; bandwidth <= widest + 1000; bandwidth += 97) {
+		Check(bandwidth);
+	}
+
+	// Narrowest entry for 0Hz, and nothing over the widest one
+	uint8_t mantissa = 0;
+	uint8_t exponent = 0;
+	TEST_CHECK(S2LP_RX_CalculateChannelFilterCoeffs(&handle, 0, &mantissa, &exponent));
+	TEST_CHECK(mantissa == 8 && exponent == 9);
+	TEST_CHECK(S2LP_RX_CalculateChannelFilterCoeffs(&handle, widest, &mantissa, &exponent));
+	TEST_CHECK(mantissa == 0 && exponent == 0);
+	TEST_CHECK(!S2LP_RX_CalculateChannelFilterCoeffs(&handle, widest + 1, &mantissa, &exponent));
+
+	// Equal entries - the higher mantissa is the narrower filter
+	TEST_CHECK(words[5][9] == words[6][9]);
+	TEST_CHECK(S2LP_RX_CalculateChannelFilterCoeffs(&handle, Coverage(6, 9), &mantissa, &exponent));
+	TEST_CHECK(mantissa == 6 && exponent == 9);
+}
+
+int main(void) {
+	static S2LP_ClockFrequency const clocks[] = { S2LP_CLOCK_FREQ_24MHZ, S2LP_CLOCK_FREQ_25MHZ,
+			S2LP_CLOCK_FREQ_26MHZ, S2LP_CLOCK_FREQ_48MHZ, S2LP_CLOCK_FREQ_50MHZ, S2LP_CLOCK_FREQ_52MHZ };
+
+	for (size_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++) {
+		TestClock(clocks[i]);
+	}
+
+	return TEST_RESULT();
+}
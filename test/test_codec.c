@@ -0,0 +1,152 @@
+/*
+ * test_codec.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Software data coding and whitening (s2lp_codec.h):
+// * whitening and FEC encoding against the bitwise references (codec_reference.h), whitening in parts
+// * encode/decode round trips of every coding, for random data of random length
+// * Manchester and 3-out-of-6 decoders detecting single bit errors
+// * FEC correcting bit errors in 64-byte frames - random ones, and one in every 4 coded bytes
+
+#include "test_utils.h"
+#include "codec_reference.h"
+#include "s2lp_codec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_CODEC_RANDOM_FRAMES 3000
+#define TEST_CODEC_MAX_LENGTH 600
+#define TEST_CODEC_FEC_FRAMES 1000
+#define TEST_CODEC_FEC_FRAME_LENGTH 64
+
+static uint8_t data[TEST_CODEC_MAX_LENGTH];
+static uint8_t coded[S2LP_CODEC_FEC_ENCODED_LENGTH(TEST_CODEC_MAX_LENGTH)];
+static uint8_t reference[S2LP_CODEC_FEC_ENCODED_LENGTH(TEST_CODEC_MAX_LENGTH)];
+static uint8_t decoded[TEST_CODEC_MAX_LENGTH + 2];
+
+static void FillRandom(uint8_t* buffer, size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		buffer[i] = (uint8_t) rand();
+	}
+}
+
+static void FlipRandomBit(uint8_t* buffer, size_t length) {
+	buffer[(size_t) rand() % length] ^= (uint8_t) (1u << (rand() % 8));
+}
+
+static void TestWhitening(size_t length) {
+	memcpy(coded, data, length);
+	S2LP_Codec_Whiten(coded, length, 0);
+	memcpy(reference, data, length);
+	Reference_Whiten(reference, length);
+	TEST_CHECK(memcmp(coded, reference, length) == 0);
+
+	size_t const split = length > 0 ? (size_t) rand() % length : 0;
+	memcpy(reference, data, length);
+	S2LP_Codec_Whiten(reference, split, 0);
+	S2LP_Codec_Whiten(reference + split, length - split, split);
+	TEST_CHECK(memcmp(coded, reference, length) == 0);
+
+	// Symmetric
+	S2LP_Codec_Whiten(coded, length, 0);
+	TEST_CHECK(memcmp(coded, data, length) == 0);
+}
+
+static void TestFEC(size_t length) {
+	size_t const coded_length = S2LP_Codec_FECEncode(data, length, coded);
+	TEST_CHECK(coded_length == S2LP_CODEC_FEC_ENCODED_LENGTH(length));
+	TEST_CHECK(coded_length == Reference_FECEncode(data, length, reference));
+	TEST_CHECK(memcmp(coded, reference, coded_length) == 0);
+
+	// Terminator is decoded too
+	TEST_CHECK(S2LP_Codec_FECDecode(coded, coded_length, decoded) == coded_length / 2);
+	TEST_CHECK(memcmp(decoded, data, length) == 0);
+	TEST_CHECK(decoded[length] == S2LP_CODEC_FEC_TERMINATOR);
+}
+
+static void TestManchester(size_t length) {
+	size_t const coded_length = S2LP_Codec_ManchesterEncode(data, length, coded);
+	TEST_CHECK(coded_length == S2LP_CODEC_MANCHESTER_ENCODED_LENGTH(length));
+	TEST_CHECK(S2LP_Codec_ManchesterDecode(coded, coded_length, decoded));
+	TEST_CHECK(memcmp(decoded, data, length) == 0);
+
+	if (length > 0) {
+		FlipRandomBit(coded, coded_length);
+		TEST_CHECK(!S2LP_Codec_ManchesterDecode(coded, coded_length, decoded));
+	}
+}
+
+static void Test3of6(size_t length) {
+	size_t const coded_length = S2LP_Codec_3of6Encode(data, length, coded);
+	TEST_CHECK(coded_length == S2LP_CODEC_3OF6_ENCODED_LENGTH(length));
+	TEST_CHECK(S2LP_Codec_3of6Decode(coded, coded_length, decoded));
+	TEST_CHECK(memcmp(decoded, data, length) == 0);
+
+	// Padding bits of odd lengths aren't checked
+	if (length > 0) {
+		FlipRandomBit(coded, 3 * length / 2);
+		TEST_CHECK(!S2LP_Codec_3of6Decode(coded, coded_length, decoded));
+	}
+}
+
+// Returns the amount of frames decoded without errors
+static int CorrectFEC(int errors, bool spaced) {
+	int corrected = 0;
+	for (int frame = 0; frame < TEST_CODEC_FEC_FRAMES; frame++) {
+		FillRandom(data, TEST_CODEC_FEC_FRAME_LENGTH);
+		size_t const coded_length = S2LP_Codec_FECEncode(data, TEST_CODEC_FEC_FRAME_LENGTH, coded);
+		if (spaced) {
+			for (size_t i = 0; i < coded_length; i += 4) {
+				FlipRandomBit(coded + i, 4);
+			}
+		} else {
+			for (int i = 0; i < errors; i++) {
+				FlipRandomBit(coded, coded_length);
+			}
+		}
+
+		S2LP_Codec_FECDecode(coded, coded_length, decoded);
+		if (memcmp(decoded, data, TEST_CODEC_FEC_FRAME_LENGTH) == 0) {
+			corrected++;
+		}
+	}
+	return corrected;
+}
+
+int main(void) {
+	srand(7);
+
+	// PN9 sequence, as in TI DN509
+	static uint8_t const pn9[] = { 0xFF, 0xE1, 0x1D, 0x9A, 0xED, 0x85, 0x33, 0x24 };
+	memset(coded, 0, sizeof(pn9));
+	S2LP_Codec_Whiten(coded, sizeof(pn9), 0);
+	TEST_CHECK(memcmp(coded, pn9, sizeof(pn9)) == 0);
+
+	for (int frame = 0; frame < TEST_CODEC_RANDOM_FRAMES; frame++) {
+		size_t const length = (size_t) rand() % TEST_CODEC_MAX_LENGTH;
+		FillRandom(data, length);
+		TestWhitening(length);
+		TestFEC(length);
+		TestManchester(length);
+		Test3of6(length);
+	}
+
+	for (int errors = 1; errors <= 8; errors *= 2) {
+		int const corrected = CorrectFEC(errors, false);
+		printf("FEC, %d B frame with %d random bit errors: %d/%d corrected\n", TEST_CODEC_FEC_FRAME_LENGTH, errors,
+				corrected, TEST_CODEC_FEC_FRAMES);
+		// Isolated errors have to be always corrected
+		TEST_CHECK(errors > 2 || corrected == TEST_CODEC_FEC_FRAMES);
+		TEST_CHECK(corrected >= TEST_CODEC_FEC_FRAMES * 99 / 100);
+	}
+	int const corrected = CorrectFEC(0, true);
+	printf("FEC, %d B frame with 1 bit error in every 4 coded bytes: %d/%d corrected\n",
+			TEST_CODEC_FEC_FRAME_LENGTH, corrected, TEST_CODEC_FEC_FRAMES);
+	TEST_CHECK(corrected >= TEST_CODEC_FEC_FRAMES * 99 / 100);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,209 @@
+/*
+ * test_fhss.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Two-node frequency hopping link on S2LP_Emulator_Air - transmitting node sends a packet in every
+// dwell slot, listening node receives them, both hopping over 50 channels with the same sequence.
+// Done for a channel plan switched by synthesizer word (100kHz spacing) and by CHNUM (12207Hz).
+// Every packet has to be delivered on the right channel, without missed hops, and the hop statistics
+// (dwell time, hop latency, SPI transactions per hop) have to match the schedule.
+// Nodes with different sequences must not hear each other, and late processing has to skip missed hops.
+
+#include "test_utils.h"
+#include "s2lp_fhss.h"
+#include "s2lp_rf.h"
+
+#include <string.h>
+
+#define TEST_FHSS_DWELL_TIME_US 20000
+#define TEST_FHSS_SLOTS 400
+#define TEST_FHSS_CHANNELS 50
+#define TEST_FHSS_PACKET_LENGTH 20
+#define TEST_FHSS_SEED 0xC0FFEE
+
+enum {
+	TRANSMITTER,
+	RECEIVER,
+	NODE_COUNT
+};
+
+static S2LP_Emulator_Air air;
+static S2LP_Emulator emulators[NODE_COUNT];
+static S2LP_Handle handles[NODE_COUNT];
+static S2LP_ChannelPlan plans[NODE_COUNT];
+static S2LP_FHSS nodes[NODE_COUNT];
+
+static void WriteFIFO(S2LP_Handle* handle, uint8_t const* data, size_t length) {
+	S2LP_Select(handle);
+	S2LP_Write(handle, S2LP_ADDR_FIFO, data, length);
+	S2LP_Deselect(handle);
+}
+
+static void ReadFIFO(S2LP_Handle* handle, uint8_t* data, size_t length) {
+	S2LP_Select(handle);
+	S2LP_Read(handle, S2LP_ADDR_FIFO, data, length);
+	S2LP_Deselect(handle);
+}
+
+static void Setup(uint32_t spacing) {
+	S2LP_Emulator_InitAir(&air);
+	for (size_t i = 0; i < NODE_COUNT; i++) {
+		Test_InitEmulatedHandle(&handles[i], &emulators[i], S2LP_CLOCK_FREQ_50MHZ, 8000000);
+		TEST_CHECK(S2LP_Emulator_AttachToAir(&air, &emulators[i]));
+		S2LP_RF_SetDataRate(&handles[i], 100000);
+		S2LP_WriteRegister(&handles[i], S2LP_REG_PCKTLEN1, 0);
+		S2LP_WriteRegister(&handles[i], S2LP_REG_PCKTLEN0, TEST_FHSS_PACKET_LENGTH);
+		TEST_CHECK(S2LP_ChannelPlan_Build(&handles[i], &plans[i], 863100000, spacing, TEST_FHSS_CHANNELS));
+		S2LP_FHSS_Init(&nodes[i], &handles[i], &plans[i], TEST_FHSS_DWELL_TIME_US);
+		S2LP_FHSS_GenerateSequence(&nodes[i], TEST_FHSS_SEED);
+	}
+}
+
+static void CheckStatistics(char const* name, S2LP_FHSS const* node, uint32_t transactions, uint64_t spi_time_ns,
+		uint32_t expected_transactions) {
+	S2LP_FHSS_Statistics const* statistics = &node->statistics;
+	uint32_t const dwell_average = (uint32_t) (statistics->dwell_total_us / statistics->hops);
+	uint32_t const latency_average = (uint32_t) (statistics->latency_total_us / statistics->hops);
+	printf("  %s: %u hops, %u missed, dwell %u/%u/%u us, latency %u/%u/%u us (min/avg/max), "
+			"%.2f frames and %.2f us SPI per hop\n", name, statistics->hops, statistics->missed_hops,
+			statistics->dwell_min_us, dwell_average, statistics->dwell_max_us, statistics->latency_min_us,
+			latency_average, statistics->latency_max_us, (double) transactions / statistics->hops,
+			spi_time_ns / 1000.0 / statistics->hops);
+
+	TEST_CHECK(statistics->hops >= TEST_FHSS_SLOTS - 1);
+	TEST_CHECK(statistics->missed_hops == 0);
+	// Nodes are processed every 50us
+	TEST_CHECK(statistics->dwell_min_us >= TEST_FHSS_DWELL_TIME_US - 100);
+	TEST_CHECK(statistics->dwell_max_us <= TEST_FHSS_DWELL_TIME_US + 100);
+	TEST_CHECK(dwell_average == TEST_FHSS_DWELL_TIME_US);
+	// Hop latency is just the SPI time
+	TEST_CHECK(statistics->latency_max_us <= spi_time_ns / 1000 / statistics->hops + 1);
+	TEST_CHECK(transactions == expected_transactions * statistics->hops);
+}
+
+static void RunLink(uint32_t spacing) {
+	Setup(spacing);
+	printf("%u Hz spacing (%s):\n", spacing,
+			plans[0].channel_spacing != 0 ? "switched by CHNUM" : "switched by synthesizer word");
+
+	TEST_CHECK(S2LP_FHSS_Start(&nodes[RECEIVER], true));
+	TEST_CHECK(S2LP_FHSS_Start(&nodes[TRANSMITTER], false));
+	uint32_t const start = S2LP_GetTime(&handles[TRANSMITTER]);
+
+	uint32_t sent = 0;
+	uint32_t received = 0;
+	uint32_t corrupted = 0;
+	uint32_t wrong_channel = 0;
+	uint32_t last_slot = UINT32_MAX;
+	uint32_t transactions[NODE_COUNT] = { 0 };
+	uint64_t spi_time_ns[NODE_COUNT] = { 0 };
+
+	while (S2LP_GetTime(&handles[TRANSMITTER]) - start < TEST_FHSS_SLOTS * TEST_FHSS_DWELL_TIME_US) {
+		for (size_t i = 0; i < NODE_COUNT; i++) {
+			uint64_t const time_ns = emulators[i].time_ns;
+			uint32_t const transaction_count = emulators[i].statistics.transactions;
+			if (S2LP_FHSS_Process(&nodes[i])) {
+				spi_time_ns[i] += emulators[i].time_ns - time_ns;
+				transactions[i] += emulators[i].statistics.transactions - transaction_count;
+			}
+		}
+
+		// One packet per slot, away from the hops. Payload is the channel and the slot number.
+		uint32_t const slot = nodes[TRANSMITTER].statistics.hops;
+		uint32_t const time_to_hop = S2LP_FHSS_GetTimeToHop(&nodes[TRANSMITTER]);
+		if (slot != last_slot && TEST_FHSS_DWELL_TIME_US - time_to_hop > 500 && time_to_hop > 5000) {
+			uint8_t packet[TEST_FHSS_PACKET_LENGTH];
+			memset(packet, (uint8_t) slot, sizeof(packet));
+			packet[0] = S2LP_FHSS_GetChannel(&nodes[TRANSMITTER]);
+			WriteFIFO(&handles[TRANSMITTER], packet, sizeof(packet));
+			S2LP_SendCommand(&handles[TRANSMITTER], S2LP_CMD_TX);
+			sent++;
+			last_slot = slot;
+		}
+
+		if (GETBIT(S2LP_GetInterrupts(&handles[RECEIVER]), S2LP_INT_RX_DATA_READY)) {
+			uint8_t packet[TEST_FHSS_PACKET_LENGTH];
+			ReadFIFO(&handles[RECEIVER], packet, sizeof(packet));
+			received++;
+			if (packet[0] != S2LP_FHSS_GetChannel(&nodes[RECEIVER])) {
+				wrong_channel++;
+			}
+			for (size_t i = 2; i < sizeof(packet); i++) {
+				if (packet[i] != packet[1]) {
+					corrupted++;
+				}
+			}
+		}
+
+		S2LP_Emulator_AdvanceTime(&emulators[TRANSMITTER], 50000);
+	}
+
+	printf("  sent %u, received %u (air: %u delivered, %u lost), %u corrupted, %u on wrong channel\n", sent,
+			received, air.packets_delivered, air.packets_lost, corrupted, wrong_channel);
+	TEST_CHECK(sent == TEST_FHSS_SLOTS);
+	TEST_CHECK(received == sent);
+	TEST_CHECK(air.packets_delivered == sent);
+	TEST_CHECK(air.packets_lost == 0);
+	TEST_CHECK(corrupted == 0);
+	TEST_CHECK(wrong_channel == 0);
+	TEST_CHECK(emulators[RECEIVER].statistics.rx_fifo_overflows == 0);
+
+	// Transmitter only writes the channel, receiver also aborts RX and starts it again
+	CheckStatistics("transmitter", &nodes[TRANSMITTER], transactions[TRANSMITTER], spi_time_ns[TRANSMITTER], 1);
+	CheckStatistics("receiver", &nodes[RECEIVER], transactions[RECEIVER], spi_time_ns[RECEIVER], 3);
+}
+
+static void RunDifferentSequences(void) {
+	Setup(100000);
+	S2LP_FHSS_GenerateSequence(&nodes[RECEIVER], TEST_FHSS_SEED + 1);
+	TEST_CHECK(S2LP_FHSS_Start(&nodes[RECEIVER], true));
+	TEST_CHECK(S2LP_FHSS_Start(&nodes[TRANSMITTER], false));
+
+	uint32_t same_channel = 0;
+	for (uint32_t i = 0; i < 50; i++) {
+		S2LP_Emulator_AdvanceTime(&emulators[TRANSMITTER], TEST_FHSS_DWELL_TIME_US * 1000ull);
+		S2LP_FHSS_Process(&nodes[TRANSMITTER]);
+		S2LP_FHSS_Process(&nodes[RECEIVER]);
+		if (S2LP_FHSS_GetChannel(&nodes[TRANSMITTER]) == S2LP_FHSS_GetChannel(&nodes[RECEIVER])) {
+			same_channel++;
+		}
+
+		uint8_t packet[TEST_FHSS_PACKET_LENGTH] = { 0 };
+		WriteFIFO(&handles[TRANSMITTER], packet, sizeof(packet));
+		S2LP_SendCommand(&handles[TRANSMITTER], S2LP_CMD_TX);
+	}
+
+	printf("different sequences: %u delivered, %u lost, %u slots on the same channel\n", air.packets_delivered,
+			air.packets_lost, same_channel);
+	TEST_CHECK(air.packets_delivered == same_channel);
+}
+
+static void RunLateProcessing(void) {
+	Setup(100000);
+	TEST_CHECK(S2LP_FHSS_Start(&nodes[TRANSMITTER], false));
+
+	// 3.5 dwell times later - 2 hops are skipped, and the node lands on the 4th channel of the sequence
+	S2LP_Emulator_AdvanceTime(&emulators[TRANSMITTER], TEST_FHSS_DWELL_TIME_US * 3500ull);
+	TEST_CHECK(S2LP_FHSS_Process(&nodes[TRANSMITTER]));
+	printf("late processing: %u hops, %u missed\n", nodes[TRANSMITTER].statistics.hops,
+			nodes[TRANSMITTER].statistics.missed_hops);
+	TEST_CHECK(nodes[TRANSMITTER].statistics.hops == 1);
+	TEST_CHECK(nodes[TRANSMITTER].statistics.missed_hops == 2);
+	TEST_CHECK(S2LP_FHSS_GetChannel(&nodes[TRANSMITTER]) == nodes[TRANSMITTER].sequence[3]);
+	TEST_CHECK(S2LP_Emulator_GetCarrierFrequency(&emulators[TRANSMITTER])
+			== S2LP_ChannelPlan_GetFrequency(&plans[TRANSMITTER], nodes[TRANSMITTER].sequence[3]));
+	// Next hop is scheduled at the 4th slot boundary, not dwell time after the late one
+	uint32_t const time_to_hop = S2LP_FHSS_GetTimeToHop(&nodes[TRANSMITTER]);
+	TEST_CHECK(time_to_hop <= TEST_FHSS_DWELL_TIME_US / 2 && time_to_hop > TEST_FHSS_DWELL_TIME_US / 2 - 100);
+}
+
+int main(void) {
+	RunLink(100000);
+	RunLink(12207);
+	RunDifferentSequences();
+	RunLateProcessing();
+	return TEST_RESULT();
+}
@@ -0,0 +1,206 @@
+/*
+ * test_modem.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Modem solver (s2lp_modem.h), for a sweep of modulations, datarates and frequency offsets (50MHz clock):
+// * channel filter is the narrowest one covering Carson bandwidth (outer 4-level symbols at 3 times the
+//   deviation) or the main lobe of OOK, widened by the offset - and solving fails only when none does
+// * deviation 0 gives modulation index 1, OOK has no deviation
+// * AFC is enabled only for frequency modulations with offset, on 2nd IF when offset exceeds deviation
+// * AGC measurement time is up to half of the symbol (FSK) or at least two symbols (OOK), hold time
+//   covers the filter settling, and both fit their register fields
+// * S2LP_Modem_Apply and S2LP_Modem_BuildProfile + S2LP_Profile_Apply give identical register files
+
+#include "test_utils.h"
+#include "s2lp_modem.h"
+#include "s2lp_rf.h"
+#include "s2lp_rx.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+static S2LP_Emulator profile_emulator;
+static S2LP_Handle profile_handle;
+
+static bool IsFourLevel(S2LP_Modulation modulation) {
+	return modulation == S2LP_MODULATION_4FSK || modulation == S2LP_MODULATION_4GFSK;
+}
+
+static double FilterBandwidth(uint8_t mantissa, uint8_t exponent) {
+	return S2LP_RX_CalculateChannelFilterBandwidth(&handle, mantissa, exponent) * 1000.0;
+}
+
+static void CheckFilter(S2LP_ModemSolution const* solution) {
+	double const chosen = FilterBandwidth(solution->filter_mantissa, solution->filter_exponent);
+	TEST_CHECK(chosen >= solution->required_bandwidth);
+	for (uint8_t exponent = 0; exponent <= 9; exponent++) {
+		for (uint8_t mantissa = 0; mantissa <= 8; mantissa++) {
+			double const bandwidth = FilterBandwidth(mantissa, exponent);
+			TEST_CHECK(bandwidth < solution->required_bandwidth || bandwidth >= chosen);
+		}
+	}
+}
+
+static void CheckAGC(S2LP_ModemSolution const* solution, uint32_t symbol_rate) {
+	TEST_CHECK(solution->agc_measure_time <= 15);
+	TEST_CHECK(solution->agc_hold_time >= 1 && solution->agc_hold_time <= 31);
+
+	double const symbol_time = 1.0 / symbol_rate;
+	double const measure = S2LP_RX_CalculateAGCMeasureTime(&handle, solution->agc_measure_time);
+	if (solution->modulation == S2LP_MODULATION_ASK_OOK) {
+		TEST_CHECK(solution->agc_measure_time == 15 || measure >= 2 * symbol_time);
+		TEST_CHECK(solution->agc_measure_time == 0 || measure / 2 < 2 * symbol_time);
+	} else {
+		TEST_CHECK(solution->agc_measure_time == 0 || measure <= symbol_time / 2);
+		TEST_CHECK(solution->agc_measure_time == 15 || measure * 2 > symbol_time / 2);
+	}
+
+	double const hold = S2LP_RX_CalculateAGCHoldTime(&handle, solution->agc_hold_time);
+	TEST_CHECK(solution->agc_hold_time == 31 || hold >= 2.0 / solution->filter_bandwidth);
+}
+
+static void CheckSolution(S2LP_ModemParameters const* parameters) {
+	S2LP_ModemSolution solution;
+	bool const solved = S2LP_Modem_Solve(&handle, parameters, &solution);
+	bool const frequency_modulation = parameters->modulation != S2LP_MODULATION_ASK_OOK;
+	uint32_t const symbol_rate = solution.datarate / (IsFourLevel(parameters->modulation) ? 2 : 1);
+
+	TEST_CHECK(solution.datarate == S2LP_RF_CalculateDataRateValue(&handle, solution.datarate_mantissa,
+			solution.datarate_exponent));
+	uint64_t required = 2ull * parameters->frequency_offset;
+	if (frequency_modulation) {
+		uint32_t const deviation = (parameters->frequency_deviation != 0 ? parameters->frequency_deviation :
+				symbol_rate / 2);
+		TEST_CHECK(llabs((long long) solution.frequency_deviation - (long long) deviation) <= deviation / 50 + 50);
+		required += 2ull * solution.frequency_deviation * (IsFourLevel(parameters->modulation) ? 3 : 1)
+				+ symbol_rate;
+	} else {
+		TEST_CHECK(solution.frequency_deviation == 0);
+		required += 2ull * solution.datarate;
+	}
+	TEST_CHECK(solution.required_bandwidth == required);
+
+	// Fails only when no filter is wide enough
+	if (!solved) {
+		TEST_CHECK(solution.required_bandwidth > FilterBandwidth(0, 0));
+		return;
+	}
+	CheckFilter(&solution);
+
+	TEST_CHECK(solution.afc_enabled == (frequency_modulation && parameters->frequency_offset > 0));
+	if (solution.afc_enabled) {
+		TEST_CHECK(solution.afc_mode == (parameters->frequency_offset > solution.frequency_deviation ?
+				S2LP_AFC_2ND_IF_CORRECTION : S2LP_AFC_SLICER_CORRECTION));
+	}
+	CheckAGC(&solution, symbol_rate);
+	TEST_CHECK(solution.clock_recovery == (parameters->whitened_data ? S2LP_CLOCK_RECOVERY_DLL :
+			S2LP_CLOCK_RECOVERY_PLL));
+}
+
+static void TestSweep(void) {
+	static S2LP_Modulation const modulations[] = { S2LP_MODULATION_2FSK, S2LP_MODULATION_2GFSK,
+			S2LP_MODULATION_4GFSK, S2LP_MODULATION_ASK_OOK };
+	static uint32_t const datarates[] = { 100, 300, 1200, 4800, 9600, 38400, 100000, 250000, 500000 };
+	static uint32_t const offsets[] = { 0, 2000, 20000, 100000 };
+
+	for (size_t m = 0; m < sizeof(modulations) / sizeof(modulations[0]); m++) {
+		for (size_t d = 0; d < sizeof(datarates) / sizeof(datarates[0]); d++) {
+			for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+				S2LP_ModemParameters parameters = { .modulation = modulations[m], .datarate = datarates[d],
+						.frequency_deviation = 0, .frequency_offset = offsets[o], .whitened_data = (o % 2) == 0 };
+				CheckSolution(&parameters);
+				parameters.frequency_deviation = datarates[d] / 4 + 1000;
+				CheckSolution(&parameters);
+			}
+		}
+	}
+}
+
+static void TestKnownCases(void) {
+	S2LP_ModemSolution solution;
+
+	// 4-level outer symbols at 3 times the deviation: 2 * 3 * 20kHz + 19.2k symbols/s
+	S2LP_ModemParameters parameters = { .modulation = S2LP_MODULATION_4GFSK, .datarate = 38400,
+			.frequency_deviation = 20000, .frequency_offset = 0, .whitened_data = true };
+	TEST_CHECK(S2LP_Modem_Solve(&handle, &parameters, &solution));
+	printf("4GFSK 38400 bps, 20kHz: deviation %u Hz, required %u Hz, filter %u Hz\n",
+			solution.frequency_deviation, solution.required_bandwidth, solution.filter_bandwidth);
+	TEST_CHECK(solution.required_bandwidth == 6 * solution.frequency_deviation + solution.datarate / 2);
+	TEST_CHECK(!solution.afc_enabled);
+
+	// Offset below and over the deviation
+	parameters.modulation = S2LP_MODULATION_2GFSK;
+	parameters.frequency_offset = 10000;
+	TEST_CHECK(S2LP_Modem_Solve(&handle, &parameters, &solution));
+	TEST_CHECK(solution.afc_enabled && solution.afc_mode == S2LP_AFC_SLICER_CORRECTION);
+	parameters.frequency_offset = 30000;
+	TEST_CHECK(S2LP_Modem_Solve(&handle, &parameters, &solution));
+	TEST_CHECK(solution.afc_enabled && solution.afc_mode == S2LP_AFC_2ND_IF_CORRECTION);
+
+	// OOK - main lobe, no AFC even with offset
+	parameters.modulation = S2LP_MODULATION_ASK_OOK;
+	TEST_CHECK(S2LP_Modem_Solve(&handle, &parameters, &solution));
+	TEST_CHECK(solution.required_bandwidth == 2 * solution.datarate + 60000);
+	TEST_CHECK(!solution.afc_enabled);
+	TEST_CHECK(solution.deviation_mantissa == 0 && solution.deviation_exponent == 0);
+
+	// Invalid datarate, and signal wider than the widest filter
+	parameters.datarate = 0;
+	TEST_CHECK(!S2LP_Modem_Solve(&handle, &parameters, &solution));
+	parameters.datarate = 38400;
+	parameters.frequency_offset = 500000;
+	TEST_CHECK(!S2LP_Modem_Solve(&handle, &parameters, &solution));
+}
+
+static void TestApplyAndProfile(S2LP_ModemParameters const* parameters) {
+	S2LP_ModemSolution solution;
+	TEST_CHECK(S2LP_Modem_Solve(&handle, parameters, &solution));
+
+	S2LP_Emulator_ResetStatistics(&emulator);
+	S2LP_Modem_Apply(&handle, &solution);
+	uint32_t const apply_transactions = emulator.statistics.transactions;
+
+	S2LP_Profile profile;
+	S2LP_Modem_BuildProfile(&profile, S2LP_CLOCK_FREQ_50MHZ, &solution);
+	S2LP_Emulator_ResetStatistics(&profile_emulator);
+	TEST_CHECK(S2LP_Profile_Apply(&profile_handle, &profile));
+	uint32_t const profile_transactions = profile_emulator.statistics.transactions;
+
+	printf("modulation %d, %u bps: apply %u frames, profile %u frames\n", parameters->modulation,
+			parameters->datarate, apply_transactions, profile_transactions);
+	TEST_CHECK(memcmp(emulator.registers, profile_emulator.registers, S2LP_CONFIG_REGISTERS_END) == 0);
+
+	// Written values are the solution
+	uint8_t mantissa = 0;
+	uint8_t exponent = 0;
+	S2LP_RX_GetChannelFilterValueRaw(&handle, &mantissa, &exponent);
+	TEST_CHECK(mantissa == solution.filter_mantissa && exponent == solution.filter_exponent);
+	TEST_CHECK(S2LP_RF_GetDataRateMantissa(&handle) == solution.datarate_mantissa);
+	TEST_CHECK(S2LP_RF_GetDataRateExponent(&handle) == solution.datarate_exponent);
+	TEST_CHECK(S2LP_RX_GetAFCState(&handle) == solution.afc_enabled);
+	TEST_CHECK(S2LP_RX_GetAGCMeasureTimeRaw(&handle) == solution.agc_measure_time);
+	TEST_CHECK(S2LP_RX_GetAGCHoldTimeRaw(&handle) == solution.agc_hold_time);
+	TEST_CHECK(S2LP_RX_GetClockRecoveryAlgorithm(&handle) == solution.clock_recovery);
+}
+
+int main(void) {
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, 8000000);
+	Test_InitEmulatedHandle(&profile_handle, &profile_emulator, S2LP_CLOCK_FREQ_50MHZ, 8000000);
+
+	TestSweep();
+	TestKnownCases();
+
+	S2LP_ModemParameters parameters = { .modulation = S2LP_MODULATION_2GFSK, .datarate = 38400,
+			.frequency_deviation = 20000, .frequency_offset = 34720, .whitened_data = true };
+	TestApplyAndProfile(&parameters);
+	parameters = (S2LP_ModemParameters) { .modulation = S2LP_MODULATION_ASK_OOK, .datarate = 4800,
+			.frequency_offset = 10000, .whitened_data = false };
+	TestApplyAndProfile(&parameters);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+/*
+ * test_static_config.cpp
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Compile-time configurations (s2lp_static_config.hpp, C++17) against the runtime setters:
+// * SYNT3..SYNT0 and MOD4..CHFLT bytes of S2LP_StaticConfig are equal to the registers written by
+//   S2LP_RF_SetSynthBand, S2LP_RF_SetBaseFrequency, S2LP_RF_SetModulationType, S2LP_RF_SetDataRate,
+//   S2LP_RF_SetFrequencyDeviation and S2LP_RX_SetChannelFilterBandwidth on the emulator, for every
+//   clock and both synthesizer bands
+// * S2LP_StaticConfig::Apply gives the same register file
+// * checks rejecting invalid configurations hold for the bad inputs (static_assert, so the test
+//   doesn't compile when they don't)
+
+extern "C" {
+#include "test_utils.h"
+#include "s2lp_rf.h"
+#include "s2lp_rx.h"
+}
+#include "s2lp_static_config.hpp"
+
+#include <string.h>
+
+// Invalid clock
+static_assert(S2LP_Static_ClockFrequency(S2LP_CLOCK_FREQ_INVALID) == 0);
+static_assert(S2LP_Static_ClockFrequency(S2LP_CLOCK_FREQ_26MHZ) == 26000000);
+
+// Frequencies out of both bands, and band edges
+static_assert(!S2LP_Static_IsHighBand(600000000) && !S2LP_Static_IsMidBand(600000000));
+static_assert(!S2LP_Static_IsMidBand(S2LP_SYNTH_MID_BAND_MIN - 1) && S2LP_Static_IsMidBand(S2LP_SYNTH_MID_BAND_MIN));
+static_assert(S2LP_Static_IsMidBand(S2LP_SYNTH_MID_BAND_MAX) && !S2LP_Static_IsMidBand(S2LP_SYNTH_MID_BAND_MAX + 1));
+static_assert(!S2LP_Static_IsHighBand(S2LP_SYNTH_HIGH_BAND_MIN - 1) && S2LP_Static_IsHighBand(S2LP_SYNTH_HIGH_BAND_MIN));
+static_assert(S2LP_Static_IsHighBand(S2LP_SYNTH_HIGH_BAND_MAX) && !S2LP_Static_IsHighBand(S2LP_SYNTH_HIGH_BAND_MAX + 1));
+
+// Channel filter wider than the widest one (8001 * 25MHz / 260000 = 769326Hz at 50MHz clock)
+static_assert(S2LP_Static_ChannelFilterCoeffs(S2LP_CLOCK_FREQ_50MHZ, 769326).exponent == 0);
+static_assert(S2LP_Static_ChannelFilterCoeffs(S2LP_CLOCK_FREQ_50MHZ, 769327).exponent == 0xFF);
+// Equal entries - the narrower filter (higher mantissa) of them
+static_assert(S2LP_Static_ChannelFilterCoeffs(S2LP_CLOCK_FREQ_26MHZ, 1300).mantissa == 6);
+
+// Deviation below the finest step (about 12Hz at 50MHz clock in high band) can't be achieved
+static_assert(S2LP_Static_FreqDevCoeffs(S2LP_CLOCK_FREQ_50MHZ, 868000000, 3).error > S2LP_STATIC_MAX_ERROR_PPM);
+static_assert(S2LP_Static_FreqDevCoeffs(S2LP_CLOCK_FREQ_50MHZ, 868000000, 20000).error <= S2LP_STATIC_MAX_ERROR_PPM);
+
+// Datarate error, in 1/2^33 bps units (the same limit as in S2LP_StaticConfig)
+constexpr bool IsDataRateAchievable(S2LP_ClockFrequency clock, uint32_t datarate) {
+	return S2LP_Static_DataRateCoeffs(clock, datarate).error / datarate
+			<= (S2LP_STATIC_MAX_ERROR_PPM * (1ull << 33)) / 1000000ull;
+}
+static_assert(IsDataRateAchievable(S2LP_CLOCK_FREQ_24MHZ, S2LP_DATARATE_MIN));
+static_assert(IsDataRateAchievable(S2LP_CLOCK_FREQ_52MHZ, S2LP_DATARATE_MAX));
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+static S2LP_Emulator static_emulator;
+static S2LP_Handle static_handle;
+
+template<S2LP_ClockFrequency Clock, S2LP_Modulation Modulation, uint32_t BaseFrequency, uint32_t DataRate,
+		uint32_t FrequencyDeviation, uint32_t FilterBandwidth>
+static void Check() {
+	using Config = S2LP_StaticConfig<Clock, Modulation, BaseFrequency, DataRate, FrequencyDeviation, FilterBandwidth>;
+
+	Test_InitEmulatedHandle(&handle, &emulator, Clock, 8000000);
+	S2LP_RF_SetSynthBand(&handle, S2LP_Static_IsMidBand(BaseFrequency) ? S2LP_SYNTH_BAND_MID : S2LP_SYNTH_BAND_HIGH);
+	S2LP_RF_SetBaseFrequency(&handle, BaseFrequency);
+	S2LP_RF_SetModulationType(&handle, Modulation);
+	S2LP_RF_SetDataRate(&handle, DataRate);
+	S2LP_RF_SetFrequencyDeviation(&handle, FrequencyDeviation);
+	TEST_CHECK(S2LP_RX_SetChannelFilterBandwidth(&handle, FilterBandwidth));
+
+	printf("%u Hz, %u bps, %u Hz, %u Hz: SYNT %02X %02X %02X %02X, MOD %02X %02X %02X %02X %02X, CHFLT %02X\n",
+			BaseFrequency, DataRate, FrequencyDeviation, FilterBandwidth, Config::synt[0], Config::synt[1],
+			Config::synt[2], Config::synt[3], Config::modem[0], Config::modem[1], Config::modem[2], Config::modem[3],
+			Config::modem[4], Config::modem[5]);
+	TEST_CHECK(memcmp(&emulator.registers[S2LP_REG_SYNT3], Config::synt, sizeof(Config::synt)) == 0);
+	TEST_CHECK(memcmp(&emulator.registers[S2LP_REG_MOD4], Config::modem, sizeof(Config::modem)) == 0);
+
+	Test_InitEmulatedHandle(&static_handle, &static_emulator, Clock, 8000000);
+	Config::Apply(&static_handle);
+	TEST_CHECK(memcmp(emulator.registers, static_emulator.registers, sizeof(emulator.registers)) == 0);
+}
+
+int main(void) {
+	Check<S2LP_CLOCK_FREQ_24MHZ, S2LP_MODULATION_2FSK, 915000000, 100000, 50000, 300000>();
+	Check<S2LP_CLOCK_FREQ_25MHZ, S2LP_MODULATION_2GFSK, 433920000, 4800, 2400, 12000>();
+	Check<S2LP_CLOCK_FREQ_26MHZ, S2LP_MODULATION_2FSK, 433920000, 9600, 4800, 20000>();
+	Check<S2LP_CLOCK_FREQ_48MHZ, S2LP_MODULATION_4GFSK, 868300000, 250000, 62500, 600000>();
+	Check<S2LP_CLOCK_FREQ_50MHZ, S2LP_MODULATION_2GFSK, 868000000, 38400, 20000, 100000>();
+	Check<S2LP_CLOCK_FREQ_52MHZ, S2LP_MODULATION_ASK_OOK, 433050000, 1200, 0, 10000>();
+	Check<S2LP_CLOCK_FREQ_50MHZ, S2LP_MODULATION_2FSK, S2LP_SYNTH_MID_BAND_MIN, S2LP_DATARATE_MIN, 1000, 1100>();
+	Check<S2LP_CLOCK_FREQ_50MHZ, S2LP_MODULATION_2FSK, S2LP_SYNTH_HIGH_BAND_MAX, S2LP_DATARATE_MAX, 250000, 750000>();
+
+	return TEST_RESULT();
+}
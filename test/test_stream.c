@@ -0,0 +1,255 @@
+/*
+ * test_stream.c
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+// Streaming TX and RX of packets longer than the FIFO at 500kbps (50MHz clock). GPIO0 is the nIRQ line
+// with the stream interrupts unmasked, flags are read only when it's asserted, after the interrupt latency.
+// Checks that:
+// * with 8MHz SPI the refill keeps up - packets up to 65535 bytes are sent intact, without underflow
+// * with too slow SPI or too long interrupt latency, the underflow is detected and the packet aborted
+// * with 8MHz SPI the drain keeps up - packets up to 65535 bytes are received intact, without overflow
+// * packet longer than the buffer ends with error, and the bytes that didn't fit are counted
+// * below the lowest SPI clock that keeps up (found for a few thresholds), the overflow is detected
+//   and reported
+
+#include "test_utils.h"
+#include "s2lp_gpio.h"
+#include "s2lp_rf.h"
+#include "s2lp_stream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_STREAM_DATARATE 500000
+#define TEST_STREAM_MAX_LENGTH 65535
+
+static S2LP_Emulator emulator;
+static S2LP_Handle handle;
+static uint8_t packet[TEST_STREAM_MAX_LENGTH];
+static uint8_t buffer[TEST_STREAM_MAX_LENGTH];
+static uint8_t transmitted[TEST_STREAM_MAX_LENGTH];
+
+typedef struct Transmission_t {
+	S2LP_StreamTX stream;
+	S2LP_StreamState state;
+	uint64_t time_ns;
+	uint64_t bus_time_ns;
+} Transmission;
+
+typedef struct Reception_t {
+	S2LP_StreamRX stream;
+	S2LP_StreamState state;
+	uint64_t time_ns;
+	uint64_t bus_time_ns;
+} Reception;
+
+static void Setup(uint32_t spi_clock_hz, uint32_t interrupts) {
+	Test_InitEmulatedHandle(&handle, &emulator, S2LP_CLOCK_FREQ_50MHZ, spi_clock_hz);
+	S2LP_RF_SetDataRate(&handle, TEST_STREAM_DATARATE);
+	S2LP_GPIO_SetPinOutput(&handle, S2LP_PIN_GPIO_0, S2LP_GPIO_OUT_NIRQ);
+	S2LP_SetInterruptMasks(&handle, interrupts);
+	S2LP_Emulator_SetTxSink(&emulator, transmitted, sizeof(transmitted));
+	S2LP_Emulator_ResetStatistics(&emulator);
+}
+
+static void Transmit(Transmission* transmission, uint32_t spi_clock_hz, uint8_t threshold, uint32_t latency_ns,
+		size_t length) {
+	Setup(spi_clock_hz, S2LP_STREAM_TX_INTERRUPTS);
+
+	uint64_t const start_ns = emulator.time_ns;
+	TEST_CHECK(S2LP_Stream_StartTX(&transmission->stream, &handle, packet, length, threshold));
+
+	uint64_t const deadline_ns = start_ns + 2 * length * S2LP_Emulator_GetByteTime(&emulator) + 10000000;
+	transmission->state = S2LP_STREAM_RUNNING;
+	while (transmission->state == S2LP_STREAM_RUNNING && emulator.time_ns < deadline_ns) {
+		if (!S2LP_ReadPin(&handle, S2LP_PIN_GPIO_0)) {
+			S2LP_Emulator_AdvanceTime(&emulator, latency_ns);
+			transmission->state = S2LP_Stream_ProcessTX(&transmission->stream, S2LP_GetInterrupts(&handle));
+		}
+	}
+
+	transmission->time_ns = emulator.time_ns - start_ns;
+	transmission->bus_time_ns = emulator.statistics.bus_time_ns;
+}
+
+static void Receive(Reception* reception, uint32_t spi_clock_hz, uint8_t threshold, uint32_t latency_ns,
+		size_t length, size_t capacity) {
+	Setup(spi_clock_hz, S2LP_STREAM_RX_INTERRUPTS);
+
+	uint64_t const start_ns = emulator.time_ns;
+	TEST_CHECK(S2LP_Emulator_InjectPacket(&emulator, packet, length));
+	TEST_CHECK(S2LP_Stream_StartRX(&reception->stream, &handle, buffer, capacity, threshold));
+
+	// Air time of the packet is 16us per byte, anything way over that means the stream got stuck
+	uint64_t const deadline_ns = start_ns + 2 * length * S2LP_Emulator_GetByteTime(&emulator) + 10000000;
+	reception->state = S2LP_STREAM_RUNNING;
+	while (reception->state == S2LP_STREAM_RUNNING && emulator.time_ns < deadline_ns) {
+		// nIRQ is active low
+		if (!S2LP_ReadPin(&handle, S2LP_PIN_GPIO_0)) {
+			S2LP_Emulator_AdvanceTime(&emulator, latency_ns);
+			reception->state = S2LP_Stream_ProcessRX(&reception->stream, S2LP_GetInterrupts(&handle));
+		}
+	}
+
+	reception->time_ns = emulator.time_ns - start_ns;
+	reception->bus_time_ns = emulator.statistics.bus_time_ns;
+}
+
+static void CheckSent(Transmission const* transmission, size_t length) {
+	S2LP_StreamTX_Statistics const* statistics = &transmission->stream.statistics;
+	TEST_CHECK(transmission->state == S2LP_STREAM_DONE);
+	TEST_CHECK(transmission->stream.position == length);
+	TEST_CHECK(statistics->underflows == 0);
+	TEST_CHECK(emulator.statistics.tx_fifo_underflows == 0);
+	TEST_CHECK(emulator.statistics.packets_sent == 1);
+	// Everything after the preload goes in refills
+	TEST_CHECK(statistics->refill_bytes == length - (length < S2LP_FIFO_SIZE ? length : S2LP_FIFO_SIZE));
+	TEST_CHECK(emulator.tx_sink_length == length);
+	TEST_CHECK(memcmp(transmitted, packet, length) == 0);
+}
+
+static void TestRefillKeepsUp(void) {
+	Transmission transmission;
+	Transmit(&transmission, 8000000, 48, 10000, 4096);
+	S2LP_StreamTX_Statistics const* statistics = &transmission.stream.statistics;
+	printf("TX 4096 B at 8MHz SPI, threshold 48, 10us latency: %.2f ms, %u refills, min FIFO level %u, "
+			"SPI busy %.1f%%\n", transmission.time_ns / 1e6, statistics->refills, statistics->min_fifo_level,
+			100.0 * transmission.bus_time_ns / transmission.time_ns);
+	CheckSent(&transmission, 4096);
+	// Margin left - refill comes soon after crossing the threshold
+	TEST_CHECK(statistics->min_fifo_level > 48 - 8);
+	TEST_CHECK(transmission.time_ns < 4096 * S2LP_Emulator_GetByteTime(&emulator) * 11 / 10);
+
+	Transmit(&transmission, 8000000, 48, 10000, TEST_STREAM_MAX_LENGTH);
+	printf("TX 65535 B at 8MHz SPI: %.2f ms, %u refills\n", transmission.time_ns / 1e6,
+			transmission.stream.statistics.refills);
+	CheckSent(&transmission, TEST_STREAM_MAX_LENGTH);
+
+	// Packet fitting in the FIFO goes in the preload only
+	Transmit(&transmission, 8000000, 48, 10000, 100);
+	CheckSent(&transmission, 100);
+	TEST_CHECK(transmission.stream.statistics.refills == 0);
+}
+
+static void CheckUnderflow(Transmission const* transmission, size_t length) {
+	TEST_CHECK(transmission->state == S2LP_STREAM_ERROR);
+	TEST_CHECK(transmission->stream.statistics.underflows == 1);
+	TEST_CHECK(emulator.statistics.tx_fifo_underflows == 1);
+	TEST_CHECK(emulator.statistics.packets_sent == 0);
+	TEST_CHECK(emulator.tx_sink_length < length);
+	// Bytes sent before the underflow are still right
+	TEST_CHECK(memcmp(transmitted, packet, emulator.tx_sink_length) == 0);
+}
+
+static void TestUnderflow(void) {
+	// Refill of ~100 bytes at 100kHz SPI takes 8ms, the FIFO drains in 2ms
+	Transmission transmission;
+	Transmit(&transmission, 100000, 48, 10000, 4096);
+	printf("TX 4096 B at 100kHz SPI: %u underflow(s) reported after %zu bytes sent\n",
+			transmission.stream.statistics.underflows, emulator.tx_sink_length);
+	CheckUnderflow(&transmission, 4096);
+
+	// 48 bytes above the threshold last 768us
+	Transmit(&transmission, 8000000, 48, 1000000, 4096);
+	printf("TX 4096 B with 1ms latency: %u underflow(s) reported after %zu bytes sent\n",
+			transmission.stream.statistics.underflows, emulator.tx_sink_length);
+	CheckUnderflow(&transmission, 4096);
+}
+
+static void CheckIntact(Reception const* reception, size_t length) {
+	TEST_CHECK(reception->state == S2LP_STREAM_DONE);
+	TEST_CHECK(reception->stream.packet_length == length);
+	TEST_CHECK(reception->stream.length == length);
+	TEST_CHECK(reception->stream.statistics.fifo_overflows == 0);
+	TEST_CHECK(emulator.statistics.rx_fifo_overflows == 0);
+	TEST_CHECK(memcmp(buffer, packet, length) == 0);
+}
+
+static void TestDrainKeepsUp(void) {
+	Reception reception;
+	Receive(&reception, 8000000, 64, 10000, 4096, sizeof(buffer));
+	S2LP_StreamRX_Statistics const* statistics = &reception.stream.statistics;
+	printf("4096 B at 8MHz SPI, threshold 64, 10us latency: %.2f ms, %u drains, max FIFO level %u, "
+			"SPI busy %.1f%%\n", reception.time_ns / 1e6, statistics->drains, statistics->max_fifo_level,
+			100.0 * reception.bus_time_ns / reception.time_ns);
+	CheckIntact(&reception, 4096);
+	TEST_CHECK(statistics->drain_bytes == 4096);
+	// Margin left - the FIFO never got close to full
+	TEST_CHECK(statistics->max_fifo_level < S2LP_FIFO_SIZE / 2 + 8);
+	// Reception is limited by the air time, not by the drain
+	TEST_CHECK(reception.time_ns < 4096 * S2LP_Emulator_GetByteTime(&emulator) * 11 / 10);
+
+	Receive(&reception, 8000000, 64, 10000, TEST_STREAM_MAX_LENGTH, sizeof(buffer));
+	printf("65535 B at 8MHz SPI: %.2f ms, %u drains\n", reception.time_ns / 1e6, reception.stream.statistics.drains);
+	CheckIntact(&reception, TEST_STREAM_MAX_LENGTH);
+}
+
+static void TestBufferTooSmall(void) {
+	Reception reception;
+	Receive(&reception, 8000000, 64, 10000, 4096, 1000);
+	printf("4096 B into 1000 B buffer: %u bytes dropped\n", reception.stream.statistics.dropped_bytes);
+	TEST_CHECK(reception.state == S2LP_STREAM_ERROR);
+	TEST_CHECK(reception.stream.packet_length == 4096);
+	TEST_CHECK(reception.stream.length == 1000);
+	TEST_CHECK(reception.stream.statistics.dropped_bytes == 3096);
+	TEST_CHECK(reception.stream.statistics.fifo_overflows == 0);
+	TEST_CHECK(memcmp(buffer, packet, 1000) == 0);
+}
+
+static bool KeepsUp(uint32_t spi_clock_hz, uint8_t threshold) {
+	Reception reception;
+	Receive(&reception, spi_clock_hz, threshold, 2000, 4096, sizeof(buffer));
+	return reception.state == S2LP_STREAM_DONE;
+}
+
+static void TestLowestSPIClock(uint8_t threshold) {
+	// Bisection, down to 1kHz
+	uint32_t low = 100000;
+	uint32_t high = 8000000;
+	TEST_CHECK(!KeepsUp(low, threshold));
+	TEST_CHECK(KeepsUp(high, threshold));
+	while (high - low > 1000) {
+		uint32_t const middle = low + (high - low) / 2;
+		if (KeepsUp(middle, threshold)) {
+			high = middle;
+		} else {
+			low = middle;
+		}
+	}
+
+	// Just below the limit, overflow has to be detected and reported
+	Reception reception;
+	Receive(&reception, low, threshold, 2000, 4096, sizeof(buffer));
+	printf("threshold %3u, 2us latency: lowest SPI clock %.3f MHz, below it %u overflow(s) reported "
+			"after %zu bytes\n", threshold, high / 1e6, reception.stream.statistics.fifo_overflows,
+			reception.stream.length);
+	TEST_CHECK(reception.state == S2LP_STREAM_ERROR);
+	TEST_CHECK(reception.stream.statistics.fifo_overflows == 1);
+	TEST_CHECK(emulator.statistics.rx_fifo_overflows == 1);
+	TEST_CHECK(reception.stream.length < 4096);
+	// Bytes drained before the overflow are still right
+	TEST_CHECK(memcmp(buffer, packet, reception.stream.length) == 0);
+
+	Receive(&reception, high, threshold, 2000, 4096, sizeof(buffer));
+	CheckIntact(&reception, 4096);
+}
+
+int main(void) {
+	srand(20);
+	for (size_t i = 0; i < sizeof(packet); i++) {
+		packet[i] = (uint8_t) rand();
+	}
+
+	TestRefillKeepsUp();
+	TestUnderflow();
+	TestDrainKeepsUp();
+	TestBufferTooSmall();
+	TestLowestSPIClock(32);
+	TestLowestSPIClock(72);
+	TestLowestSPIClock(112);
+
+	return TEST_RESULT();
+}
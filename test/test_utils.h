@@ -0,0 +1,49 @@
+/*
+ * test_utils.h
+ *
+ *  Created on: 17 paź 2026
+ *      Author: steelph0enix
+ */
+
+#ifndef S2LP_TEST_TEST_UTILS_H_
+#define S2LP_TEST_TEST_UTILS_H_
+
+// Helpers shared by host tests and benchmarks (single translation unit programs).
+// Every program counts failed checks and returns non-zero exit code when any of them failed,
+// so benchmarks also verify the results they measure.
+
+#include "s2lp.h"
+#include "s2lp_emulator.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static int test_failures = 0;
+
+#define TEST_CHECK(condition) do { \
+		if (!(condition)) { \
+			test_failures++; \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+		} \
+	} while (0)
+
+#define TEST_RESULT() (test_failures == 0 ? 0 : 1)
+
+// Monotonic wall clock time, in nanoseconds
+static inline uint64_t Test_Now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+// Init the emulator and the handle using it (with blocking transport)
+static inline void Test_InitEmulatedHandle(S2LP_Handle* handle, S2LP_Emulator* emulator,
+		S2LP_ClockFrequency frequency, uint32_t spi_clock_hz) {
+	S2LP_Emulator_Init(emulator, frequency, spi_clock_hz);
+	handle->transport = &S2LP_Emulator_Transport;
+	handle->transport_context = emulator;
+	S2LP_Initialize(handle, frequency);
+}
+
+#endif /* S2LP_TEST_TEST_UTILS_H_ */